@@ -0,0 +1,186 @@
+// Longest-prefix-match throughput of a Fib compiled from a synthetic
+// full-table RIB: build time, memory, and lookups per second one at a time
+// and in batches. Also the memory of the RIB as IetfRouting::Route structs
+// and packed in a RouteStore, and the cost of repointing a next-hop group.
+//
+//   BenchFib [ipv4-prefixes=1000000] [ipv6-prefixes=200000]
+//            [lookups=10000000]
+
+#include "Fib.hpp"
+#include "IetfRouting.hpp"
+#include "RouteStore.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace yang;
+
+// Prefix lengths weighted roughly like a global BGP table.
+static const std::pair<unsigned, unsigned> kIpv4Lengths[] = {
+    {8, 1},   {12, 1},  {14, 2},  {16, 14}, {17, 6},  {18, 10},
+    {19, 25}, {20, 40}, {21, 50}, {22, 120}, {23, 100}, {24, 620},
+    {28, 5},  {32, 6},
+};
+static const std::pair<unsigned, unsigned> kIpv6Lengths[] = {
+    {29, 10}, {32, 150}, {36, 40}, {40, 60}, {44, 90}, {48, 600}, {56, 50},
+};
+
+template <typename Prefix>
+static Prefix randomPrefix(std::mt19937 &rng,
+                           std::discrete_distribution<unsigned> &lengths,
+                           const std::pair<unsigned, unsigned> *table) {
+  Prefix p;
+  for (auto &b : p.address.bytes)
+    b = static_cast<std::uint8_t>(rng());
+  p.length = static_cast<std::uint8_t>(table[lengths(rng)].first);
+  if constexpr (sizeof(p.address.bytes) == 4) {
+    p.address.bytes[0] = static_cast<std::uint8_t>(1 + rng() % 223);
+  } else {
+    // global unicast, under a few thousand /32 allocations and, past
+    // those, a few /40s each, as real /48s cluster
+    p.address.bytes[0] = 0x20;
+    p.address.bytes[1] = static_cast<std::uint8_t>(rng() % 4);
+    p.address.bytes[2] = static_cast<std::uint8_t>(rng() % 16);
+    p.address.bytes[4] = static_cast<std::uint8_t>(rng() % 16);
+  }
+  // clear the host bits, as parse() would
+  unsigned keep = p.length;
+  for (auto &b : p.address.bytes) {
+    if (keep >= 8) {
+      keep -= 8;
+      continue;
+    }
+    b &= static_cast<std::uint8_t>(0xff00 >> keep);
+    keep = 0;
+  }
+  return p;
+}
+
+template <typename Prefix, std::size_t N>
+static void addRoutes(IetfRouting::Rib &rib, std::size_t count,
+                      const std::pair<unsigned, unsigned> (&table)[N],
+                      std::mt19937 &rng) {
+  std::vector<unsigned> weights;
+  for (const auto &[length, weight] : table)
+    weights.push_back(weight);
+  std::discrete_distribution<unsigned> lengths(weights.begin(),
+                                               weights.end());
+  static const YangIdentity kProtocol("ietf-routing", "static");
+  for (std::size_t i = 0; i < count; ++i) {
+    IetfRouting::Route route;
+    route.destination_prefix = randomPrefix<Prefix>(rng, lengths, table);
+    route.route_preference = static_cast<std::uint32_t>(rng() % 4);
+    // one of a few dozen peers
+    const unsigned peer = rng() % 32;
+    auto &hop = route.next_hop.emplace();
+    hop.outgoing_interface = "eth" + std::to_string(peer % 4);
+    hop.address = Ipv4Address{{192, 0, 2, static_cast<std::uint8_t>(peer)}};
+    auto &meta = route.metadata.emplace();
+    meta.source_protocol = kProtocol;
+    meta.active = true;
+    rib.routes.push_back(std::move(route));
+  }
+}
+
+// Addresses to look up: half inside a random route's prefix, half
+// anywhere.
+template <typename Prefix, typename Address>
+static std::vector<Address> makeAddresses(const IetfRouting::Rib &rib,
+                                          std::size_t count,
+                                          std::mt19937 &rng) {
+  std::vector<const Prefix *> prefixes;
+  for (const auto &r : rib.routes)
+    if (const auto *p = std::get_if<Prefix>(&r.destination_prefix))
+      prefixes.push_back(p);
+  std::vector<Address> out(count);
+  for (auto &a : out) {
+    for (auto &b : a.bytes)
+      b = static_cast<std::uint8_t>(rng());
+    if (prefixes.empty() || rng() % 2)
+      continue;
+    const Prefix &p = *prefixes[rng() % prefixes.size()];
+    for (unsigned bit = 0; bit < p.length; ++bit) {
+      const auto mask = static_cast<std::uint8_t>(0x80 >> bit % 8);
+      a.bytes[bit / 8] = static_cast<std::uint8_t>(
+          (a.bytes[bit / 8] & ~mask) | (p.address.bytes[bit / 8] & mask));
+    }
+  }
+  return out;
+}
+
+static double millis(const std::function<void()> &fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  std::chrono::duration<double, std::milli> took =
+      std::chrono::steady_clock::now() - start;
+  return took.count();
+}
+
+template <typename Address>
+static void benchLookups(const char *family, const Fib &fib,
+                         const std::vector<Address> &addresses) {
+  std::vector<std::uint32_t> out(addresses.size());
+  std::uint64_t sum = 0;
+  const double single = millis([&] {
+    for (std::size_t i = 0; i < addresses.size(); ++i)
+      out[i] = fib.lookup(addresses[i]);
+  });
+  for (auto v : out)
+    sum += v != Fib::kNoRoute;
+  const double batch = millis([&] { fib.lookup(addresses, out); });
+  const double n = static_cast<double>(addresses.size()) / 1000.0;
+  std::printf("%s: %zu lookups, %.1f%% hit; single %.1f Mlookup/s, "
+              "batch %.1f Mlookup/s\n",
+              family, addresses.size(), 100.0 * sum / addresses.size(),
+              n / single, n / batch);
+}
+
+int main(int argc, char **argv) {
+  const std::size_t ipv4 = argc > 1 ? std::atol(argv[1]) : 1000000;
+  const std::size_t ipv6 = argc > 2 ? std::atol(argv[2]) : 200000;
+  const std::size_t lookups = argc > 3 ? std::atol(argv[3]) : 10000000;
+
+  std::mt19937 rng(8349);
+  IetfRouting::Rib rib;
+  rib.name = "bench";
+  addRoutes<Ipv4Prefix>(rib, ipv4, kIpv4Lengths, rng);
+  addRoutes<Ipv6Prefix>(rib, ipv6, kIpv6Lengths, rng);
+
+  // heap strings aside: the interface names are short
+  const double structs = rib.routes.size() * sizeof(IetfRouting::Route);
+  RouteStore store;
+  const double pack = millis([&] { store = RouteStore(rib.routes); });
+  std::printf("%zu routes: %.1f MiB as structs, %.1f MiB packed "
+              "(%zu next-hop groups) in %.0f ms\n",
+              rib.routes.size(), structs / (1024.0 * 1024.0),
+              store.memoryUsage() / (1024.0 * 1024.0), store.nextHopGroups(),
+              pack);
+
+  // a peer goes down: its routes move with one group update
+  const auto group = store[0].next_hop;
+  std::size_t users = 0;
+  for (const auto &rec : store.records())
+    users += (rec.present & RouteStore::kNextHop) && rec.next_hop == group;
+  auto backup = store.nextHop(group);
+  backup.outgoing_interface = "eth9";
+  const double repoint =
+      millis([&] { store.updateNextHop(group, std::move(backup)); });
+  std::printf("repointed %zu routes in %.3f ms\n", users, repoint);
+
+  Fib fib;
+  const double build = millis([&] { fib = Fib(store); });
+  std::printf("built %zu IPv4 + %zu IPv6 prefixes in %.0f ms, %.1f MiB\n",
+              fib.ipv4Routes(), fib.ipv6Routes(), build,
+              fib.memoryUsage() / (1024.0 * 1024.0));
+
+  benchLookups("IPv4", fib,
+               makeAddresses<Ipv4Prefix, Ipv4Address>(rib, lookups, rng));
+  benchLookups("IPv6", fib,
+               makeAddresses<Ipv6Prefix, Ipv6Address>(rib, lookups, rng));
+  return 0;
+}
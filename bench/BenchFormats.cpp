@@ -0,0 +1,117 @@
+// Compares XML, JSON and LYB for an IetfInterfaces document: encoded size
+// and the time to print and to parse it.
+//
+//   BenchFormats [interfaces=10000] [iterations=5]
+
+#include "BenchUtil.hpp"
+#include "IetfInterfaces.hpp"
+#include "Yang.hpp"
+#include "YangModel.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace yang;
+using bench::bestOf;
+
+static IetfInterfaces makeModel(int count) {
+  IetfInterfaces model;
+  for (int i = 0; i < count; ++i) {
+    IetfInterfaces::IetfInterface itf;
+    itf.name = "eth" + std::to_string(i);
+    itf.description = "port " + std::to_string(i);
+    itf.type = IanaIfType::ethernetCsmacd;
+    itf.enabled = (i % 2) == 0;
+    itf.ipv4.emplace();
+    itf.ipv4->mtu = 1500;
+    itf.ipv4->address.push_back({"10." + std::to_string(i / 65536 % 256) +
+                                 "." + std::to_string(i / 256 % 256) + "." +
+                                 std::to_string(i % 256) + "/16"});
+    itf.ipv6.emplace();
+    itf.ipv6->address.push_back({"2001:db8::" + std::to_string(i + 1) +
+                                 "/64"});
+    model.addInterface(itf);
+  }
+  return model;
+}
+
+static std::string print(const YangContext &ctx, struct lyd_node *tree,
+                         LYD_FORMAT format) {
+  if (format == LYD_LYB)
+    return YangModel::printLyb(ctx, tree);
+  char *out = nullptr;
+  if (lyd_print_mem(&out, tree, format,
+                    LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK) != LY_SUCCESS)
+    throw YangDataError(ctx);
+  std::string text = out;
+  std::free(out);
+  return text;
+}
+
+static struct lyd_node *parse(const YangContext &ctx, const std::string &data,
+                              LYD_FORMAT format) {
+  if (format == LYD_LYB)
+    return YangModel::parseLyb(ctx, data, LYD_PARSE_ONLY);
+  struct lyd_node *tree = nullptr;
+  if (lyd_parse_data_mem(ctx.raw(), data.c_str(), format, LYD_PARSE_ONLY, 0,
+                         &tree) != LY_SUCCESS)
+    throw YangDataError(ctx);
+  return tree;
+}
+
+int main(int argc, char **argv) {
+  const int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+  const int iterations = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  auto ctx = Yang::getDefaultContext();
+  const IetfInterfaces model = makeModel(count);
+  struct lyd_node *tree = model.serialize(*ctx);
+
+  std::printf("%d interfaces, best of %d runs\n\n", count, iterations);
+  std::printf("%-6s %12s %12s %12s %14s\n", "format", "bytes", "print ms",
+              "parse ms", "parse+model ms");
+
+  const struct {
+    const char *name;
+    LYD_FORMAT format;
+  } formats[] = {{"xml", LYD_XML}, {"json", LYD_JSON}, {"lyb", LYD_LYB}};
+  for (const auto &f : formats) {
+    const std::string data = print(*ctx, tree, f.format);
+    double print_ms =
+        bestOf(iterations, [&] { (void)print(*ctx, tree, f.format); });
+    double parse_ms = bestOf(iterations, [&] {
+      lyd_free_all(parse(*ctx, data, f.format));
+    });
+    double model_ms = bestOf(iterations, [&] {
+      struct lyd_node *parsed = parse(*ctx, data, f.format);
+      (void)IetfInterfaces::deserialize(*ctx, parsed);
+      lyd_free_all(parsed);
+    });
+    std::printf("%-6s %12zu %12.2f %12.2f %14.2f\n", f.name, data.size(),
+                print_ms, parse_ms, model_ms);
+  }
+
+  // The tree-free paths: YangWriter straight from the model and YangReader
+  // straight into it.
+  for (YangFormat format : {YangFormat::Xml, YangFormat::Json}) {
+    std::string data;
+    double print_ms = bestOf(iterations, [&] {
+      data.clear();
+      auto out = YangOutput::toString(data);
+      model.print(*ctx, out, format);
+    });
+    double model_ms = bestOf(iterations, [&] {
+      auto in = YangInput::fromString(data);
+      YangReader reader(*ctx, in, format);
+      (void)IetfInterfaces::read(reader);
+    });
+    std::printf("%-6s %12zu %12.2f %12s %14.2f\n",
+                format == YangFormat::Xml ? "xml*" : "json*", data.size(),
+                print_ms, "-", model_ms);
+  }
+  std::printf("\n* streamed with YangWriter / YangReader, no data tree\n");
+
+  lyd_free_all(tree);
+  return 0;
+}
@@ -0,0 +1,95 @@
+// Export throughput of a full RIB with every route field set: routes per
+// second through serialize() (a libyang data tree, then printed) and
+// streamed by write() without a tree.
+//
+//   BenchRibExport [routes=500000] [iterations=3]
+
+#include "BenchUtil.hpp"
+#include "IetfRouting.hpp"
+#include "Yang.hpp"
+#include "YangModel.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace yang;
+using bench::bestOf;
+
+static IetfRouting makeModel(std::size_t count) {
+  static const YangIdentity kStatic("ietf-routing", "static");
+  IetfRouting model;
+  IetfRouting::Rib rib;
+  rib.name = "ipv4-master";
+  rib.address_family = YangIdentity("ietf-routing", "ipv4");
+  rib.routes.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    IetfRouting::Route r;
+    Ipv4Prefix p;
+    p.address.bytes = {static_cast<std::uint8_t>(1 + i / 65536 % 223),
+                       static_cast<std::uint8_t>(i / 256 % 256),
+                       static_cast<std::uint8_t>(i % 256), 0};
+    p.length = 24;
+    r.destination_prefix = p;
+    r.route_preference = 20;
+    const auto peer = static_cast<std::uint8_t>(i % 32);
+    auto &hop = r.next_hop.emplace();
+    hop.outgoing_interface = "eth" + std::to_string(peer % 4);
+    hop.address = Ipv4Address{{192, 0, 2, peer}};
+    auto &meta = r.metadata.emplace();
+    meta.source_protocol = kStatic;
+    meta.active = true;
+    meta.last_updated = "2026-01-01T00:00:00Z";
+    rib.routes.push_back(std::move(r));
+  }
+  model.mutableRouting().ribs.push_back(std::move(rib));
+  return model;
+}
+
+static void report(const char *what, std::size_t routes, double ms,
+                   std::size_t bytes) {
+  std::printf("%-22s %10.1f ms %12.0f routes/s %12zu bytes\n", what, ms,
+              routes / (ms / 1000.0), bytes);
+}
+
+int main(int argc, char **argv) {
+  const std::size_t count = argc > 1 ? std::atol(argv[1]) : 500000;
+  const int iterations = argc > 2 ? std::atoi(argv[2]) : 3;
+
+  auto ctx = Yang::getContextFor<IetfRouting>();
+  const IetfRouting model = makeModel(count);
+  std::printf("%zu routes, best of %d runs\n\n", count, iterations);
+
+  const double build = bestOf(iterations, [&] {
+    lyd_free_all(model.serialize(*ctx));
+  });
+  report("serialize()", count, build, 0);
+
+  struct lyd_node *tree = model.serialize(*ctx);
+  for (LYD_FORMAT format : {LYD_XML, LYD_JSON}) {
+    std::size_t bytes = 0;
+    const double ms = bestOf(iterations, [&] {
+      char *out = nullptr;
+      if (lyd_print_mem(&out, tree, format, LYD_PRINT_SHRINK) != LY_SUCCESS)
+        throw YangDataError(*ctx);
+      bytes = std::strlen(out);
+      std::free(out);
+    });
+    report(format == LYD_XML ? "serialize() + xml" : "serialize() + json",
+           count, build + ms, bytes);
+  }
+  lyd_free_all(tree);
+
+  for (YangFormat format : {YangFormat::Xml, YangFormat::Json}) {
+    std::string data;
+    const double ms = bestOf(iterations, [&] {
+      data.clear();
+      auto out = YangOutput::toString(data);
+      model.print(*ctx, out, format);
+    });
+    report(format == YangFormat::Xml ? "write() xml" : "write() json", count,
+           ms, data.size());
+  }
+  return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Helpers shared by the programs in bench/.
+
+#include <chrono>
+#include <functional>
+
+namespace yang::bench {
+
+  // best of `iterations` runs, in milliseconds
+  inline double bestOf(int iterations, const std::function<void()> &fn) {
+    double best = 0;
+    for (int i = 0; i < iterations; ++i) {
+      auto start = std::chrono::steady_clock::now();
+      fn();
+      std::chrono::duration<double, std::milli> took =
+          std::chrono::steady_clock::now() - start;
+      if (i == 0 || took.count() < best)
+        best = took.count();
+    }
+    return best;
+  }
+
+} // namespace yang::bench
@@ -0,0 +1,145 @@
+# Generates the embedded YANG module table for yang_lib (YANG_EMBED_MODULES).
+#
+# Run in script mode:
+#   cmake -DYANG_HEADER=<include/Yang.hpp> -DOUTPUT=<file.inc>
+#         [-DSEARCH_PATHS=<dir;dir>] [-DLIST_ONLY=ON] -P EmbedYangModules.cmake
+#
+# The module list is taken from the uncommented entries of kDefaultModules
+# in YANG_HEADER and, unless SEARCH_PATHS is given, the directories from
+# kDefaultSearchPaths. Every import/include is followed transitively.
+# Modules that cannot be found (e.g. ietf-yang-types, which libyang ships
+# internally) are skipped with a message.
+#
+# With LIST_ONLY, OUTPUT receives the resolved .yang files as a CMake list
+# instead, for use as build dependencies.
+
+cmake_minimum_required(VERSION 3.16)
+
+file(STRINGS "${YANG_HEADER}" header_lines)
+
+set(queue)
+set(header_paths)
+foreach(line IN LISTS header_lines)
+  if(line MATCHES "^[ \t]*\\{\"([^\"]+)\", *\"([^\"]*)\"")
+    list(APPEND queue "${CMAKE_MATCH_1}@${CMAKE_MATCH_2}")
+  elseif(line MATCHES "^[ \t]*\"(/[^\"]+)\"")
+    list(APPEND header_paths "${CMAKE_MATCH_1}")
+  endif()
+endforeach()
+if(NOT SEARCH_PATHS)
+  set(SEARCH_PATHS ${header_paths})
+endif()
+
+# Resolve name/revision to a file in SEARCH_PATHS (first directory wins).
+function(find_yang_file name rev out)
+  foreach(dir IN LISTS SEARCH_PATHS)
+    if(rev AND EXISTS "${dir}/${name}@${rev}.yang")
+      set(${out} "${dir}/${name}@${rev}.yang" PARENT_SCOPE)
+      return()
+    elseif(NOT rev)
+      file(GLOB candidates "${dir}/${name}@*.yang")
+      if(candidates)
+        list(SORT candidates)
+        list(GET candidates -1 latest)
+        set(${out} "${latest}" PARENT_SCOPE)
+        return()
+      elseif(EXISTS "${dir}/${name}.yang")
+        set(${out} "${dir}/${name}.yang" PARENT_SCOPE)
+        return()
+      endif()
+    endif()
+  endforeach()
+  set(${out} "" PARENT_SCOPE)
+endfunction()
+
+set(done)
+set(embedded_names)
+set(files)
+set(sums "")
+set(entries "")
+set(count 0)
+while(queue)
+  list(POP_FRONT queue item)
+  string(REGEX MATCH "^([^@]+)@(.*)$" _ "${item}")
+  set(name "${CMAKE_MATCH_1}")
+  set(rev "${CMAKE_MATCH_2}")
+  # an import without revision-date is satisfied by any embedded revision
+  if("${item}" IN_LIST done OR (NOT rev AND name IN_LIST embedded_names))
+    continue()
+  endif()
+  list(APPEND done "${item}")
+
+  find_yang_file("${name}" "${rev}" path)
+  if(NOT path)
+    message(STATUS "EmbedYangModules: ${item} not found, skipped")
+    continue()
+  endif()
+  # the revision actually embedded comes from the file name
+  get_filename_component(file_name "${path}" NAME_WE)
+  set(file_rev "")
+  if(file_name MATCHES "@(.+)$")
+    set(file_rev "${CMAKE_MATCH_1}")
+  endif()
+  list(APPEND done "${name}@${file_rev}")
+  list(APPEND embedded_names "${name}")
+
+  # ';' separates CMake list elements, so mask it before matching statements
+  file(READ "${path}" text)
+  string(REPLACE ";" "@SEMI@" text "${text}")
+  string(REGEX MATCHALL
+         "(import|include)[ \t\r\n]+[A-Za-z0-9_.-]+[ \t\r\n]*(\\{[^}]*\\}|@SEMI@)"
+         deps "${text}")
+  foreach(dep IN LISTS deps)
+    string(REGEX MATCH "^(import|include)[ \t\r\n]+([A-Za-z0-9_.-]+)" _
+                 "${dep}")
+    set(dep_name "${CMAKE_MATCH_2}")
+    set(dep_rev "")
+    if(dep MATCHES "revision-date[ \t\r\n]+\"?([0-9-]+)")
+      set(dep_rev "${CMAKE_MATCH_1}")
+    endif()
+    list(APPEND queue "${dep_name}@${dep_rev}")
+  endforeach()
+
+  list(APPEND files "${path}")
+  math(EXPR count "${count} + 1")
+  if(LIST_ONLY)
+    continue()
+  endif()
+  file(SHA256 "${path}" sum)
+  string(APPEND sums "${name}@${file_rev} ${sum}\n")
+
+  # Emit the text as a string literal of \xNN escapes, 32 bytes per line.
+  file(READ "${path}" hex HEX)
+  string(LENGTH "${hex}" hex_len)
+  math(EXPR size "${hex_len} / 2")
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "\\\\x\\1" escaped "${hex}")
+  string(REGEX REPLACE "(................................................................................................................................)"
+         "\\1\"\n     \"" escaped "${escaped}")
+  string(APPEND entries
+         "    {\"${name}\", \"${file_rev}\",\n"
+         "     {\"${escaped}\",\n      ${size}}},\n")
+  message(STATUS "EmbedYangModules: ${name}@${file_rev} (${size} bytes)")
+endwhile()
+
+if(count EQUAL 0)
+  message(FATAL_ERROR
+          "YANG_EMBED_MODULES: no modules found in ${SEARCH_PATHS}")
+endif()
+
+if(LIST_ONLY)
+  file(WRITE "${OUTPUT}.tmp" "${files}")
+else()
+  # one digest over every module's name, revision and text
+  string(SHA256 digest "${sums}")
+  file(WRITE "${OUTPUT}.tmp"
+       "// Generated by cmake/EmbedYangModules.cmake from ${YANG_HEADER}.\n"
+       "// Do not edit.\n\n"
+       "static constexpr yang::EmbeddedModule kEmbeddedModuleTable[] = {\n"
+       "${entries}"
+       "};\n\n"
+       "static constexpr std::string_view kEmbeddedModuleDigest =\n"
+       "    \"${digest}\";\n")
+endif()
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp"
+                        "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,60 @@
+# Generates include/IanaIfType.hpp from the iana-if-type YANG module.
+#
+# Run in script mode whenever IANA publishes a new revision:
+#   cmake -DYANG_FILE=<iana-if-type@REVISION.yang>
+#         -DOUTPUT=<include/IanaIfType.hpp> -P GenerateIanaIfType.cmake
+# (the regen-iana-if-type target does this for the installed module). With
+# -DCHECK_AGAINST=<header> the script fails unless OUTPUT comes out
+# identical to that header.
+#
+# Every identity except the module's base (iana-interface-type) becomes an
+# IanaIfType enumerator, in file order, with '-' replaced by '_'. The name
+# table and the perfect hash for the reverse lookup are derived from that
+# list at compile time (see IanaIfType.hpp.in).
+
+cmake_minimum_required(VERSION 3.16)
+
+if(NOT YANG_FILE OR NOT OUTPUT)
+  message(FATAL_ERROR "YANG_FILE and OUTPUT are required")
+endif()
+
+file(STRINGS "${YANG_FILE}" yang_lines)
+
+set(IANA_IF_TYPE_REVISION "")
+set(IANA_IF_TYPE_ENUMERATORS "")
+set(IANA_IF_TYPE_NAMES "")
+set(count 0)
+foreach(line IN LISTS yang_lines)
+  if(NOT IANA_IF_TYPE_REVISION AND
+     line MATCHES "^[ \t]*revision[ \t]+\"?([0-9]+-[0-9]+-[0-9]+)")
+    # the newest revision comes first
+    set(IANA_IF_TYPE_REVISION "${CMAKE_MATCH_1}")
+  elseif(line MATCHES "^[ \t]*identity[ \t]+\"?([A-Za-z_][A-Za-z0-9_.-]*)")
+    set(name "${CMAKE_MATCH_1}")
+    if(name STREQUAL "iana-interface-type")
+      continue()
+    endif()
+    string(REGEX REPLACE "[-.]" "_" identifier "${name}")
+    string(APPEND IANA_IF_TYPE_ENUMERATORS "    ${identifier},\n")
+    string(APPEND IANA_IF_TYPE_NAMES "        \"${name}\",\n")
+    math(EXPR count "${count} + 1")
+  endif()
+endforeach()
+
+if(count EQUAL 0 OR NOT IANA_IF_TYPE_REVISION)
+  message(FATAL_ERROR "${YANG_FILE}: no identities or revision found")
+endif()
+
+get_filename_component(template_dir "${CMAKE_CURRENT_LIST_FILE}" DIRECTORY)
+configure_file("${template_dir}/IanaIfType.hpp.in" "${OUTPUT}" @ONLY)
+message(STATUS "IanaIfType: ${count} identities, revision "
+               "${IANA_IF_TYPE_REVISION}")
+
+if(CHECK_AGAINST)
+  file(READ "${OUTPUT}" generated)
+  file(READ "${CHECK_AGAINST}" committed)
+  if(NOT generated STREQUAL committed)
+    message(FATAL_ERROR "${CHECK_AGAINST} differs from the output for "
+                        "${YANG_FILE}; run the regen-iana-if-type target")
+  endif()
+endif()
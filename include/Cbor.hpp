@@ -0,0 +1,141 @@
+#pragma once
+
+#include "SidMap.hpp"
+#include "YangReader.hpp"
+#include "YangWriter.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace yang {
+
+  // Writes CBOR (RFC 8949) data items to a YangOutput. Arrays and maps have
+  // definite lengths: announce the number of items (or pairs) first.
+  class CborWriter {
+  public:
+    explicit CborWriter(YangOutput &out) : out_(out) {}
+
+    void unsignedInt(std::uint64_t v) { head(0, v); }
+    void integer(std::int64_t v) {
+      if (v < 0)
+        head(1, static_cast<std::uint64_t>(-1 - v));
+      else
+        head(0, static_cast<std::uint64_t>(v));
+    }
+    void text(std::string_view s) {
+      head(3, s.size());
+      out_.write(s);
+    }
+    void boolean(bool b) { out_.put(static_cast<char>(b ? 0xf5 : 0xf4)); }
+    void null() { out_.put(static_cast<char>(0xf6)); }
+    void beginArray(std::size_t items) { head(4, items); }
+    void beginMap(std::size_t pairs) { head(5, pairs); }
+
+    // Map key of a YANG-CBOR member: its SID relative to the SID of the
+    // enclosing container or list, or absolute at the top (RFC 9254 3.2).
+    void key(std::uint64_t sid, std::uint64_t parent = 0) {
+      integer(static_cast<std::int64_t>(sid - parent));
+    }
+    // identityref value: its SID, or the "module:name" string when `sids`
+    // has none (RFC 9254 6.10)
+    void identity(const SidMap &sids, std::string_view qualified_name);
+
+  private:
+    void head(unsigned major, std::uint64_t v);
+
+    YangOutput &out_;
+  };
+
+  // Pull parser for CBOR data items from a YangInput. Tags are skipped
+  // (tag() reports the last one), indefinite-length strings, arrays and
+  // maps are accepted. Malformed input throws YangParseError.
+  //
+  //   auto map = reader.expectMap();
+  //   while (reader.more(map)) {
+  //     std::uint64_t sid = parent + reader.readInteger();
+  //     if (sid == mtu_sid) mtu = reader.readUnsigned();
+  //     else reader.skip();
+  //   }
+  class CborReader {
+  public:
+    enum class Type {
+      Unsigned,
+      Negative,
+      Bytes,
+      Text,
+      Array,
+      Map,
+      Simple,
+      Float,
+      End // end of input
+    };
+
+    // Items left in an array or map.
+    struct Container {
+      std::uint64_t left;
+      bool indefinite;
+    };
+
+    explicit CborReader(YangInput &in) : in_(in) {}
+
+    CborReader(const CborReader &) = delete;
+    CborReader &operator=(const CborReader &) = delete;
+
+    // Reads the head of the next item. The argument (integer value, string
+    // length, item count, simple value) is then in argument().
+    Type next();
+    std::uint64_t argument() const noexcept { return arg_; }
+    bool indefinite() const noexcept { return indefinite_; }
+    // last tag seen before the current item, or -1
+    std::int64_t tag() const noexcept { return tag_; }
+
+    // After next() returned Array or Map.
+    Container container() const noexcept {
+      return {arg_, indefinite_};
+    }
+    // True while `c` has items (map: pairs) left; consumes one.
+    bool more(Container &c);
+    // After next() returned Text or Bytes: the payload; valid until the
+    // reader advances again.
+    std::string_view payload();
+    // Skips the rest of the current item (after next()). Fails on arrays
+    // and maps nested deeper than kMaxSkipDepth, so that hostile input
+    // cannot exhaust the stack.
+    void skipCurrent();
+    static constexpr unsigned kMaxSkipDepth = 64;
+
+    // Convenience readers for the next item; throw on a type mismatch.
+    Container expectArray();
+    Container expectMap();
+    std::uint64_t readUnsigned();
+    std::int64_t readInteger();
+    std::string_view readText();
+    bool readBool();
+    // identityref as SID or string, returned as "module:name"; an unknown
+    // SID throws
+    std::string readIdentity(const SidMap &sids);
+    // Skips the next item, whatever it is.
+    void skip() {
+      next();
+      skipCurrent();
+    }
+
+    std::size_t offset() const noexcept { return offset_; }
+    [[noreturn]] void fail(const std::string &what) const;
+
+  private:
+    int byte();
+    std::uint64_t readArgument(unsigned info);
+
+    YangInput &in_;
+    std::size_t offset_ = 0;
+    std::uint64_t arg_ = 0;
+    bool indefinite_ = false;
+    std::int64_t tag_ = -1;
+    Type type_ = Type::End;
+    unsigned depth_ = 0; // containers skipCurrent() is inside
+    std::string payload_;
+  };
+
+} // namespace yang
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <libyang/libyang.h>
+#include <span>
+#include <string_view>
+
+namespace yang {
+
+  // A YANG module (or submodule) whose source text is compiled into
+  // yang_lib. `text` is NUL-terminated as libyang requires.
+  struct EmbeddedModule {
+    std::string_view name;
+    std::string_view revision;
+    std::string_view text;
+  };
+
+  // Modules embedded with the YANG_EMBED_MODULES build option: every entry
+  // of kDefaultModules plus everything it imports or includes. Empty when
+  // the library was built without the option.
+  std::span<const EmbeddedModule> embeddedModules() noexcept;
+
+  // SHA-256 (hex) over the name, revision and text of every embedded
+  // module, computed at build time; empty without YANG_EMBED_MODULES.
+  std::string_view embeddedModulesDigest() noexcept;
+
+  // Exact revision, or the latest embedded one when `revision` is empty.
+  // Modules embedded without a revision in their file name match any
+  // revision.
+  const EmbeddedModule *findEmbeddedModule(std::string_view name,
+                                           std::string_view revision) noexcept;
+
+  // ly_module_imp_clb serving embeddedModules(); no user data is needed.
+  LY_ERR embeddedModuleImportCallback(
+      const char *mod_name, const char *mod_rev, const char *submod_name,
+      const char *submod_rev, void *user_data, LYS_INFORMAT *format,
+      const char **module_data, ly_module_imp_data_free_clb *free_module_data);
+
+} // namespace yang
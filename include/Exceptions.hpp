@@ -138,6 +138,22 @@ namespace yang {
     const YangContext *ctx_ = nullptr;
   };
 
+  // Malformed XML, JSON or CBOR met while streaming (see YangReader,
+  // CborReader). line() is 0 for input without lines.
+  class YangParseError : public std::runtime_error {
+  public:
+    YangParseError(const std::string &what, std::size_t line)
+        : std::runtime_error("line " + std::to_string(line) + ": " + what),
+          line_(line) {}
+    explicit YangParseError(const std::string &what)
+        : std::runtime_error(what), line_(0) {}
+
+    std::size_t line() const noexcept { return line_; }
+
+  private:
+    std::size_t line_;
+  };
+
   // Exception thrown when module iterator cannot continue (no more modules).
   class ModuleIteratorStopError : public std::runtime_error {
   public:
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include <cstddef>
+#include <initializer_list>
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace yang {
+
+  // Declarative set of YANG features to enable, per module.
+  //
+  //   FeatureProfile profile = {
+  //       {"ietf-routing", {}},              // all features off
+  //       {"ietf-interfaces", {"if-mib"}},   // only if-mib
+  //   };
+  //
+  // apply() rewrites a module list so that each listed module is loaded with
+  // exactly the given features (through the ModuleSpec features pointer);
+  // modules the profile does not mention keep their own setting. "*" enables
+  // every feature of a module. Disabling features that are never used
+  // removes their schema nodes from the compiled context, which shrinks it
+  // and makes validation cheaper.
+  class FeatureProfile {
+  public:
+    FeatureProfile() = default;
+    FeatureProfile(
+        std::initializer_list<std::pair<std::string, std::vector<std::string>>>
+            modules);
+
+    FeatureProfile(const FeatureProfile &other);
+    FeatureProfile &operator=(const FeatureProfile &other);
+    FeatureProfile(FeatureProfile &&) noexcept = default;
+    FeatureProfile &operator=(FeatureProfile &&) noexcept = default;
+
+    // Enabled features for `module`, or nullptr when the profile does not
+    // mention it. The array is nullptr-terminated and lives as long as the
+    // profile.
+    const char **features(const std::string &module) const;
+
+    // `modules` with the profile's features filled in. The returned specs
+    // point into this profile, which must outlive any use of them.
+    std::vector<ModuleSpec> apply(std::span<const ModuleSpec> modules) const;
+
+    bool empty() const noexcept { return modules_.empty(); }
+
+  private:
+    struct Entry {
+      std::vector<std::string> names;
+      std::vector<const char *> c_names; // into `names`, nullptr-terminated
+    };
+    static void link(Entry &e);
+
+    std::map<std::string, Entry> modules_;
+  };
+
+  // Size of a compiled schema, for comparing feature profiles.
+  struct SchemaReport {
+    struct Module {
+      std::string name;
+      std::string revision;
+      // compiled schema nodes defined by this module (including the ones it
+      // augments into other modules' trees)
+      std::size_t nodes = 0;
+    };
+    std::vector<Module> modules; // implemented modules, in context order
+    std::size_t total_nodes = 0;
+    // size of the compiled context as printed by ly_ctx_compiled_size(); 0
+    // if libyang cannot print it
+    std::size_t compiled_bytes = 0;
+
+    static SchemaReport of(const YangContext &ctx);
+  };
+
+} // namespace yang
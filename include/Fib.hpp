@@ -0,0 +1,140 @@
+#pragma once
+
+#include "IetfInetTypes.hpp"
+#include "IetfRouting.hpp"
+#include "RouteStore.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace yang {
+
+  namespace detail {
+
+    // Multibit trie for longest-prefix match. The first level is a flat
+    // table indexed by the top `first_bytes` bytes of the address (3 for
+    // IPv4: DIR-24-8), each further level a 256-entry table indexed by the
+    // next byte. An entry holds a value + 1 (0: no route) or, with kChild
+    // set, the number of a child table. A lookup is one load per level,
+    // and most IPv4 addresses resolve in the first.
+    class LpmTrie {
+    public:
+      static constexpr std::uint32_t kChild = 0x80000000u;
+      static constexpr std::uint32_t kMaxValue = kChild - 2;
+
+      LpmTrie(unsigned address_bytes, unsigned first_bytes)
+          : bytes_(address_bytes), first_bytes_(first_bytes) {}
+
+      // Prefixes must come in order of increasing length: a prefix only
+      // overwrites shorter ones, so the fill never meets a child table.
+      void insert(const std::uint8_t *address, unsigned length,
+                  std::uint32_t value);
+
+      // Drops the spare capacity left by insert().
+      void shrink() {
+        first_.shrink_to_fit();
+        tables_.shrink_to_fit();
+      }
+
+      std::uint32_t lookup(const std::uint8_t *address) const noexcept {
+        if (first_.empty())
+          return ~0u;
+        std::uint32_t e = first_[firstIndex(address)];
+        for (unsigned i = first_bytes_; e & kChild; ++i)
+          e = tables_[std::size_t(e & ~kChild) * 256 + address[i]];
+        return e - 1; // ~0u for no route
+      }
+
+      void prefetch(const std::uint8_t *address) const noexcept {
+        if (!first_.empty())
+          __builtin_prefetch(&first_[firstIndex(address)]);
+      }
+
+      std::size_t memoryUsage() const noexcept {
+        return (first_.capacity() + tables_.capacity()) *
+               sizeof(std::uint32_t);
+      }
+
+    private:
+      std::size_t firstIndex(const std::uint8_t *address) const noexcept {
+        std::size_t index = 0;
+        for (unsigned i = 0; i < first_bytes_; ++i)
+          index = index << 8 | address[i];
+        return index;
+      }
+
+      // child table below `slot`, made from its value if it has none
+      std::size_t child(std::uint32_t *slot);
+
+      unsigned bytes_;
+      unsigned first_bytes_;
+      std::vector<std::uint32_t> first_;
+      std::vector<std::uint32_t> tables_;
+    };
+
+  } // namespace detail
+
+  // Forwarding table compiled from a RIB, for longest-prefix-match lookups
+  // of IPv4 and IPv6 addresses. The result of a lookup is the index of the
+  // matching route in the Rib's `routes`, or kNoRoute.
+  //
+  //   Fib fib(routing.ribs[0]);
+  //   fib.lookup(addresses, routes); // one result per address
+  //
+  // IPv4 uses DIR-24-8 (64 MiB for the first level, allocated with the
+  // first IPv4 route); IPv6 a 16-bit first level and 8-bit strides. The
+  // table is immutable: build a new one when the RIB changes.
+  class Fib {
+  public:
+    static constexpr std::uint32_t kNoRoute = ~0u;
+
+    template <typename Prefix> struct Entry {
+      Prefix prefix;
+      std::uint32_t value;
+    };
+
+    Fib() = default;
+
+    // Routes with a destination prefix. Where several share a prefix, an
+    // active one wins, then the lowest route-preference, then the first.
+    explicit Fib(const IetfRouting::Rib &rib);
+    // The same for packed routes; lookups return record indexes.
+    explicit Fib(const RouteStore &store);
+
+    // Arbitrary values (below 2^31 - 1) per prefix; for equal prefixes the
+    // last entry wins.
+    Fib(std::span<const Entry<Ipv4Prefix>> ipv4,
+        std::span<const Entry<Ipv6Prefix>> ipv6);
+
+    std::uint32_t lookup(const Ipv4Address &a) const noexcept {
+      return ipv4_.lookup(a.bytes.data());
+    }
+    std::uint32_t lookup(const Ipv6Address &a) const noexcept {
+      return ipv6_.lookup(a.bytes.data());
+    }
+
+    // Batch lookups, one result in `out` per address of `in`. The first-level
+    // slots of later addresses are prefetched while earlier ones resolve,
+    // so the loads of independent lookups overlap.
+    void lookup(std::span<const Ipv4Address> in,
+                std::span<std::uint32_t> out) const noexcept;
+    void lookup(std::span<const Ipv6Address> in,
+                std::span<std::uint32_t> out) const noexcept;
+
+    std::size_t ipv4Routes() const noexcept { return ipv4_routes_; }
+    std::size_t ipv6Routes() const noexcept { return ipv6_routes_; }
+    std::size_t memoryUsage() const noexcept {
+      return ipv4_.memoryUsage() + ipv6_.memoryUsage();
+    }
+
+  private:
+    detail::LpmTrie ipv4_{4, 3};
+    detail::LpmTrie ipv6_{16, 2};
+    std::size_t ipv4_routes_ = 0;
+    std::size_t ipv6_routes_ = 0;
+  };
+
+} // namespace yang
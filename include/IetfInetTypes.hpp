@@ -1,7 +1,11 @@
 #pragma once
 
+#include <array>
+#include <compare>
 #include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
 
 namespace yang {
 
@@ -52,4 +56,43 @@ namespace yang {
   using ip_prefix = IpPrefix;             // YANG: ip-prefix
   using host = Host;                      // YANG: host
 
+  // Binary addresses and prefixes, for lookups rather than display. The
+  // bytes are in network order. parse() takes the textual form
+  // (inet_pton(), without a zone) and returns nullopt if it is not valid.
+  struct Ipv4Address {
+    std::array<std::uint8_t, 4> bytes{};
+
+    static std::optional<Ipv4Address> parse(std::string_view text);
+    std::string toString() const;
+    auto operator<=>(const Ipv4Address &) const = default;
+  };
+
+  struct Ipv6Address {
+    std::array<std::uint8_t, 16> bytes{};
+
+    static std::optional<Ipv6Address> parse(std::string_view text);
+    std::string toString() const;
+    auto operator<=>(const Ipv6Address &) const = default;
+  };
+
+  // "address/length". Bits past `length` are cleared on parse, as in the
+  // canonical form of ipv4-prefix and ipv6-prefix.
+  struct Ipv4Prefix {
+    Ipv4Address address;
+    std::uint8_t length = 0;
+
+    static std::optional<Ipv4Prefix> parse(std::string_view text);
+    std::string toString() const;
+    auto operator<=>(const Ipv4Prefix &) const = default;
+  };
+
+  struct Ipv6Prefix {
+    Ipv6Address address;
+    std::uint8_t length = 0;
+
+    static std::optional<Ipv6Prefix> parse(std::string_view text);
+    std::string toString() const;
+    auto operator<=>(const Ipv6Prefix &) const = default;
+  };
+
 } // namespace yang
@@ -2,10 +2,13 @@
 
 #include "IanaIfType.hpp"
 #include "IetfYangTypes.hpp"
+#include "SidMap.hpp"
 #include "YangModel.hpp"
 
 #include <cstdint>
+#include <functional>
 #include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -95,9 +98,43 @@ namespace yang {
     bool removeInterfaceByName(const std::string &name);
 
     // YangModel interface
+    static std::span<const ModuleSpec> requiredModules();
     struct lyd_node *serialize(const YangContext &ctx) const override;
+    void write(YangWriter &writer) const override;
     static std::unique_ptr<IetfInterfaces> deserialize(const YangContext &ctx,
                                                        struct lyd_node *tree);
+    // Counter polling: reads only the name and statistics of each interface
+    // in `tree`, skipping the configuration leaves, and hands the entries
+    // that have statistics to `on_statistics` in document order.
+    static void deserializeStatistics(
+        const YangContext &ctx, struct lyd_node *tree,
+        const std::function<void(const std::string &name,
+                                 IetfInterfaceStatistics &&)> &on_statistics);
+
+    // Streams /interfaces/interface from `reader` (XML or JSON) without a
+    // data tree, handing each entry to `on_interface` once it is complete;
+    // only that entry is held in memory. Fills the same fields as
+    // deserialize(). With `validate`, every value of an entry, state leaves
+    // and statistics included, is created as a typed libyang node, so a
+    // value its schema type rejects throws YangDataError.
+    static void read(YangReader &reader,
+                     const std::function<void(IetfInterface &&)> &on_interface,
+                     bool validate = false);
+    // Same, collecting the entries into a model.
+    static std::unique_ptr<IetfInterfaces> read(YangReader &reader,
+                                                bool validate = false);
+
+    // YANG-CBOR (RFC 9254): members keyed by SID deltas taken from `sids`,
+    // encoded straight from the structs and decoded straight into them,
+    // statistics included. A present value whose node has no SID throws
+    // std::invalid_argument; identities without a SID are sent by name.
+    // Members with SIDs this model does not know are skipped when reading.
+    void writeCbor(const SidMap &sids, YangOutput &out) const;
+    static void
+    readCbor(const SidMap &sids, YangInput &in,
+             const std::function<void(IetfInterface &&)> &on_interface);
+    static std::unique_ptr<IetfInterfaces> readCbor(const SidMap &sids,
+                                                    YangInput &in);
 
   private:
     std::vector<IetfInterface> ifs_;
@@ -1,12 +1,17 @@
 #pragma once
 
+#include "IetfInetTypes.hpp"
 #include "IetfInterfaces.hpp"
 #include "IetfYangTypes.hpp"
+#include "SidMap.hpp"
+#include "YangIdentity.hpp"
 #include "YangModel.hpp"
 
 #include <cstdint>
 #include <optional>
+#include <span>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace yang {
@@ -24,6 +29,8 @@ namespace yang {
     struct NextHopListEntry {
       std::string index;                             // key
       std::optional<std::string> outgoing_interface; // if:interface-ref
+
+      bool operator==(const NextHopListEntry &) const = default;
     };
 
     enum class SpecialNextHop { Blackhole, Unreachable, Prohibit, Receive };
@@ -32,32 +39,46 @@ namespace yang {
     struct NextHop {
       // simple-next-hop
       std::optional<std::string> outgoing_interface; // if:interface-ref
+      // next-hop-address of ietf-ipv4/ipv6-unicast-routing
+      std::variant<std::monostate, Ipv4Address, Ipv6Address> address;
 
       // special-next-hop
       std::optional<SpecialNextHop> special_next_hop;
 
       // next-hop-list
       std::vector<NextHopListEntry> next_hop_list;
+
+      bool operator==(const NextHop &) const = default;
     };
 
     struct RouteMetadata {
-      std::string source_protocol; // identityref base routing-protocol
-      bool active = false;         // presence (empty leaf)
+      YangIdentity source_protocol; // identityref base routing-protocol
+      bool active = false;          // presence (empty leaf)
       std::optional<yang::date_and_time> last_updated;
+
+      bool operator==(const RouteMetadata &) const = default;
     };
 
     using RoutePreference = std::uint32_t; // typedef route-preference
 
+    // destination-prefix of ietf-ipv4-unicast-routing or
+    // ietf-ipv6-unicast-routing; monostate when the route has none
+    using DestinationPrefix =
+        std::variant<std::monostate, Ipv4Prefix, Ipv6Prefix>;
+
     struct Route {
+      DestinationPrefix destination_prefix;
       std::optional<RoutePreference> route_preference;
       std::optional<NextHop>
           next_hop; // container next-hop (uses next-hop-state-content)
       std::optional<RouteMetadata> metadata; // uses route-metadata
+
+      bool operator==(const Route &) const = default;
     };
 
     struct Rib {
-      std::string name;           // key
-      std::string address_family; // identityref from grouping address-family
+      std::string name;            // key
+      YangIdentity address_family; // identityref base address-family
       bool default_rib =
           true; // if-feature multiple-ribs; config false in model
       std::vector<Route> routes; // config false: operational routes in the RIB
@@ -65,7 +86,7 @@ namespace yang {
     };
 
     struct ControlPlaneProtocol {
-      std::string type; // identityref base control-plane-protocol
+      YangIdentity type; // identityref base control-plane-protocol
       std::string name; // key (together with type)
       std::optional<std::string> description;
 
@@ -103,10 +124,19 @@ namespace yang {
     }
 
     // YangModel interface
+    static std::span<const ModuleSpec> requiredModules();
     struct lyd_node *serialize(const YangContext &ctx) const override;
+    void write(YangWriter &writer) const override;
     static std::unique_ptr<IetfRouting> deserialize(const YangContext &ctx,
                                                     struct lyd_node *tree);
 
+    // YANG-CBOR of the /ietf-routing:routing subtree, keyed by SID deltas
+    // from `sids` (see IetfInterfaces::writeCbor). As with write(), static
+    // routes and interfaces_info are not encoded.
+    void writeCbor(const SidMap &sids, YangOutput &out) const;
+    static std::unique_ptr<IetfRouting> readCbor(const SidMap &sids,
+                                                 YangInput &in);
+
   private:
     Routing routing_;
   };
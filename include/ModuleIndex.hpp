@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <libyang/libyang.h>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace yang {
+
+  // In-memory index of the YANG files below a set of search directories.
+  //
+  // The directories are scanned once into a `name -> {revision, file}` map
+  // and modules are then handed to libyang through its module import
+  // callback (see YangContext::setModuleIndex()), so resolving an import no
+  // longer walks thousands of files with readdir()/stat(). The index can be
+  // persisted and is considered stale as soon as the mtime of any indexed
+  // directory changes (files added, removed or renamed).
+  class ModuleIndex {
+  public:
+    struct Entry {
+      std::string name;
+      std::string revision; // empty for files without "@revision"
+      std::string path;
+      LYS_INFORMAT format = LYS_IN_YANG;
+    };
+
+    ModuleIndex() = default;
+    ModuleIndex(ModuleIndex &&other) noexcept;
+    ModuleIndex &operator=(ModuleIndex &&other) noexcept;
+
+    // Recursively index every *.yang / *.yin file below `dirs`;
+    // directories that do not exist are skipped.
+    static ModuleIndex scan(const std::vector<std::string> &dirs);
+
+    // Load a persisted index; nullopt if missing, unreadable, built for
+    // other directories or stale.
+    static std::optional<ModuleIndex>
+    load(const std::string &file, const std::vector<std::string> &dirs);
+
+    // load() falling back to scan(); a fresh scan is written back to `file`.
+    static ModuleIndex loadOrScan(const std::string &file,
+                                  const std::vector<std::string> &dirs);
+
+    bool save(const std::string &file) const;
+
+    // Exact revision, or the latest available one when `revision` is empty.
+    // A file without a revision in its name is used as a fallback; libyang
+    // verifies the revision it actually contains.
+    const Entry *find(std::string_view name, std::string_view revision) const;
+
+    std::size_t size() const noexcept { return entries_; }
+    const std::vector<std::string> &directories() const noexcept {
+      return dirs_;
+    }
+    // directories() and every directory below them, as scanned; adding or
+    // removing a module file changes the mtime of one of these
+    std::vector<std::string> scannedDirectories() const;
+
+    // ly_module_imp_clb implementation; `user_data` is the ModuleIndex.
+    // Module text is served from a read-only mmap of the indexed file.
+    static LY_ERR importCallback(const char *mod_name, const char *mod_rev,
+                                 const char *submod_name,
+                                 const char *submod_rev, void *user_data,
+                                 LYS_INFORMAT *format, const char **module_data,
+                                 ly_module_imp_data_free_clb *free_module_data);
+
+  private:
+    struct DirStamp {
+      std::string path;
+      std::int64_t mtime_sec = 0;
+      std::int64_t mtime_nsec = 0;
+    };
+
+    static void releaseCallback(void *module_data, void *user_data);
+
+    std::vector<std::string> dirs_;
+    std::vector<DirStamp> stamps_;
+    // per module name, sorted by descending revision (undated last)
+    std::unordered_map<std::string, std::vector<Entry>> modules_;
+    std::size_t entries_ = 0;
+
+    // Buffers handed to libyang and not yet released: data -> mapping size
+    // (0 for heap copies).
+    mutable std::mutex mapped_mutex_;
+    mutable std::unordered_map<const void *, std::size_t> mapped_;
+  };
+
+} // namespace yang
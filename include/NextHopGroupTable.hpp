@@ -0,0 +1,67 @@
+#pragma once
+
+#include "IetfRouting.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace yang {
+
+  // Hash-consed next hops. Equal next hops intern to one group, which
+  // routes reference by id. Groups are reference counted and their ids
+  // reused once released. update() changes a group in place, so every
+  // route using it follows at once: on link down, repoint the one group
+  // instead of each of 100k routes.
+  //
+  //   auto id = groups.intern(hop);    // one reference
+  //   groups.update(id, backup_hop);   // all users of `id` now see it
+  //   groups.release(id);
+  //
+  // Not synchronised; guard a table shared between threads.
+  class NextHopGroupTable {
+  public:
+    using Id = std::uint32_t;
+
+    // Group holding a next hop equal to `hop`, created if there is none.
+    // Takes a reference.
+    Id intern(const IetfRouting::NextHop &hop);
+
+    // One more reference to a live group.
+    void acquire(Id id) { ++groups_.at(id).refs; }
+    // Drops a reference; the last one frees the group and its id.
+    void release(Id id);
+
+    const IetfRouting::NextHop &operator[](Id id) const {
+      return groups_[id].hop;
+    }
+    std::uint32_t refs(Id id) const { return groups_.at(id).refs; }
+
+    // Replaces the next hop of a live group. If another group already
+    // holds `hop`, the two stay separate groups with equal next hops;
+    // intern() returns either.
+    void update(Id id, IetfRouting::NextHop hop);
+
+    // Live groups.
+    std::size_t size() const noexcept { return groups_.size() - free_.size(); }
+
+    // Heap bytes held, next-hop strings included.
+    std::size_t memoryUsage() const noexcept;
+
+  private:
+    struct Group {
+      IetfRouting::NextHop hop;
+      std::size_t hash = 0;
+      std::uint32_t refs = 0; // 0: free
+    };
+
+    void unindex(Id id);
+
+    std::vector<Group> groups_;
+    std::vector<Id> free_;
+    // live groups by the hash of their next hop
+    std::unordered_multimap<std::size_t, Id> index_;
+  };
+
+} // namespace yang
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "IetfRouting.hpp"
+#include "YangIdentity.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace yang {
+
+  namespace detail {
+
+    // destination-prefix as a hashable value: an IPv4 address takes the
+    // first 4 bytes, family is 4 or 6
+    struct PrefixKey {
+      std::array<std::uint8_t, 16> bytes{};
+      std::uint8_t length = 0;
+      std::uint8_t family = 0;
+
+      bool operator==(const PrefixKey &) const = default;
+    };
+
+    struct PrefixKeyHash {
+      std::size_t operator()(const PrefixKey &k) const noexcept;
+    };
+
+  } // namespace detail
+
+  // A batch of route changes for RibUpdater::apply(). A route is named by
+  // its destination prefix and the source protocol of its metadata (none
+  // without metadata); operations apply in the order they were added.
+  //
+  //   RibTransaction txn;
+  //   txn.add(route);
+  //   txn.withdraw(*Ipv4Prefix::parse("192.0.2.0/24"), kStatic);
+  //   RibDelta delta = updater.apply(txn);
+  class RibTransaction {
+  public:
+    enum class Op : std::uint8_t { Add, Replace, Withdraw };
+
+    struct Operation {
+      Op op;
+      // for Withdraw, only the prefix and source protocol are set
+      IetfRouting::Route route;
+    };
+
+    // Each throws std::invalid_argument for a route without a destination
+    // prefix.
+    //
+    // A route the RIB does not have yet.
+    void add(IetfRouting::Route route);
+    // New content for a route the RIB has.
+    void replace(IetfRouting::Route route);
+    void withdraw(const IetfRouting::DestinationPrefix &prefix,
+                  YangIdentity source_protocol);
+
+    std::span<const Operation> operations() const noexcept { return ops_; }
+    std::size_t size() const noexcept { return ops_.size(); }
+    bool empty() const noexcept { return ops_.empty(); }
+    void clear() noexcept { ops_.clear(); }
+
+  private:
+    void push(Op op, IetfRouting::Route route);
+
+    std::vector<Operation> ops_;
+  };
+
+  // The prefixes whose active route a transaction changed, in the order
+  // the transaction first touched them.
+  struct RibDelta {
+    static constexpr std::uint32_t kNoRoute = ~0u;
+
+    enum class Change : std::uint8_t {
+      Added,     // the prefix had no active route
+      Replaced,  // another route, or the same one with new content
+      Withdrawn, // no route is left for the prefix
+    };
+
+    struct Entry {
+      IetfRouting::DestinationPrefix prefix;
+      Change change;
+      // index of the active route in rib.routes; kNoRoute when withdrawn
+      std::uint32_t route;
+    };
+
+    std::vector<Entry> changes;
+  };
+
+  // Applies RibTransactions to a Rib, keeping the routes of each prefix
+  // indexed so that a transaction costs in proportion to its own size, not
+  // to the RIB's. The best path of a prefix is the route with the lowest
+  // route-preference (none ranks last); on a tie the active route stays,
+  // then the first in rib.routes wins. metadata/active marks it, created
+  // if needed.
+  //
+  // The constructor selects the best path of every prefix once. After
+  // that, only prefixes a transaction touched are selected again. Routes
+  // must not be changed but through apply() while the updater lives.
+  // Withdrawn routes are replaced by the last route of rib.routes, so
+  // indexes into it are only valid until the next apply().
+  class RibUpdater {
+  public:
+    explicit RibUpdater(IetfRouting::Rib &rib);
+
+    // All or nothing: an add of a route the RIB already has, or a replace
+    // or withdraw of one it does not (counting the earlier operations of
+    // the transaction), throws std::invalid_argument before any change.
+    RibDelta apply(const RibTransaction &txn);
+
+    const IetfRouting::Rib &rib() const noexcept { return rib_; }
+
+  private:
+    // indexes into rib_.routes of the routes of one prefix
+    using Candidates = std::vector<std::uint32_t>;
+
+    std::uint32_t find(const detail::PrefixKey &prefix,
+                       YangIdentity source_protocol) const;
+    // marks the best path of `routes` active; returns it
+    std::uint32_t select(const Candidates &routes);
+    void remove(std::uint32_t route);
+
+    IetfRouting::Rib &rib_;
+    std::unordered_map<detail::PrefixKey, Candidates, detail::PrefixKeyHash>
+        index_;
+  };
+
+} // namespace yang
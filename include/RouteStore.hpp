@@ -0,0 +1,109 @@
+#pragma once
+
+#include "IetfRouting.hpp"
+#include "NextHopGroupTable.hpp"
+#include "YangIdentity.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace yang {
+
+  // Packed storage for the routes of a RIB. IetfRouting::Route costs a few
+  // hundred bytes and several allocations per route; here each route is a
+  // 32-byte record. Optional fields are flagged in a presence mask, the
+  // source protocol is a YangIdentity, and next hops are interned in a
+  // NextHopGroupTable: routes with equal next hops share one group,
+  // referenced by id, and each record holds a reference to its group.
+  // last-updated, rarely set on large tables, lives in a side table.
+  //
+  //   RouteStore store(rib.routes);
+  //   rib.routes.clear();
+  //   ...
+  //   IetfRouting::Route r = store.route(i); // or store.routes()
+  //   store.updateNextHop(store[i].next_hop, backup); // every user of it
+  //
+  // Stores may share one group table, e.g. the RIBs of one router; copies
+  // share their original's.
+  class RouteStore {
+  public:
+    // Bits of Record::present.
+    enum : std::uint8_t {
+      kPreference = 1 << 0,
+      kNextHop = 1 << 1,
+      kMetadata = 1 << 2,
+      kActive = 1 << 3, // metadata/active
+      kLastUpdated = 1 << 4,
+    };
+
+    struct Record {
+      // destination-prefix; an IPv4 address takes the first 4 bytes
+      std::array<std::uint8_t, 16> prefix{};
+      std::uint8_t prefix_length = 0;
+      std::uint8_t family = 0; // 4, 6, or 0 without a destination prefix
+      std::uint8_t present = 0;
+      std::uint8_t reserved = 0;
+      IetfRouting::RoutePreference preference = 0;
+      NextHopGroupTable::Id next_hop = 0; // with kNextHop
+      YangIdentity source_protocol;
+    };
+    static_assert(sizeof(Record) == 32);
+
+    explicit RouteStore(std::shared_ptr<NextHopGroupTable> groups =
+                            std::make_shared<NextHopGroupTable>());
+    explicit RouteStore(std::span<const IetfRouting::Route> routes,
+                        std::shared_ptr<NextHopGroupTable> groups =
+                            std::make_shared<NextHopGroupTable>());
+    RouteStore(const RouteStore &other);
+    RouteStore(RouteStore &&other) noexcept = default;
+    RouteStore &operator=(RouteStore other) noexcept;
+    ~RouteStore();
+
+    void reserve(std::size_t routes) { records_.reserve(routes); }
+    void push_back(const IetfRouting::Route &route);
+
+    std::size_t size() const noexcept { return records_.size(); }
+    bool empty() const noexcept { return records_.empty(); }
+    const Record &operator[](std::size_t i) const { return records_[i]; }
+    std::span<const Record> records() const noexcept { return records_; }
+
+    IetfRouting::DestinationPrefix destinationPrefix(std::size_t i) const;
+    const IetfRouting::NextHop &nextHop(NextHopGroupTable::Id group) const {
+      return (*groups_)[group];
+    }
+    // Live groups in the table, those of stores sharing it included.
+    std::size_t nextHopGroups() const noexcept { return groups_->size(); }
+    const std::shared_ptr<NextHopGroupTable> &nextHopTable() const noexcept {
+      return groups_;
+    }
+
+    // Repoints every route using `group`, in this store and any sharing
+    // its table, without touching their records.
+    void updateNextHop(NextHopGroupTable::Id group, IetfRouting::NextHop hop) {
+      groups_->update(group, std::move(hop));
+    }
+    // Moves route i alone to the group of `hop`.
+    void setNextHop(std::size_t i,
+                    const std::optional<IetfRouting::NextHop> &hop);
+
+    // Unpacked copies, equal to the routes that were stored.
+    IetfRouting::Route route(std::size_t i) const;
+    std::vector<IetfRouting::Route> routes() const;
+
+    // Heap bytes held, the whole group table included.
+    std::size_t memoryUsage() const noexcept;
+
+  private:
+    std::vector<Record> records_;
+    std::shared_ptr<NextHopGroupTable> groups_;
+    // (route, last-updated), in route order
+    std::vector<std::pair<std::uint32_t, date_and_time>> last_updated_;
+  };
+
+} // namespace yang
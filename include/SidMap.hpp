@@ -0,0 +1,82 @@
+#pragma once
+
+#include "YangReader.hpp"
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace yang {
+
+  // YANG Schema Item iDentifiers (SIDs, RFC 9254) read from .sid files
+  // (RFC 9595), as used by YANG-CBOR.
+  //
+  // Data nodes are looked up by schema node path, module-qualified where
+  // the module changes, exactly as the .sid file spells them:
+  //   "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4/mtu"
+  // Identities by "module:identity".
+  class SidMap {
+  public:
+    SidMap() = default;
+
+    // Adds the items of one .sid file in its JSON encoding (the
+    // ietf-sid-file:sid-file container). Files of several modules can be
+    // added to one map. Syntax errors throw YangParseError.
+    void add(YangInput &in);
+    void addFile(const std::string &path);
+
+    void addData(std::string path, std::uint64_t sid);
+    void addIdentity(std::string qualified_name, std::uint64_t sid);
+
+    std::optional<std::uint64_t> data(std::string_view path) const;
+    std::optional<std::uint64_t> identity(std::string_view name) const;
+    // "module:identity" of `sid`, or nullptr
+    const std::string *identityName(std::uint64_t sid) const;
+
+    std::size_t size() const noexcept {
+      return data_.size() + identities_.size();
+    }
+
+  private:
+    struct Hash {
+      using is_transparent = void;
+      std::size_t operator()(std::string_view s) const noexcept {
+        return std::hash<std::string_view>{}(s);
+      }
+    };
+    using Table = std::unordered_map<std::string, std::uint64_t, Hash,
+                                     std::equal_to<>>;
+
+    Table data_;
+    Table identities_;
+    std::unordered_map<std::uint64_t, std::string> identity_names_;
+  };
+
+  // A data node's SID, looked up once by an encoder. A node that is not in
+  // the map only fails when it is used: *ref throws std::invalid_argument
+  // naming the path, and it compares unequal to every SID.
+  class SidRef {
+  public:
+    SidRef(const SidMap &map, std::string path)
+        : sid_(map.data(path)), path_(std::move(path)) {}
+
+    std::uint64_t operator*() const {
+      if (!sid_)
+        throw std::invalid_argument("no SID for " + path_);
+      return *sid_;
+    }
+    bool operator==(std::uint64_t sid) const noexcept {
+      return sid_ && *sid_ == sid;
+    }
+    const std::string &path() const noexcept { return path_; }
+
+  private:
+    std::optional<std::uint64_t> sid_;
+    std::string path_;
+  };
+
+} // namespace yang
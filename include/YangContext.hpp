@@ -1,8 +1,20 @@
 #pragma once
 
+#include "ModuleIndex.hpp"
 #include "YangSchemaModule.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <libyang/libyang.h>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
 #include <vector>
 
 namespace yang {
@@ -90,36 +102,168 @@ namespace yang {
     return static_cast<unsigned>(o);
   }
 
+  // A module to load: {name, revision, features}. An empty revision selects
+  // the latest available revision; features is a nullptr-terminated array
+  // passed straight to libyang (nullptr keeps libyang's default).
+  using ModuleSpec = std::tuple<std::string, std::string, const char **>;
+
+  // Wall-clock timing of the phases of YangContext::loadModules().
+  struct ModuleLoadStats {
+    std::size_t modules = 0;
+    // locating and parsing every module (and its imports) from text
+    std::chrono::nanoseconds parse{0};
+    // the single ly_ctx_compile() pass over the whole context
+    std::chrono::nanoseconds compile{0};
+    std::chrono::nanoseconds total() const noexcept { return parse + compile; }
+  };
+
   class YangContext {
   public:
     YangContext(unsigned options = 0);
     explicit YangContext(struct ly_ctx *raw_ctx) noexcept;
+    // Adopt a context that lives in externally owned memory (e.g. a printed
+    // context mapped from a snapshot file). `storage` is released only after
+    // the context itself has been destroyed.
+    YangContext(struct ly_ctx *raw_ctx, std::shared_ptr<void> storage) noexcept;
     ~YangContext();
 
     YangContext(const YangContext &) = delete;
     YangContext &operator=(const YangContext &) = delete;
 
     void addSearchPath(const std::string &path);
+
+    // Resolve modules and imports through `index` (via the libyang module
+    // import callback) before falling back to the search directories. The
+    // context keeps the index alive.
+    void setModuleIndex(std::shared_ptr<const ModuleIndex> index);
+    const std::shared_ptr<const ModuleIndex> &moduleIndex() const noexcept {
+      return module_index_;
+    }
+
+    // Resolve modules from the sources compiled into the library (see
+    // embeddedModules()). Returns false, leaving the context untouched, when
+    // the library was built without YANG_EMBED_MODULES.
+    bool useEmbeddedModules();
     struct lys_module *loadModuleInContext(const std::string &name,
                                            const std::string &revision,
                                            const char **features = nullptr);
+
+    // Load a batch of modules with a single compilation: every module is
+    // parsed under LY_CTX_EXPLICIT_COMPILE and the context is compiled once
+    // at the end, instead of recompiling after each module. Throws
+    // YangDataError on the first module that fails to load or compile.
+    // When a module fails to load, the modules before it in the batch stay
+    // in the context, compiled; a failed batch can be retried once the
+    // cause is fixed (ensureModules() then loads only what is missing).
+    ModuleLoadStats loadModules(std::span<const ModuleSpec> modules);
+
+    // Load whichever of `modules` are not implemented in the context yet,
+    // as one loadModules() batch; a no-op once they all are. Serialized
+    // against other ensureModules() calls on this context. Compiling new
+    // modules may recompile the whole context and free the schema nodes
+    // that existing data trees point to, so only call this on a context
+    // that holds no data trees and has not been shared yet (shared lazy
+    // contexts are never extended; see Yang::getContextFor()).
+    ModuleLoadStats ensureModules(std::span<const ModuleSpec> modules);
+
+    // Timing of the most recent loadModules() call.
+    const ModuleLoadStats &lastLoadStats() const noexcept {
+      return load_stats_;
+    }
     const std::vector<std::string> &searchPaths() const noexcept {
       return search_paths_;
     }
 
     struct ly_ctx *raw() const noexcept { return ctx_; }
+    // LY_CTX_* options of the context; for an adopted (printed or
+    // attached) context, as libyang reports them
+    unsigned options() const noexcept { return options_; }
+
+    // True when the context was created from a printed (precompiled) image.
+    // Printed contexts are immutable: no modules can be loaded into them.
+    bool isPrinted() const noexcept { return storage_ != nullptr; }
 
     // (Removed) ModuleIterator helper - iteration is done directly via
     // libyang APIs in source to keep the header minimal.
 
-    // Find a loaded module by name; returns an empty YangSchemaModule if not
-    // found.
-    YangSchemaModule GetLoadedModuleByName(const std::string &name) const;
+    // Per-context cache of schema lookups for a serializer or parser: a `T`
+    // constructed from this context (T(const YangContext &)) on first use,
+    // typically holding resolved module and schema-node pointers. Rebuilt
+    // when the module set changes, like the module tables below. `T` is
+    // built outside the lock, so its constructor may use other caches.
+    template <typename T> std::shared_ptr<const T> schemaCache() const {
+      const Version version = currentVersion();
+      const std::type_index key(typeid(T));
+      {
+        std::lock_guard<std::mutex> lock(schema_cache_mutex_);
+        auto &slot = schema_caches_[key];
+        if (slot.value && slot.version == version)
+          return std::static_pointer_cast<const T>(slot.value);
+      }
+      auto fresh = std::make_shared<const T>(*this);
+      std::lock_guard<std::mutex> lock(schema_cache_mutex_);
+      auto &slot = schema_caches_[key];
+      // a concurrent caller may have stored one first; keep that
+      if (!slot.value || slot.version != version) {
+        slot.value = std::move(fresh);
+        slot.version = version;
+      }
+      return std::static_pointer_cast<const T>(slot.value);
+    }
+
+    // Module lookups return an empty YangSchemaModule if nothing matches.
+    // They are served from hash tables built from the module list on first
+    // use and rebuilt whenever the context changes (see currentVersion()),
+    // so each lookup is O(1).
+
+    // Find a loaded module by name. With several revisions loaded, the
+    // first in context order wins.
+    YangSchemaModule GetLoadedModuleByName(std::string_view name) const;
+    // Find a loaded module by name and revision; an empty revision matches
+    // a module loaded without one.
+    YangSchemaModule GetLoadedModule(std::string_view name,
+                                     std::string_view revision) const;
+    // Find the module defining XML namespace `ns`, preferring the
+    // implemented revision.
+    YangSchemaModule GetLoadedModuleByNamespace(std::string_view ns) const;
 
   private:
     struct ly_ctx *ctx_ = nullptr;
     std::vector<std::string> search_paths_;
     unsigned options_ = 0;
+    ModuleLoadStats load_stats_;
+    std::shared_ptr<const ModuleIndex> module_index_;
+    // Backing memory of a printed context. Members are destroyed after the
+    // destructor body has released ctx_, so the image outlives the context.
+    std::shared_ptr<void> storage_;
+    std::mutex ensure_mutex_;
+
+    // The caches are valid for one version of the module set: libyang's
+    // change count, which is only 16 bits wide and wraps, paired with a
+    // generation that every module load through this class bumps.
+    struct Version {
+      uint16_t change_count = 0;
+      uint64_t generation = 0;
+      bool operator==(const Version &) const = default;
+    };
+    Version currentVersion() const noexcept {
+      return {ctx_ ? ly_ctx_get_change_count(ctx_) : uint16_t{0},
+              generation_.load(std::memory_order_acquire)};
+    }
+    std::atomic<uint64_t> generation_{0};
+
+    struct ModuleCache;
+    // Current module tables; replaced as a whole when stale.
+    std::shared_ptr<const ModuleCache> moduleCache() const;
+    mutable std::atomic<std::shared_ptr<const ModuleCache>> module_cache_;
+
+    struct SchemaCacheSlot {
+      Version version;
+      std::shared_ptr<const void> value;
+    };
+    mutable std::mutex schema_cache_mutex_;
+    mutable std::unordered_map<std::type_index, SchemaCacheSlot>
+        schema_caches_;
   };
 
 } // namespace yang
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace yang {
+
+  // A set of contexts with the same compiled schema as a master context,
+  // for running parse/validate/serialize work on many threads at once.
+  //
+  // libyang contexts must not be used from several threads concurrently, so
+  // each worker leases a context of its own for the duration of its work
+  // and hands it back when the Lease goes out of scope. Contexts are created
+  // lazily, up to `capacity`, by printing the master's compiled schema into
+  // a private buffer (see clone()); no module is parsed or compiled again.
+  // acquire() blocks while every context is leased.
+  class YangContextPool {
+  public:
+    using Builder = std::function<std::shared_ptr<YangContext>()>;
+
+    class Lease {
+    public:
+      Lease() = default;
+      Lease(Lease &&other) noexcept;
+      Lease &operator=(Lease &&other) noexcept;
+      Lease(const Lease &) = delete;
+      Lease &operator=(const Lease &) = delete;
+      ~Lease();
+
+      YangContext &operator*() const noexcept { return *ctx_; }
+      YangContext *operator->() const noexcept { return ctx_.get(); }
+      YangContext *get() const noexcept { return ctx_.get(); }
+      explicit operator bool() const noexcept { return ctx_ != nullptr; }
+
+      // Return the context to the pool before the lease is destroyed.
+      void release() noexcept;
+
+    private:
+      friend class YangContextPool;
+      Lease(YangContextPool *pool, std::shared_ptr<YangContext> ctx) noexcept
+          : pool_(pool), ctx_(std::move(ctx)) {}
+
+      YangContextPool *pool_ = nullptr;
+      std::shared_ptr<YangContext> ctx_;
+    };
+
+    // `capacity` 0 means one context per hardware thread. `fallback` builds
+    // a context from scratch when the master cannot be cloned (e.g. libyang
+    // refuses to print it); without one, such a failure throws.
+    explicit YangContextPool(std::shared_ptr<YangContext> master,
+                             std::size_t capacity = 0, Builder fallback = {});
+    ~YangContextPool();
+
+    YangContextPool(const YangContextPool &) = delete;
+    YangContextPool &operator=(const YangContextPool &) = delete;
+
+    // Lease a context, creating one if none is idle and the pool is below
+    // capacity, else waiting for another thread to return one.
+    Lease acquire();
+    // Like acquire(), but returns an empty Lease instead of waiting.
+    Lease tryAcquire();
+
+    // Run `fn(YangContext &)` with a leased context and return its result.
+    template <typename Fn> decltype(auto) withContext(Fn &&fn) {
+      Lease lease = acquire();
+      return std::forward<Fn>(fn)(*lease);
+    }
+
+    const std::shared_ptr<YangContext> &master() const noexcept {
+      return master_;
+    }
+    std::size_t capacity() const noexcept { return capacity_; }
+    // Number of contexts created so far (leased or idle).
+    std::size_t size() const;
+
+    // A new, independent context with the compiled schema of `master`,
+    // made by printing it into a private buffer. Returns nullptr when
+    // libyang cannot print the context.
+    static std::shared_ptr<YangContext> clone(const YangContext &master);
+
+  private:
+    // Called with `lock` held and a context available or creatable.
+    Lease take(std::unique_lock<std::mutex> &lock);
+    void giveBack(std::shared_ptr<YangContext> ctx) noexcept;
+    std::shared_ptr<YangContext> create();
+
+    std::shared_ptr<YangContext> master_;
+    std::size_t capacity_;
+    Builder fallback_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<std::shared_ptr<YangContext>> idle_;
+    std::size_t created_ = 0;
+  };
+
+} // namespace yang
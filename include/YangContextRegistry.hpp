@@ -0,0 +1,53 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+namespace yang {
+
+  // Process-wide set of shared contexts, keyed by context options plus the
+  // module set loaded into them (see key()).
+  //
+  // Each key is built exactly once, even when many threads ask for it at the
+  // same time; a builder that throws leaves the key unset so the next caller
+  // retries. Once a context exists, get() only loads the key map and looks
+  // the key up: the map is copy-on-write and published through an atomic
+  // shared_ptr, so readers never wait on the insert mutex or on a build.
+  // (libstdc++ implements std::atomic<std::shared_ptr> with a small internal
+  // lock, so the loads themselves are not lock-free.)
+  class YangContextRegistry {
+  public:
+    using Builder = std::function<std::shared_ptr<YangContext>()>;
+
+    static YangContextRegistry &global();
+
+    static std::string key(unsigned options,
+                           std::span<const ModuleSpec> modules = {});
+
+    std::shared_ptr<YangContext> get(const std::string &key,
+                                     const Builder &build);
+
+    // Returns the context for `key` if it has been built, else nullptr.
+    std::shared_ptr<YangContext> find(const std::string &key) const;
+
+  private:
+    struct Slot {
+      std::once_flag once;
+      std::atomic<std::shared_ptr<YangContext>> ctx;
+    };
+    using SlotMap = std::unordered_map<std::string, std::shared_ptr<Slot>>;
+
+    std::shared_ptr<Slot> slot(const std::string &key) const;
+
+    std::atomic<std::shared_ptr<const SlotMap>> slots_{
+        std::make_shared<const SlotMap>()};
+    std::mutex insert_mutex_;
+  };
+
+} // namespace yang
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace yang {
+
+  // On-disk cache of a fully compiled libyang context.
+  //
+  // save() prints the compiled context (ly_ctx_compiled_print) into a
+  // versioned snapshot file; load() maps that file back at the address it
+  // was printed at and adopts it with ly_ctx_new_printed(), skipping YANG
+  // parsing and compilation entirely. A snapshot is rejected (load() returns
+  // nullptr) when its format version, fingerprint or the mtime of any YANG
+  // file the context was built from no longer matches. For a context that
+  // resolves modules through a ModuleIndex, the directories the index
+  // scanned count as well.
+  class YangContextSnapshot {
+  public:
+    // Bumped whenever the file layout changes.
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    YangContextSnapshot(std::string path, std::uint64_t fingerprint);
+
+    // Fingerprint of everything that determines the compiled schema apart
+    // from the YANG files themselves: context options, module list
+    // (including features), search paths, the libyang version and the
+    // digest of the modules embedded in the library (see
+    // embeddedModulesDigest()).
+    static std::uint64_t fingerprint(unsigned options,
+                                     const std::vector<ModuleSpec> &modules,
+                                     const std::vector<std::string> &paths);
+
+    // Returns the cached context, or nullptr if the snapshot is missing,
+    // stale or cannot be mapped at its original address.
+    std::shared_ptr<YangContext> load() const;
+
+    // Writes `ctx` to the snapshot file (atomically, via rename). Returns
+    // false if libyang cannot print the context or the file cannot be
+    // written; the caller keeps using `ctx` either way.
+    bool save(const YangContext &ctx) const;
+
+    const std::string &path() const noexcept { return path_; }
+
+  private:
+    std::string path_;
+    std::uint64_t fingerprint_ = 0;
+  };
+
+} // namespace yang
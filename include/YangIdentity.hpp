@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct lysc_ident;
+
+namespace yang {
+
+  class YangContext;
+
+  // Handle of a YANG identity, for the identityref fields of the models.
+  // "module:name" pairs are interned process-wide, so a handle is a single
+  // integer: comparing two is an integer compare, and the same identity has
+  // the same handle in every context (models move freely between the
+  // clones of a YangContextPool). A default-constructed handle names no
+  // identity.
+  //
+  //   static const YangIdentity kIpv4("ietf-routing", "ipv4");
+  //   if (rib.address_family == kIpv4) ...
+  class YangIdentity {
+  public:
+    YangIdentity() = default;
+    YangIdentity(std::string_view module, std::string_view name);
+
+    // "module:name", or a bare name of an identity defined in
+    // `default_module`.
+    static YangIdentity parse(std::string_view identity,
+                              std::string_view default_module);
+
+    // Both are empty for the empty handle. The strings are interned, so
+    // the views stay valid for the life of the process.
+    std::string_view module() const;
+    std::string_view name() const;
+    // "module:name", as used by JSON, lyd_new_path() and YANG-CBOR.
+    std::string qualified() const;
+
+    std::uint32_t id() const noexcept { return id_; }
+    explicit operator bool() const noexcept { return id_ != 0; }
+    friend bool operator==(YangIdentity, YangIdentity) = default;
+
+    // derived-from-or-self() against the schema of `ctx`. Served from the
+    // context's YangIdentityTable: a scan of a few integers.
+    bool derivedFrom(const YangContext &ctx, YangIdentity base) const;
+
+  private:
+    std::uint32_t id_ = 0;
+  };
+
+  // The identities of one context mapped to handles, with the transitive
+  // bases of each. Built once per context and module set:
+  //
+  //   auto ids = ctx.schemaCache<YangIdentityTable>();
+  //   rib.address_family = (*ids)[YangValue(node).identity()];
+  class YangIdentityTable {
+  public:
+    explicit YangIdentityTable(const YangContext &ctx);
+
+    // Handle of an identity of this context's schema, such as
+    // YangValue::identity(); empty for one this context does not define.
+    YangIdentity operator[](const struct lysc_ident *ident) const {
+      auto it = handles_.find(ident);
+      return it != handles_.end() ? it->second : YangIdentity();
+    }
+
+    // Schema identity behind `id`; nullptr when the context lacks it.
+    const struct lysc_ident *find(YangIdentity id) const;
+
+    // derived-from-or-self(): true when `id` is `base` or derives from it,
+    // directly or through other identities.
+    bool derivedFrom(YangIdentity id, YangIdentity base) const;
+
+    std::size_t size() const noexcept { return handles_.size(); }
+
+  private:
+    std::unordered_map<const struct lysc_ident *, YangIdentity> handles_;
+    std::unordered_map<std::uint32_t, const struct lysc_ident *> idents_;
+    std::unordered_map<std::uint32_t, std::vector<YangIdentity>> bases_;
+  };
+
+} // namespace yang
+
+template <> struct std::hash<yang::YangIdentity> {
+  std::size_t operator()(yang::YangIdentity id) const noexcept {
+    return std::hash<std::uint32_t>()(id.id());
+  }
+};
@@ -2,10 +2,15 @@
 
 #include "Exceptions.hpp"
 #include "YangContext.hpp"
+#include "YangContextPool.hpp"
+#include "YangReader.hpp"
+#include "YangWriter.hpp"
+#include <cstdlib>
 #include <libyang/libyang.h>
 #include <libyang/tree_data.h>
 #include <memory>
 #include <stdexcept>
+#include <string>
 
 namespace yang {
 
@@ -23,6 +28,25 @@ namespace yang {
     // Override this in derived classes.
     virtual struct lyd_node *serialize(const YangContext &ctx) const = 0;
 
+    // Stream this model through `writer` (see YangWriter) without building
+    // a data tree; emits the same data as serialize(). Models that do not
+    // support streaming throw std::logic_error.
+    virtual void write(YangWriter & /*writer*/) const {
+      throw std::logic_error("write not implemented for this YangModel");
+    }
+
+    // Convenience: stream this model to `out` as XML or JSON.
+    void print(const YangContext &ctx, YangOutput &out,
+               YangFormat format) const {
+      YangWriter writer(ctx, out, format);
+      write(writer);
+      writer.finish();
+    }
+
+    // Derived classes also declare the YANG modules their data lives in:
+    //   static std::span<const ModuleSpec> requiredModules();
+    // Yang::getContextFor<Derived>() loads exactly those on first use.
+
     // Static factory to create a model instance from a libyang data tree.
     // NOTE: static methods cannot be virtual in C++; derived classes should
     // provide their own `deserialize(const YangContext&, struct lyd_node*)`
@@ -36,17 +60,143 @@ namespace yang {
     // Convenience helper: parse an XML fragment into a libyang data tree using
     // the provided `YangContext`. On success returns the created `lyd_node*`.
     // On failure throws `YangDataError` constructed with `ctx`.
+    // `parse_flags` are libyang parse options (LYD_PARSE_*); the tree is
+    // validated unless they include LYD_PARSE_ONLY.
     static struct lyd_node *parseXml(const YangContext &ctx,
                                      const std::string &xml,
                                      uint32_t parse_flags = 0) {
       struct lyd_node *tree = nullptr;
-      LY_ERR rc = lyd_parse_data_mem(ctx.raw(), xml.c_str(), LYD_XML, 0,
-                                     parse_flags, &tree);
+      LY_ERR rc = lyd_parse_data_mem(ctx.raw(), xml.c_str(), LYD_XML,
+                                     parse_flags, 0, &tree);
       if (rc != LY_SUCCESS || tree == nullptr) {
         throw YangDataError(ctx);
       }
       return tree;
     }
+
+    // LYB (libyang binary) encoding: no text to escape or tokenize, and
+    // nodes are matched by schema hash instead of by name. `ctx` must have
+    // been created with YangContextOptions::LybHashes (the default context
+    // is); std::logic_error is thrown otherwise. parseLyb() expects a whole
+    // document as printed by printLyb() on a context with the same modules.
+    static struct lyd_node *parseLyb(const YangContext &ctx,
+                                     const std::string &lyb,
+                                     uint32_t parse_flags = 0) {
+      requireLybHashes(ctx);
+      struct ly_in *in = nullptr;
+      if (ly_in_new_memory(lyb.c_str(), &in) != LY_SUCCESS)
+        throw YangDataError(ctx);
+      struct lyd_node *tree = nullptr;
+      LY_ERR rc = lyd_parse_data(ctx.raw(), nullptr, in, LYD_LYB, parse_flags,
+                                 0, &tree);
+      ly_in_free(in, 0);
+      if (rc != LY_SUCCESS || tree == nullptr) {
+        lyd_free_all(tree);
+        throw YangDataError(ctx);
+      }
+      return tree;
+    }
+
+    // Print `tree` as LYB. Unlike lyd_print_mem() the output may contain NUL
+    // bytes, so it is sized from the ly_out.
+    static std::string printLyb(const YangContext &ctx,
+                                const struct lyd_node *tree,
+                                uint32_t print_flags = LYD_PRINT_WITHSIBLINGS) {
+      requireLybHashes(ctx);
+      char *buf = nullptr;
+      struct ly_out *out = nullptr;
+      if (ly_out_new_memory(&buf, 0, &out) != LY_SUCCESS)
+        throw YangDataError(ctx);
+      LY_ERR rc =
+          (print_flags & LYD_PRINT_WITHSIBLINGS)
+              ? lyd_print_all(out, tree, LYD_LYB,
+                              print_flags & ~LYD_PRINT_WITHSIBLINGS)
+              : lyd_print_tree(out, tree, LYD_LYB, print_flags);
+      const std::size_t len = ly_out_printed(out);
+      ly_out_free(out, nullptr, 0);
+      std::string lyb;
+      if (rc == LY_SUCCESS && buf)
+        lyb.assign(buf, len);
+      std::free(buf);
+      if (rc != LY_SUCCESS)
+        throw YangDataError(ctx);
+      return lyb;
+    }
+
+    // Parse `xml` and deserialize it into a `Model` on a context leased from
+    // `pool`; safe to call from many threads at once. The data tree is freed
+    // before the context goes back to the pool.
+    template <typename Model>
+    static std::unique_ptr<Model> fromXml(YangContextPool &pool,
+                                          const std::string &xml,
+                                          uint32_t parse_flags = 0) {
+      auto lease = pool.acquire();
+      return deserializeTree<Model>(*lease,
+                                    parseXml(*lease, xml, parse_flags));
+    }
+
+    // As fromXml(), for LYB produced by toLyb().
+    template <typename Model>
+    static std::unique_ptr<Model> fromLyb(YangContextPool &pool,
+                                          const std::string &lyb,
+                                          uint32_t parse_flags = 0) {
+      auto lease = pool.acquire();
+      return deserializeTree<Model>(*lease,
+                                    parseLyb(*lease, lyb, parse_flags));
+    }
+
+    // Serialize this model to XML on a context leased from `pool`.
+    std::string toXml(YangContextPool &pool,
+                      uint32_t print_flags = LYD_PRINT_WITHSIBLINGS) const {
+      auto lease = pool.acquire();
+      struct lyd_node *tree = serialize(*lease);
+      char *out = nullptr;
+      LY_ERR rc = lyd_print_mem(&out, tree, LYD_XML, print_flags);
+      lyd_free_all(tree);
+      if (rc != LY_SUCCESS) {
+        std::free(out);
+        throw YangDataError(*lease);
+      }
+      std::string xml = out ? out : "";
+      std::free(out);
+      return xml;
+    }
+
+    // Serialize this model to LYB on a context leased from `pool`.
+    std::string toLyb(YangContextPool &pool,
+                      uint32_t print_flags = LYD_PRINT_WITHSIBLINGS) const {
+      auto lease = pool.acquire();
+      struct lyd_node *tree = serialize(*lease);
+      try {
+        std::string lyb = printLyb(*lease, tree, print_flags);
+        lyd_free_all(tree);
+        return lyb;
+      } catch (...) {
+        lyd_free_all(tree);
+        throw;
+      }
+    }
+
+  private:
+    static void requireLybHashes(const YangContext &ctx) {
+      if (!(ly_ctx_get_options(ctx.raw()) & LY_CTX_LYB_HASHES))
+        throw std::logic_error(
+            "LYB needs a context created with YangContextOptions::LybHashes");
+    }
+
+    // Model::deserialize() on `tree`, which is freed either way.
+    template <typename Model>
+    static std::unique_ptr<Model> deserializeTree(const YangContext &ctx,
+                                                  struct lyd_node *tree) {
+      try {
+        auto model = Model::deserialize(ctx, tree);
+        lyd_free_all(tree);
+        return model;
+      } catch (...) {
+        lyd_free_all(tree);
+        throw;
+      }
+    }
   };
 
 } // namespace yang
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include "YangWriter.hpp"
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace yang {
+
+  // Source of streamed text: a string, a file descriptor or a callback.
+  // Input from an fd or callback is read through a fixed-size buffer, so
+  // memory use does not depend on the size of the document.
+  class YangInput {
+  public:
+    // Fills `buf` with up to `len` bytes; returns 0 at end of input.
+    using Callback = std::function<std::size_t(char *buf, std::size_t len)>;
+
+    // `data` is not copied and must outlive the input.
+    static YangInput fromString(std::string_view data);
+    // Reads `fd` (not closed); throws std::system_error on read errors.
+    static YangInput fromFd(int fd, std::size_t buffer_size = 64 * 1024);
+    static YangInput fromCallback(Callback cb,
+                                  std::size_t buffer_size = 64 * 1024);
+
+    YangInput(YangInput &&) noexcept = default;
+    YangInput &operator=(YangInput &&) = delete;
+
+    // Next byte, or -1 at end of input.
+    int get() {
+      if (pos_ == end_ && !refill())
+        return -1;
+      return static_cast<unsigned char>(*pos_++);
+    }
+    int peek() {
+      if (pos_ == end_ && !refill())
+        return -1;
+      return static_cast<unsigned char>(*pos_);
+    }
+
+  private:
+    YangInput() = default;
+    bool refill();
+
+    int fd_ = -1;
+    Callback cb_;
+    std::vector<char> buf_;
+    const char *pos_ = nullptr;
+    const char *end_ = nullptr;
+  };
+
+  // Pull parser for YANG instance data in XML or RFC 7951 JSON, the
+  // counterpart of YangWriter. It keeps only the path to the current node,
+  // never a data tree, so a model can be filled one list entry at a time.
+  //
+  // Nodes are visited depth-first. Inside a node opened at depth() == d:
+  //
+  //   while (reader.nextChild(d)) {
+  //     if (reader.name() == "mtu")
+  //       mtu = reader.text();           // leaf: consumes the node
+  //     else if (reader.name() == "address")
+  //       readAddress(reader);           // inner node: nextChild(d + 1)...
+  //   }                                  // anything else is skipped
+  //
+  // Use nextChild(0) for the top-level nodes. module() is the name of the
+  // node's module, resolved through the context (empty for an XML namespace
+  // the context does not know). Values are not checked against the schema.
+  // Syntax errors throw YangParseError.
+  class YangReader {
+  public:
+    YangReader(const YangContext &ctx, YangInput &in, YangFormat format);
+    // JSON without a context: member names carry their module, so nothing
+    // needs resolving. context() throws std::logic_error on such a reader.
+    explicit YangReader(YangInput &in);
+
+    YangReader(const YangReader &) = delete;
+    YangReader &operator=(const YangReader &) = delete;
+
+    // Advances to the next child of the node open at `level`, skipping what
+    // is left of the previous child. Returns false once that node is closed.
+    bool nextChild(std::size_t level);
+
+    // Number of open nodes; after nextChild(d) returns true this is d + 1.
+    std::size_t depth() const noexcept { return depth_; }
+    std::string_view module() const noexcept { return module_; }
+    std::string_view name() const noexcept { return name_; }
+
+    // Value of the current leaf (or leaf-list entry); consumes the node.
+    // The view is valid until the reader advances again.
+    std::string_view text();
+    // Value of the current identityref leaf as "module:identity", with the
+    // prefix (XML) or module name (JSON) of the value resolved.
+    std::string identity();
+
+    const YangContext &context() const;
+    std::size_t line() const noexcept { return line_; }
+    [[noreturn]] void fail(const std::string &what) const;
+
+  private:
+    enum class Event { Begin, Value, End, Done };
+    enum class Pending { None, Value, End };
+
+    struct XmlElement {
+      std::string qname;
+      std::size_t scope; // ns_scope_ size before the element's xmlns
+      bool children = false;
+    };
+    struct JsonFrame {
+      bool array;
+      bool node; // closing it ends a node (not the root, not an array)
+      std::string module;
+      std::string name;
+      bool first = true;
+    };
+
+    Event step();
+    Event advanceXml();
+    Event advanceJson();
+    void leafValue();
+
+    int get() {
+      int c = in_.get();
+      if (c == '\n')
+        ++line_;
+      return c;
+    }
+    void skipSpace();
+    void expect(char c);
+
+    void xmlStart();
+    void xmlName(std::string &out);
+    void xmlEntity(std::string &out);
+    void xmlSkipPast(std::string_view end, std::string *out = nullptr);
+    std::string_view xmlNamespace(std::string_view prefix) const;
+
+    Event jsonBegin(std::string module, std::string name);
+    void jsonString(std::string &out);
+    void jsonScalar(std::string &out);
+    void jsonSkipValue();
+
+    const YangContext *ctx_;
+    YangInput &in_;
+    YangFormat format_;
+    std::size_t depth_ = 0;
+    std::size_t line_ = 1;
+    Pending pending_ = Pending::None;
+    bool leaf_closed_ = false;
+    std::string module_;
+    std::string name_;
+    std::string text_;
+
+    std::vector<XmlElement> elements_;
+    std::vector<std::pair<std::string, std::string>> ns_scope_;
+
+    std::vector<JsonFrame> json_;
+    bool json_started_ = false;
+    std::string scratch_;
+  };
+
+} // namespace yang
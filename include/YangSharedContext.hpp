@@ -0,0 +1,85 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace yang {
+
+  // A compiled context published into shared memory, for prefork workers.
+  //
+  // publish() prints the compiled schema (ly_ctx_compiled_print) once into a
+  // memfd, or into a named POSIX shared memory object, and seals it against
+  // further writes where the platform allows. attach() maps the segment at
+  // the address it was printed at and adopts it with ly_ctx_new_printed():
+  // every attached process shares the same physical pages instead of
+  // compiling its own copy, and raw() works as usual. Attached contexts are
+  // printed contexts (see YangContext::isPrinted()); no modules can be
+  // loaded into them.
+  //
+  // Forked children inherit fd() and call attach(fd); unrelated processes
+  // use attach(name) on a segment created with publish(ctx, name).
+  class YangSharedContext {
+  public:
+    // Bumped whenever the segment layout changes.
+    static constexpr std::uint32_t kFormatVersion = 1;
+
+    YangSharedContext(YangSharedContext &&other) noexcept;
+    YangSharedContext &operator=(YangSharedContext &&other) noexcept;
+    YangSharedContext(const YangSharedContext &) = delete;
+    YangSharedContext &operator=(const YangSharedContext &) = delete;
+    // Closes the descriptor; attached contexts stay valid. A named segment
+    // remains until unlink().
+    ~YangSharedContext();
+
+    // Publish `ctx` into an anonymous segment (memfd where available).
+    // Throws YangDataError if libyang cannot print the context and
+    // std::system_error if the segment cannot be created.
+    static YangSharedContext publish(const YangContext &ctx);
+    // Publish `ctx` into the POSIX shared memory object `name` ("/..."),
+    // replacing any previous one.
+    static YangSharedContext publish(const YangContext &ctx,
+                                     const std::string &name);
+    // Remove the named segment; processes already attached are unaffected.
+    static bool unlink(const std::string &name);
+
+    // Returns the shared context, or nullptr when `fd`/`name` is not a
+    // published segment or its address range is taken in this process.
+    static std::shared_ptr<YangContext> attach(int fd);
+    static std::shared_ptr<YangContext> attach(const std::string &name);
+
+    int fd() const noexcept { return fd_; }
+    const std::string &name() const noexcept { return name_; }
+    // Bytes of compiled schema in the segment.
+    std::size_t imageSize() const noexcept { return image_size_; }
+
+  private:
+    YangSharedContext(int fd, std::string name, std::size_t image_size)
+        : fd_(fd), name_(std::move(name)), image_size_(image_size) {}
+
+    static YangSharedContext publishTo(const YangContext &ctx, int fd,
+                                       std::string name);
+
+    int fd_ = -1;
+    std::string name_;
+    std::size_t image_size_ = 0;
+  };
+
+  // Memory of the calling process, in bytes. On Linux the figures come from
+  // /proc/self/smaps_rollup: `pss` charges shared pages proportionally to
+  // each process mapping them, which is the number that shrinks when workers
+  // attach a YangSharedContext. Elsewhere only `rss` (the peak RSS from
+  // getrusage) is filled in.
+  struct ProcessMemoryUsage {
+    std::size_t rss = 0;
+    std::size_t pss = 0;
+    std::size_t shared = 0;
+    std::size_t private_ = 0;
+
+    static ProcessMemoryUsage current();
+  };
+
+} // namespace yang
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <libyang/libyang.h>
+#include <libyang/tree_data.h>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace yang {
+
+  // Typed view of a leaf's or leaf-list entry's value, read straight from
+  // lyd_node_term::value: libyang has parsed and validated it already, so
+  // nothing is printed to a canonical string and converted back.
+  //
+  //   ip.mtu = YangValue(node).as<uint32_t>();
+  //
+  // Union values are unwrapped to the member type that matched. Reading a
+  // value as a type it does not have, or an integer out of the range of
+  // `T`, throws std::invalid_argument.
+  class YangValue {
+  public:
+    explicit YangValue(const struct lyd_node *term) : node_(term) {
+      if (!term || !term->schema ||
+          !(term->schema->nodetype & (LYS_LEAF | LYS_LEAFLIST)))
+        throw std::invalid_argument("YangValue: not a leaf or leaf-list");
+      value_ = &reinterpret_cast<const struct lyd_node_term *>(term)->value;
+      while (value_->realtype->basetype == LY_TYPE_UNION)
+        value_ = &value_->subvalue->value;
+    }
+
+    LY_DATA_TYPE type() const noexcept { return value_->realtype->basetype; }
+
+    // Integer types; also booleans (0/1), enumerations (their value) and
+    // decimal64 (the raw value, scaled by 10^fraction-digits).
+    template <typename T>
+      requires std::is_integral_v<T> && (!std::is_same_v<T, bool>)
+    T as() const {
+      switch (type()) {
+      case LY_TYPE_UINT8:
+        return narrow<T>(value_->uint8);
+      case LY_TYPE_UINT16:
+        return narrow<T>(value_->uint16);
+      case LY_TYPE_UINT32:
+        return narrow<T>(value_->uint32);
+      case LY_TYPE_UINT64:
+        return narrow<T>(value_->uint64);
+      case LY_TYPE_INT8:
+        return narrow<T>(value_->int8);
+      case LY_TYPE_INT16:
+        return narrow<T>(value_->int16);
+      case LY_TYPE_INT32:
+        return narrow<T>(value_->int32);
+      case LY_TYPE_INT64:
+        return narrow<T>(value_->int64);
+      case LY_TYPE_DEC64:
+        return narrow<T>(value_->dec64);
+      case LY_TYPE_BOOL:
+        return narrow<T>(value_->boolean);
+      case LY_TYPE_ENUM:
+        return narrow<T>(value_->enum_item->value);
+      default:
+        mismatch("an integer");
+      }
+    }
+
+    bool asBool() const {
+      if (type() != LY_TYPE_BOOL)
+        mismatch("a boolean");
+      return value_->boolean != 0;
+    }
+
+    // Name of an enumeration value; stored in the schema, so it lives as
+    // long as the context.
+    std::string_view enumName() const {
+      if (type() != LY_TYPE_ENUM)
+        mismatch("an enumeration");
+      return value_->enum_item->name;
+    }
+
+    // Identity of an identityref, from the context's schema.
+    const struct lysc_ident *identity() const {
+      if (type() != LY_TYPE_IDENT)
+        mismatch("an identityref");
+      return value_->ident;
+    }
+    // Its name without the module.
+    std::string_view identityName() const { return identity()->name; }
+    // "module:name", as used by JSON and lyd_new_term().
+    std::string qualifiedIdentity() const {
+      const struct lysc_ident *id = identity();
+      return std::string(id->module->name) + ':' + id->name;
+    }
+
+    // Decoded bytes of a binary leaf; valid as long as the data node.
+    std::span<const std::byte> binary() const {
+      if (type() != LY_TYPE_BINARY)
+        mismatch("binary");
+      // LYD_VALUE_GET(), minus the void * conversion C++ does not allow
+      const void *mem = sizeof(struct lyd_value_binary) >
+                                LYD_VALUE_FIXED_MEM_SIZE
+                            ? value_->dyn_mem
+                            : static_cast<const void *>(value_->fixed_mem);
+      const auto *bin = static_cast<const struct lyd_value_binary *>(mem);
+      return {static_cast<const std::byte *>(bin->data), bin->size};
+    }
+
+    // Canonical string of any type (lyd_get_value()): stored for strings,
+    // printed on first use and cached by libyang for the others.
+    std::string_view canonical() const {
+      const char *s = lyd_get_value(node_);
+      return s ? s : "";
+    }
+
+    const struct lyd_value *raw() const noexcept { return value_; }
+
+  private:
+    template <typename T, typename V> static T narrow(V v) {
+      if (!std::in_range<T>(v))
+        throw std::invalid_argument("YangValue: " + std::to_string(v) +
+                                    " is out of range");
+      return static_cast<T>(v);
+    }
+
+    [[noreturn]] void mismatch(const char *wanted) const {
+      throw std::invalid_argument(std::string("YangValue: value is not ") +
+                                  wanted);
+    }
+
+    const struct lyd_node *node_;
+    const struct lyd_value *value_;
+  };
+
+} // namespace yang
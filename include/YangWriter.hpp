@@ -0,0 +1,171 @@
+#pragma once
+
+#include "YangContext.hpp"
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace yang {
+
+  enum class YangFormat { Xml, Json };
+
+  // Destination of streamed text: a string, a file descriptor or a
+  // callback. Output to an fd or callback goes through a fixed-size buffer,
+  // so memory use does not depend on the size of the document.
+  class YangOutput {
+  public:
+    using Callback = std::function<void(std::string_view)>;
+
+    static YangOutput toString(std::string &out);
+    // Writes to `fd` (not closed); throws std::system_error on write errors.
+    static YangOutput toFd(int fd, std::size_t buffer_size = 64 * 1024);
+    static YangOutput toCallback(Callback cb,
+                                 std::size_t buffer_size = 64 * 1024);
+
+    YangOutput(YangOutput &&) noexcept = default;
+    YangOutput &operator=(YangOutput &&) = delete;
+    // Flushes; errors at this point are dropped, call flush() to see them.
+    ~YangOutput();
+
+    void write(std::string_view s) {
+      if (str_) {
+        str_->append(s);
+        return;
+      }
+      if (buf_.size() + s.size() > limit_)
+        flush();
+      if (s.size() > limit_)
+        emit(s);
+      else
+        buf_.append(s);
+    }
+    void put(char c) {
+      if (str_) {
+        str_->push_back(c);
+        return;
+      }
+      if (buf_.size() >= limit_)
+        flush();
+      buf_.push_back(c);
+    }
+    void flush();
+
+  private:
+    YangOutput() = default;
+    void emit(std::string_view s);
+
+    std::string *str_ = nullptr;
+    int fd_ = -1;
+    Callback cb_;
+    std::string buf_;
+    std::size_t limit_ = 0;
+  };
+
+  // The C++ types of the YANG integer types int8 ... uint64.
+  template <typename T>
+  concept YangInteger =
+      std::same_as<T, std::int8_t> || std::same_as<T, std::int16_t> ||
+      std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t> ||
+      std::same_as<T, std::uint8_t> || std::same_as<T, std::uint16_t> ||
+      std::same_as<T, std::uint32_t> || std::same_as<T, std::uint64_t>;
+
+  // Streams YANG instance data as XML or RFC 7951 JSON straight from C++
+  // values, without building a libyang data tree.
+  //
+  // Callers emit nodes in schema order, naming each node's module; the
+  // writer takes namespaces and prefixes from the context and qualifies
+  // names the way lyd_print() does (an xmlns attribute, or a "module:"
+  // member prefix, wherever the module changes). Several top-level nodes
+  // may be written in a row. Output is compact, like LYD_PRINT_SHRINK.
+  // Node names are schema identifiers and are referenced, not copied, until
+  // their node is closed: pass string literals.
+  class YangWriter {
+  public:
+    YangWriter(const YangContext &ctx, YangOutput &out, YangFormat format);
+    // Calls finish() if the caller did not.
+    ~YangWriter();
+
+    YangWriter(const YangWriter &) = delete;
+    YangWriter &operator=(const YangWriter &) = delete;
+
+    void beginContainer(std::string_view module, std::string_view name);
+    void endContainer();
+
+    // A list (or leaf-list) with its entries between beginList()/endList().
+    void beginList(std::string_view module, std::string_view name);
+    void beginEntry();
+    void endEntry();
+    void endList();
+
+    // Leaf with a string-like value (string, date-and-time, inet types...).
+    void leaf(std::string_view module, std::string_view name,
+              std::string_view value);
+    void leaf(std::string_view module, std::string_view name,
+              const char *value) {
+      leaf(module, name, std::string_view(value));
+    }
+    void leaf(std::string_view module, std::string_view name, bool value);
+    // Integer leaf. JSON quotes int64 and uint64 values and no others (RFC
+    // 7951 6.1), and the writer does not look up the leaf's type: pass
+    // std::int64_t / std::uint64_t exactly for int64 / uint64 leaves, and
+    // a fixed-width type of at most 32 bits that holds the value range for
+    // every other integer leaf.
+    template <YangInteger T>
+    void leaf(std::string_view module, std::string_view name, T value) {
+      number(module, name, std::to_string(value),
+             std::same_as<T, std::int64_t> || std::same_as<T, std::uint64_t>);
+    }
+    // Leaf of type empty.
+    void empty(std::string_view module, std::string_view name);
+    // identityref leaf. `identity` is "module:name", or a bare name of an
+    // identity defined in `default_module`.
+    void identity(std::string_view module, std::string_view name,
+                  std::string_view identity, std::string_view default_module);
+    // leaf-list of strings
+    void leafList(std::string_view module, std::string_view name,
+                  std::span<const std::string> values);
+
+    // Closes the document (JSON: the top-level object) and flushes.
+    void finish();
+
+    const YangContext &context() const noexcept { return ctx_; }
+
+  private:
+    enum class Frame { Container, List, Entry };
+    struct Level {
+      Frame frame;
+      std::string_view module;
+      std::string_view name;
+      bool first = true; // JSON: no member written yet
+    };
+    struct ModuleInfo {
+      std::string_view name;
+      std::string_view ns;
+      std::string_view prefix;
+    };
+
+    ModuleInfo moduleInfo(std::string_view module);
+    // module of the closest enclosing element (XML) / object (JSON)
+    std::string_view parentModule() const;
+    void jsonMember(std::string_view module, std::string_view name);
+    void xmlOpen(std::string_view module, std::string_view name);
+    void xmlClose(std::string_view name);
+    void number(std::string_view module, std::string_view name,
+                const std::string &digits, bool quoted_in_json);
+    void escaped(std::string_view s, bool attribute);
+
+    const YangContext &ctx_;
+    YangOutput &out_;
+    YangFormat format_;
+    std::vector<Level> stack_;
+    std::vector<ModuleInfo> modules_;
+    bool top_first_ = true;
+    bool finished_ = false;
+  };
+
+} // namespace yang
@@ -0,0 +1,237 @@
+#include "Cbor.hpp"
+#include "Exceptions.hpp"
+
+#include <limits>
+
+using namespace yang;
+
+void CborWriter::head(unsigned major, std::uint64_t v) {
+  const auto m = static_cast<unsigned char>(major << 5);
+  if (v < 24) {
+    out_.put(static_cast<char>(m | v));
+    return;
+  }
+  int bytes;
+  if (v <= 0xff) {
+    out_.put(static_cast<char>(m | 24));
+    bytes = 1;
+  } else if (v <= 0xffff) {
+    out_.put(static_cast<char>(m | 25));
+    bytes = 2;
+  } else if (v <= 0xffffffff) {
+    out_.put(static_cast<char>(m | 26));
+    bytes = 4;
+  } else {
+    out_.put(static_cast<char>(m | 27));
+    bytes = 8;
+  }
+  for (int i = bytes - 1; i >= 0; --i)
+    out_.put(static_cast<char>((v >> (8 * i)) & 0xff));
+}
+
+void CborWriter::identity(const SidMap &sids,
+                          std::string_view qualified_name) {
+  if (auto sid = sids.identity(qualified_name))
+    unsignedInt(*sid);
+  else
+    text(qualified_name);
+}
+
+void CborReader::fail(const std::string &what) const {
+  throw YangParseError("CBOR byte " + std::to_string(offset_) + ": " + what);
+}
+
+int CborReader::byte() {
+  int c = in_.get();
+  if (c < 0)
+    fail("unexpected end of input");
+  ++offset_;
+  return c;
+}
+
+std::uint64_t CborReader::readArgument(unsigned info) {
+  if (info < 24)
+    return info;
+  int bytes;
+  switch (info) {
+  case 24:
+    bytes = 1;
+    break;
+  case 25:
+    bytes = 2;
+    break;
+  case 26:
+    bytes = 4;
+    break;
+  case 27:
+    bytes = 8;
+    break;
+  default:
+    fail("reserved additional information " + std::to_string(info));
+  }
+  std::uint64_t v = 0;
+  for (int i = 0; i < bytes; ++i)
+    v = (v << 8) | static_cast<unsigned>(byte());
+  return v;
+}
+
+CborReader::Type CborReader::next() {
+  tag_ = -1;
+  for (;;) {
+    if (in_.peek() < 0)
+      return type_ = Type::End;
+    const int initial = byte();
+    const unsigned major = static_cast<unsigned>(initial) >> 5;
+    const unsigned info = static_cast<unsigned>(initial) & 0x1f;
+
+    indefinite_ = info == 31;
+    if (indefinite_ && (major < 2 || major == 6))
+      fail("indefinite length on a major type without one");
+    if (indefinite_ && major == 7)
+      fail("unexpected break");
+    arg_ = indefinite_ ? 0 : readArgument(info);
+
+    switch (major) {
+    case 0:
+      return type_ = Type::Unsigned;
+    case 1:
+      return type_ = Type::Negative;
+    case 2:
+      return type_ = Type::Bytes;
+    case 3:
+      return type_ = Type::Text;
+    case 4:
+      return type_ = Type::Array;
+    case 5:
+      return type_ = Type::Map;
+    case 6:
+      // YANG-CBOR tags (43-47) only qualify the value that follows
+      tag_ = static_cast<std::int64_t>(arg_);
+      continue;
+    default:
+      return type_ = info >= 25 && info <= 27 ? Type::Float : Type::Simple;
+    }
+  }
+}
+
+bool CborReader::more(Container &c) {
+  if (c.indefinite) {
+    if (in_.peek() == 0xff) {
+      byte();
+      return false;
+    }
+    return true;
+  }
+  if (c.left == 0)
+    return false;
+  --c.left;
+  return true;
+}
+
+std::string_view CborReader::payload() {
+  if (type_ != Type::Text && type_ != Type::Bytes)
+    fail("not a string");
+  payload_.clear();
+  auto append = [this](std::uint64_t len) {
+    for (std::uint64_t i = 0; i < len; ++i)
+      payload_.push_back(static_cast<char>(byte()));
+  };
+  if (!indefinite_) {
+    append(arg_);
+    return payload_;
+  }
+  // indefinite: definite chunks of the same major type up to a break
+  const unsigned major = type_ == Type::Text ? 3 : 2;
+  for (;;) {
+    const int initial = byte();
+    if (initial == 0xff)
+      return payload_;
+    if (static_cast<unsigned>(initial) >> 5 != major ||
+        (initial & 0x1f) == 31)
+      fail("bad chunk in an indefinite-length string");
+    append(readArgument(static_cast<unsigned>(initial) & 0x1f));
+  }
+}
+
+void CborReader::skipCurrent() {
+  switch (type_) {
+  case Type::Bytes:
+  case Type::Text:
+    payload();
+    break;
+  case Type::Array:
+  case Type::Map: {
+    if (depth_ == kMaxSkipDepth)
+      fail("arrays and maps nested too deeply");
+    struct Nest {
+      unsigned &depth;
+      ~Nest() { --depth; }
+    } nest{++depth_};
+    const bool map = type_ == Type::Map;
+    Container c = container();
+    while (more(c)) {
+      skip();
+      if (map)
+        skip();
+    }
+    break;
+  }
+  case Type::End:
+    fail("unexpected end of input");
+  default:
+    break;
+  }
+}
+
+CborReader::Container CborReader::expectArray() {
+  if (next() != Type::Array)
+    fail("expected an array");
+  return container();
+}
+
+CborReader::Container CborReader::expectMap() {
+  if (next() != Type::Map)
+    fail("expected a map");
+  return container();
+}
+
+std::uint64_t CborReader::readUnsigned() {
+  if (next() != Type::Unsigned)
+    fail("expected an unsigned integer");
+  return arg_;
+}
+
+std::int64_t CborReader::readInteger() {
+  const Type t = next();
+  if (t != Type::Unsigned && t != Type::Negative)
+    fail("expected an integer");
+  constexpr auto max = std::numeric_limits<std::int64_t>::max();
+  if (arg_ > static_cast<std::uint64_t>(max))
+    fail("integer out of range");
+  const auto v = static_cast<std::int64_t>(arg_);
+  return t == Type::Unsigned ? v : -1 - v;
+}
+
+std::string_view CborReader::readText() {
+  if (next() != Type::Text)
+    fail("expected a text string");
+  return payload();
+}
+
+bool CborReader::readBool() {
+  if (next() != Type::Simple || (arg_ != 20 && arg_ != 21))
+    fail("expected a boolean");
+  return arg_ == 21;
+}
+
+std::string CborReader::readIdentity(const SidMap &sids) {
+  const Type t = next();
+  if (t == Type::Text)
+    return std::string(payload());
+  if (t != Type::Unsigned)
+    fail("expected an identityref");
+  const std::string *name = sids.identityName(arg_);
+  if (!name)
+    fail("unknown identity SID " + std::to_string(arg_));
+  return *name;
+}
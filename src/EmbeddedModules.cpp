@@ -0,0 +1,61 @@
+#include "EmbeddedModules.hpp"
+
+using namespace yang;
+
+#if defined(YANG_EMBEDDED_MODULES)
+// Defines kEmbeddedModuleTable; generated by cmake/EmbedYangModules.cmake.
+#include "EmbeddedModulesData.inc"
+static constexpr std::span<const EmbeddedModule> kModules{
+    kEmbeddedModuleTable};
+#else
+static constexpr std::span<const EmbeddedModule> kModules{};
+static constexpr std::string_view kEmbeddedModuleDigest{};
+#endif
+
+std::span<const EmbeddedModule> yang::embeddedModules() noexcept {
+  return kModules;
+}
+
+std::string_view yang::embeddedModulesDigest() noexcept {
+  return kEmbeddedModuleDigest;
+}
+
+const EmbeddedModule *
+yang::findEmbeddedModule(std::string_view name,
+                         std::string_view revision) noexcept {
+  const EmbeddedModule *best = nullptr;
+  const EmbeddedModule *undated = nullptr;
+  for (const auto &m : kModules) {
+    if (m.name != name)
+      continue;
+    if (m.revision.empty())
+      undated = &m;
+    if (!revision.empty()) {
+      if (m.revision == revision)
+        return &m;
+      continue;
+    }
+    if (!best || m.revision > best->revision)
+      best = &m;
+  }
+  // a file without "@revision" may still hold the requested revision;
+  // libyang checks the revision statement itself
+  return best ? best : undated;
+}
+
+LY_ERR yang::embeddedModuleImportCallback(
+    const char *mod_name, const char *mod_rev, const char *submod_name,
+    const char *submod_rev, void * /*user_data*/, LYS_INFORMAT *format,
+    const char **module_data, ly_module_imp_data_free_clb *free_module_data) {
+  const char *name = submod_name ? submod_name : mod_name;
+  const char *rev = submod_name ? submod_rev : mod_rev;
+  const EmbeddedModule *m =
+      findEmbeddedModule(name ? name : "", rev ? rev : "");
+  if (!m)
+    return LY_ENOTFOUND;
+  // static data: nothing to free
+  *format = LYS_IN_YANG;
+  *module_data = m->text.data();
+  *free_module_data = nullptr;
+  return LY_SUCCESS;
+}
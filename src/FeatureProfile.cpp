@@ -0,0 +1,98 @@
+#include "FeatureProfile.hpp"
+
+#include <libyang/libyang.h>
+#include <unordered_map>
+
+using namespace yang;
+
+FeatureProfile::FeatureProfile(
+    std::initializer_list<std::pair<std::string, std::vector<std::string>>>
+        modules) {
+  for (const auto &[name, features] : modules) {
+    Entry &e = modules_[name];
+    e.names = features;
+    link(e);
+  }
+}
+
+FeatureProfile::FeatureProfile(const FeatureProfile &other)
+    : modules_(other.modules_) {
+  for (auto &[name, e] : modules_)
+    link(e);
+}
+
+FeatureProfile &FeatureProfile::operator=(const FeatureProfile &other) {
+  if (this != &other) {
+    modules_ = other.modules_;
+    for (auto &[name, e] : modules_)
+      link(e);
+  }
+  return *this;
+}
+
+// Point `c_names` at the strings of this entry (copies must not keep
+// pointing into the original).
+void FeatureProfile::link(Entry &e) {
+  e.c_names.clear();
+  for (const auto &n : e.names)
+    e.c_names.push_back(n.c_str());
+  e.c_names.push_back(nullptr);
+}
+
+const char **FeatureProfile::features(const std::string &module) const {
+  auto it = modules_.find(module);
+  if (it == modules_.end())
+    return nullptr;
+  return const_cast<const char **>(it->second.c_names.data());
+}
+
+std::vector<ModuleSpec>
+FeatureProfile::apply(std::span<const ModuleSpec> modules) const {
+  std::vector<ModuleSpec> out(modules.begin(), modules.end());
+  for (auto &m : out) {
+    if (const char **f = features(std::get<0>(m)))
+      std::get<2>(m) = f;
+  }
+  return out;
+}
+
+SchemaReport SchemaReport::of(const YangContext &ctx) {
+  SchemaReport report;
+  if (!ctx.raw())
+    return report;
+
+  std::unordered_map<const struct lys_module *, std::size_t> slot;
+  uint32_t idx = 0;
+  const struct lys_module *m = nullptr;
+  while ((m = ly_ctx_get_module_iter(ctx.raw(), &idx)) != nullptr) {
+    if (!m->implemented)
+      continue;
+    slot.emplace(m, report.modules.size());
+    report.modules.push_back({m->name ? m->name : "",
+                              m->revision ? m->revision : "", 0});
+  }
+
+  struct Walk {
+    SchemaReport *report;
+    std::unordered_map<const struct lys_module *, std::size_t> *slot;
+  } walk{&report, &slot};
+  auto count = [](struct lysc_node *node, void *data,
+                  ly_bool * /*dfs_continue*/) -> LY_ERR {
+    auto *w = static_cast<Walk *>(data);
+    ++w->report->total_nodes;
+    auto it = w->slot->find(node->module);
+    if (it != w->slot->end())
+      ++w->report->modules[it->second].nodes;
+    return LY_SUCCESS;
+  };
+  idx = 0;
+  while ((m = ly_ctx_get_module_iter(ctx.raw(), &idx)) != nullptr) {
+    if (m->implemented && m->compiled)
+      (void)lysc_module_dfs_full(m, count, &walk);
+  }
+
+  int size = 0;
+  if (ly_ctx_compiled_size(ctx.raw(), &size) == LY_SUCCESS && size > 0)
+    report.compiled_bytes = static_cast<std::size_t>(size);
+  return report;
+}
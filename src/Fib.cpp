@@ -0,0 +1,171 @@
+#include "Fib.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+
+using namespace yang;
+using detail::LpmTrie;
+
+std::size_t LpmTrie::child(std::uint32_t *slot) {
+  if (*slot & kChild)
+    return *slot & ~kChild;
+  // the new table inherits the slot's route; set the slot before growing
+  // tables_, which may be where it lives
+  const std::uint32_t inherited = *slot;
+  const std::size_t table = tables_.size() / 256;
+  if (table >= kChild)
+    throw std::length_error("Fib: too many tables");
+  *slot = kChild | static_cast<std::uint32_t>(table);
+  tables_.resize(tables_.size() + 256, inherited);
+  return table;
+}
+
+void LpmTrie::insert(const std::uint8_t *address, unsigned length,
+                     std::uint32_t value) {
+  if (length > bytes_ * 8)
+    throw std::invalid_argument("Fib: prefix length out of range");
+  if (value > kMaxValue)
+    throw std::invalid_argument("Fib: value out of range");
+  if (first_.empty())
+    first_.assign(std::size_t(1) << (8 * first_bytes_), 0);
+  const std::uint32_t entry = value + 1;
+
+  const unsigned first_bits = 8 * first_bytes_;
+  if (length <= first_bits) {
+    const std::size_t span = std::size_t(1) << (first_bits - length);
+    const std::size_t start = firstIndex(address) & ~(span - 1);
+    std::fill_n(first_.begin() + start, span, entry);
+    return;
+  }
+
+  std::uint32_t *slot = &first_[firstIndex(address)];
+  for (unsigned i = first_bytes_, consumed = first_bits;; ++i, consumed += 8) {
+    const std::size_t table = child(slot) * 256;
+    const unsigned remaining = length - consumed;
+    if (remaining <= 8) {
+      const std::size_t span = std::size_t(1) << (8 - remaining);
+      const std::size_t start = address[i] & ~(span - 1);
+      std::fill_n(tables_.begin() + table + start, span, entry);
+      return;
+    }
+    slot = &tables_[table + address[i]];
+  }
+}
+
+namespace {
+
+  template <typename Prefix>
+  std::size_t build(LpmTrie &trie, std::vector<Fib::Entry<Prefix>> entries) {
+    // shortest first; equal prefixes keep their order, so the last wins
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto &a, const auto &b) {
+                       return std::tie(a.prefix.length, a.prefix.address) <
+                              std::tie(b.prefix.length, b.prefix.address);
+                     });
+    std::size_t prefixes = 0;
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+      const auto &e = entries[i];
+      prefixes += i == 0 || !(entries[i - 1].prefix == e.prefix);
+      trie.insert(e.prefix.address.bytes.data(), e.prefix.length, e.value);
+    }
+    trie.shrink();
+    return prefixes;
+  }
+
+  template <typename Address>
+  void lookupAll(const LpmTrie &trie, std::span<const Address> in,
+                 std::span<std::uint32_t> out) {
+    // far enough ahead to cover a miss, near enough to stay in cache
+    constexpr std::size_t kAhead = 8;
+    const std::size_t n = std::min(in.size(), out.size());
+    for (std::size_t i = 0; i < n; ++i) {
+      if (i + kAhead < n)
+        trie.prefetch(in[i + kAhead].bytes.data());
+      out[i] = trie.lookup(in[i].bytes.data());
+    }
+  }
+
+  // The routes of a RIB that have a destination prefix. sort() puts the
+  // preferred route of each prefix last, where build() keeps it.
+  struct Candidates {
+    std::vector<Fib::Entry<Ipv4Prefix>> ipv4;
+    std::vector<Fib::Entry<Ipv6Prefix>> ipv6;
+    // per route: (not active, preference); lower is preferred
+    std::vector<std::pair<bool, std::uint32_t>> ranks;
+
+    explicit Candidates(std::size_t routes) : ranks(routes) {}
+
+    void rank(std::uint32_t route, bool active,
+              std::optional<std::uint32_t> preference) {
+      ranks[route] = {!active, preference.value_or(~0u)};
+    }
+
+    void sort() {
+      auto order = [&](const auto &a, const auto &b) {
+        if (!(a.prefix == b.prefix))
+          return a.prefix < b.prefix;
+        // the better route, then the earlier one, sorts last
+        return std::tie(ranks[b.value], b.value) <
+               std::tie(ranks[a.value], a.value);
+      };
+      std::sort(ipv4.begin(), ipv4.end(), order);
+      std::sort(ipv6.begin(), ipv6.end(), order);
+    }
+  };
+
+} // namespace
+
+Fib::Fib(std::span<const Entry<Ipv4Prefix>> ipv4,
+         std::span<const Entry<Ipv6Prefix>> ipv6) {
+  ipv4_routes_ = build(ipv4_, std::vector(ipv4.begin(), ipv4.end()));
+  ipv6_routes_ = build(ipv6_, std::vector(ipv6.begin(), ipv6.end()));
+}
+
+Fib::Fib(const IetfRouting::Rib &rib) {
+  Candidates c(rib.routes.size());
+  for (std::uint32_t i = 0; i < rib.routes.size(); ++i) {
+    const auto &r = rib.routes[i];
+    c.rank(i, r.metadata && r.metadata->active, r.route_preference);
+    if (const auto *p = std::get_if<Ipv4Prefix>(&r.destination_prefix))
+      c.ipv4.push_back({*p, i});
+    else if (const auto *p = std::get_if<Ipv6Prefix>(&r.destination_prefix))
+      c.ipv6.push_back({*p, i});
+  }
+  c.sort();
+  ipv4_routes_ = build(ipv4_, std::move(c.ipv4));
+  ipv6_routes_ = build(ipv6_, std::move(c.ipv6));
+}
+
+Fib::Fib(const RouteStore &store) {
+  Candidates c(store.size());
+  for (std::uint32_t i = 0; i < store.size(); ++i) {
+    const auto &rec = store[i];
+    c.rank(i, rec.present & RouteStore::kActive,
+           rec.present & RouteStore::kPreference
+               ? std::optional(rec.preference)
+               : std::nullopt);
+    if (rec.family == 4) {
+      Ipv4Prefix p;
+      std::copy_n(rec.prefix.begin(), 4, p.address.bytes.begin());
+      p.length = rec.prefix_length;
+      c.ipv4.push_back({p, i});
+    } else if (rec.family == 6) {
+      c.ipv6.push_back({{{rec.prefix}, rec.prefix_length}, i});
+    }
+  }
+  c.sort();
+  ipv4_routes_ = build(ipv4_, std::move(c.ipv4));
+  ipv6_routes_ = build(ipv6_, std::move(c.ipv6));
+}
+
+void Fib::lookup(std::span<const Ipv4Address> in,
+                 std::span<std::uint32_t> out) const noexcept {
+  lookupAll(ipv4_, in, out);
+}
+
+void Fib::lookup(std::span<const Ipv6Address> in,
+                 std::span<std::uint32_t> out) const noexcept {
+  lookupAll(ipv6_, in, out);
+}
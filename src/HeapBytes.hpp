@@ -0,0 +1,22 @@
+#pragma once
+
+// Internal helper for the memoryUsage() estimates of RouteStore and
+// NextHopGroupTable.
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+namespace yang::detail {
+
+  // Heap memory a string owns beyond its object; none while the
+  // small-string buffer holds it.
+  inline std::size_t heapBytes(const std::string &s) {
+    return s.capacity() > std::string().capacity() ? s.capacity() + 1 : 0;
+  }
+
+  inline std::size_t heapBytes(const std::optional<std::string> &s) {
+    return s ? heapBytes(*s) : 0;
+  }
+
+} // namespace yang::detail
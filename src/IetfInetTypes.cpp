@@ -0,0 +1,88 @@
+#include "IetfInetTypes.hpp"
+
+#include <arpa/inet.h>
+#include <charconv>
+
+using namespace yang;
+
+namespace {
+
+  // inet_pton() needs a terminated string; addresses are short
+  template <typename Address>
+  std::optional<Address> parseAddress(int family, std::string_view text) {
+    char buf[INET6_ADDRSTRLEN];
+    if (text.size() >= sizeof(buf))
+      return std::nullopt;
+    text.copy(buf, text.size());
+    buf[text.size()] = '\0';
+    Address a;
+    if (inet_pton(family, buf, a.bytes.data()) != 1)
+      return std::nullopt;
+    return a;
+  }
+
+  template <typename Address>
+  std::string printAddress(int family, const Address &a) {
+    char buf[INET6_ADDRSTRLEN];
+    return inet_ntop(family, a.bytes.data(), buf, sizeof(buf));
+  }
+
+  template <typename Prefix, typename Address>
+  std::optional<Prefix> parsePrefix(int family, std::string_view text) {
+    const auto slash = text.find('/');
+    if (slash == std::string_view::npos)
+      return std::nullopt;
+    auto address = parseAddress<Address>(family, text.substr(0, slash));
+    const std::string_view len = text.substr(slash + 1);
+    unsigned length = 0;
+    auto [end, ec] =
+        std::from_chars(len.data(), len.data() + len.size(), length);
+    if (!address || len.empty() || ec != std::errc() ||
+        end != len.data() + len.size() || length > address->bytes.size() * 8)
+      return std::nullopt;
+
+    Prefix p{*address, static_cast<std::uint8_t>(length)};
+    for (std::size_t i = 0; i < p.address.bytes.size(); ++i) {
+      if (length >= 8) {
+        length -= 8;
+        continue;
+      }
+      p.address.bytes[i] &= static_cast<std::uint8_t>(0xff00 >> length);
+      length = 0;
+    }
+    return p;
+  }
+
+} // namespace
+
+std::optional<Ipv4Address> Ipv4Address::parse(std::string_view text) {
+  return parseAddress<Ipv4Address>(AF_INET, text);
+}
+
+std::string Ipv4Address::toString() const {
+  return printAddress(AF_INET, *this);
+}
+
+std::optional<Ipv6Address> Ipv6Address::parse(std::string_view text) {
+  return parseAddress<Ipv6Address>(AF_INET6, text);
+}
+
+std::string Ipv6Address::toString() const {
+  return printAddress(AF_INET6, *this);
+}
+
+std::optional<Ipv4Prefix> Ipv4Prefix::parse(std::string_view text) {
+  return parsePrefix<Ipv4Prefix, Ipv4Address>(AF_INET, text);
+}
+
+std::string Ipv4Prefix::toString() const {
+  return address.toString() + '/' + std::to_string(length);
+}
+
+std::optional<Ipv6Prefix> Ipv6Prefix::parse(std::string_view text) {
+  return parsePrefix<Ipv6Prefix, Ipv6Address>(AF_INET6, text);
+}
+
+std::string Ipv6Prefix::toString() const {
+  return address.toString() + '/' + std::to_string(length);
+}
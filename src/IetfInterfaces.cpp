@@ -3,144 +3,401 @@
 // `ietf-interfaces` YANG model.
 
 #include "IetfInterfaces.hpp"
+#include "Cbor.hpp"
 #include "Exceptions.hpp"
+#include "SchemaDispatch.hpp"
+#include "YangValue.hpp"
 
+#include <charconv>
 #include <format>
 #include <libyang/libyang.h>
-#include <regex>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 using namespace yang;
 
-// Small helper: find the first immediate child node with the given schema
-// name. Returns nullptr if not found.
-static struct lyd_node *find_child_node(struct lyd_node *parent,
-                                        const char *name) {
-  if (!parent || !name)
-    return nullptr;
-  for (struct lyd_node *c = lyd_child(parent); c; c = c->next) {
-    if (c->schema && c->schema->name && strcmp(c->schema->name, name) == 0)
-      return c;
-  }
-  return nullptr;
+std::span<const ModuleSpec> IetfInterfaces::requiredModules() {
+  static const ModuleSpec modules[] = {
+      {"iana-if-type", "2023-01-26", nullptr},
+      {"ietf-interfaces", "2018-02-20", nullptr},
+      {"ietf-ip", "2018-02-22", nullptr}};
+  return modules;
 }
 
-static const char *node_value(struct lyd_node *n) {
-  return n ? lyd_get_value(n) : nullptr;
-}
+namespace {
+
+  // Schema lookups for serialize(), resolved once per context.
+  struct InterfacesSchema {
+    const struct lys_module *if_mod = nullptr;
+    const struct lys_module *ip_mod = nullptr; // nullptr without ietf-ip
+
+    explicit InterfacesSchema(const YangContext &ctx) {
+      if_mod = ctx.GetLoadedModuleByName("ietf-interfaces").raw();
+      if (!if_mod || !if_mod->implemented)
+        throw YangDataError(ctx);
+      const struct lys_module *ip = ctx.GetLoadedModuleByName("ietf-ip").raw();
+      if (ip && ip->implemented &&
+          lys_find_path(ctx.raw(), nullptr,
+                        "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4",
+                        0))
+        ip_mod = ip;
+    }
+  };
+
+  // Frees a partially built tree if serialization throws.
+  struct TreeGuard {
+    struct lyd_node *root;
+    ~TreeGuard() {
+      if (root)
+        lyd_free_all(root);
+    }
+    struct lyd_node *release() { return std::exchange(root, nullptr); }
+  };
 
-struct lyd_node *IetfInterfaces::serialize(const YangContext &ctx) const {
-  struct ly_ctx *c = ctx.raw();
-  struct lyd_node *root = nullptr;
+  void check(const YangContext &ctx, LY_ERR err) {
+    if (err != LY_SUCCESS)
+      throw YangDataError(ctx);
+  }
 
-  if (lyd_new_path(nullptr, c, "/ietf-interfaces:interfaces", nullptr, 0,
-                   &root) != LY_SUCCESS ||
-      !root) {
-    throw YangDataError(ctx);
+  // ipv4/ipv6 container with its address list and mtu
+  template <typename IpConfig>
+  void serializeIp(const YangContext &ctx, const InterfacesSchema &schema,
+                   struct lyd_node *itf, const char *name,
+                   const IpConfig &ip) {
+    struct lyd_node *cont = nullptr;
+    check(ctx, lyd_new_inner(itf, schema.ip_mod, name, 0, &cont));
+    for (const auto &addr : ip.address) {
+      const std::string &ipstr = addr.address;
+      const auto slash = ipstr.find('/');
+      const std::string ip_only = ipstr.substr(0, slash);
+
+      struct lyd_node *entry = nullptr;
+      check(ctx, lyd_new_list(cont, schema.ip_mod, "address", 0, &entry,
+                              ip_only.c_str()));
+      if (slash != std::string::npos && slash + 1 < ipstr.size()) {
+        check(ctx, lyd_new_term(entry, schema.ip_mod, "prefix-length",
+                                ipstr.c_str() + slash + 1, 0, nullptr));
+      }
+    }
+    if (ip.mtu.has_value()) {
+      check(ctx, lyd_new_term(cont, schema.ip_mod, "mtu",
+                              std::to_string(*ip.mtu).c_str(), 0, nullptr));
+    }
   }
 
-  for (const auto &it : ifs_) {
-    const std::string &name = it.name;
+} // namespace
+
+struct lyd_node *IetfInterfaces::serialize(const YangContext &ctx) const {
+  const auto schema = ctx.schemaCache<InterfacesSchema>();
+  const struct lys_module *if_mod = schema->if_mod;
 
-    // Required leaf: name
-    struct lyd_node *tmp = nullptr;
-    lyd_new_path(root, c,
-                 std::format("interface[name='{}']/name", name).c_str(),
-                 name.c_str(), 0, &tmp);
+  TreeGuard tree{nullptr};
+  check(ctx, lyd_new_inner(nullptr, if_mod, "interfaces", 0, &tree.root));
+
+  // Each list entry is created once, with its key; leaves are attached to
+  // it directly instead of being located again through a path per leaf.
+  for (const auto &it : ifs_) {
+    struct lyd_node *itf = nullptr;
+    check(ctx,
+          lyd_new_list(tree.root, if_mod, "interface", 0, &itf,
+                       it.name.c_str()));
 
     if (it.description.has_value()) {
-      lyd_new_path(
-          root, c,
-          std::format("interface[name='{}']/description", name).c_str(),
-          it.description->c_str(), 0, &tmp);
+      check(ctx, lyd_new_term(itf, if_mod, "description",
+                              it.description->c_str(), 0, nullptr));
     }
 
     if (!it.enabled) {
-      lyd_new_path(root, c,
-                   std::format("interface[name='{}']/enabled", name).c_str(),
-                   "false", 0, &tmp);
+      check(ctx, lyd_new_term(itf, if_mod, "enabled", "false", 0, nullptr));
     }
 
     if (it.type.has_value()) {
+      // lyd_new_term() takes JSON values: identities are module-qualified
       const std::string t =
-          std::format("ianaift:{}", yang::ianaIfTypeToString(*it.type));
-      lyd_new_path(root, c,
-                   std::format("interface[name='{}']/type", name).c_str(),
-                   t.c_str(), 0, &tmp);
-    }
-
-    // IPv4 addresses and container-level mtu
-    if (it.ipv4.has_value()) {
-      for (const auto &addr : it.ipv4->address) {
-        std::string ipstr = addr.address;
-        std::string ip_only;
-        std::string prefix;
-        auto slash = ipstr.find('/');
-        if (slash != std::string::npos) {
-          ip_only = ipstr.substr(0, slash);
-          prefix = ipstr.substr(slash + 1);
-        } else {
-          ip_only = ipstr;
-        }
-
-        const std::string base = std::format(
-            "interface[name='{}']/ip:ipv4/ip:address[ip='{}']", name, ip_only);
-        lyd_new_path(root, c, (base + "/ip:ip").c_str(), ip_only.c_str(), 0,
-                     &tmp);
-        if (!prefix.empty()) {
-          lyd_new_path(root, c, (base + "/ip:prefix-length").c_str(),
-                       prefix.c_str(), 0, &tmp);
-        }
-      }
-      if (it.ipv4->mtu.has_value()) {
-        lyd_new_path(
-            root, c,
-            std::format("interface[name='{}']/ip:ipv4/mtu", name).c_str(),
-            std::format("{}", *it.ipv4->mtu).c_str(), 0, &tmp);
-      }
+          std::format("iana-if-type:{}", yang::ianaIfTypeToString(*it.type));
+      check(ctx, lyd_new_term(itf, if_mod, "type", t.c_str(), 0, nullptr));
     }
 
-    // IPv6 addresses and container-level mtu
-    if (it.ipv6.has_value()) {
-      for (const auto &addr : it.ipv6->address) {
-        std::string ipstr = addr.address;
-        std::string ip_only;
-        std::string prefix;
-        auto slash = ipstr.find('/');
-        if (slash != std::string::npos) {
-          ip_only = ipstr.substr(0, slash);
-          prefix = ipstr.substr(slash + 1);
-        } else {
-          ip_only = ipstr;
-        }
+    if (schema->ip_mod && it.ipv4.has_value())
+      serializeIp(ctx, *schema, itf, "ipv4", *it.ipv4);
+    if (schema->ip_mod && it.ipv6.has_value())
+      serializeIp(ctx, *schema, itf, "ipv6", *it.ipv6);
+  }
+  return tree.release();
+}
 
-        const std::string base = std::format(
-            "interface[name='{}']/ip:ipv6/ip:address[ip='{}']", name, ip_only);
-        lyd_new_path(root, c, (base + "/ip:ip").c_str(), ip_only.c_str(), 0,
-                     &tmp);
-        if (!prefix.empty()) {
-          lyd_new_path(root, c, (base + "/ip:prefix-length").c_str(),
-                       prefix.c_str(), 0, &tmp);
+namespace {
+
+  template <typename IpConfig>
+  void writeIp(YangWriter &w, const char *name, const IpConfig &ip) {
+    w.beginContainer("ietf-ip", name);
+    if (ip.mtu.has_value())
+      w.leaf("ietf-ip", "mtu", *ip.mtu);
+    if (!ip.address.empty()) {
+      w.beginList("ietf-ip", "address");
+      for (const auto &addr : ip.address) {
+        const std::string_view ipstr = addr.address;
+        const auto slash = ipstr.find('/');
+        w.beginEntry();
+        w.leaf("ietf-ip", "ip", ipstr.substr(0, slash));
+        if (slash != std::string_view::npos && slash + 1 < ipstr.size()) {
+          std::uint8_t len = 0;
+          const char *first = ipstr.data() + slash + 1;
+          const char *last = ipstr.data() + ipstr.size();
+          auto [end, ec] = std::from_chars(first, last, len);
+          if (ec != std::errc() || end != last)
+            throw std::invalid_argument("bad prefix length in " +
+                                        addr.address);
+          w.leaf("ietf-ip", "prefix-length", len);
         }
+        w.endEntry();
       }
-      if (it.ipv6->mtu.has_value()) {
-        lyd_new_path(
-            root, c,
-            std::format("interface[name='{}']/ip:ipv6/mtu", name).c_str(),
-            std::format("{}", *it.ipv6->mtu).c_str(), 0, &tmp);
-      }
+      w.endList();
+    }
+    w.endContainer();
+  }
+
+} // namespace
+
+void IetfInterfaces::write(YangWriter &w) const {
+  const auto schema = w.context().schemaCache<InterfacesSchema>();
+
+  // children in schema order, matching what lyd_print() emits for the tree
+  // built by serialize()
+  w.beginContainer("ietf-interfaces", "interfaces");
+  if (!ifs_.empty()) {
+    w.beginList("ietf-interfaces", "interface");
+    for (const auto &it : ifs_) {
+      w.beginEntry();
+      w.leaf("ietf-interfaces", "name", it.name);
+      if (it.description.has_value())
+        w.leaf("ietf-interfaces", "description", *it.description);
+      if (it.type.has_value())
+        w.identity("ietf-interfaces", "type",
+                   yang::ianaIfTypeToString(*it.type), "iana-if-type");
+      if (!it.enabled)
+        w.leaf("ietf-interfaces", "enabled", false);
+      if (schema->ip_mod && it.ipv4.has_value())
+        writeIp(w, "ipv4", *it.ipv4);
+      if (schema->ip_mod && it.ipv6.has_value())
+        writeIp(w, "ipv6", *it.ipv6);
+      w.endEntry();
     }
+    w.endList();
   }
-  return root;
+  w.endContainer();
 }
 
-std::unique_ptr<IetfInterfaces>
-IetfInterfaces::deserialize(const YangContext &ctx, struct lyd_node *tree) {
-  if (!tree)
-    throw YangDataError(ctx);
+namespace {
+
+  using Interface = IetfInterfaces::IetfInterface;
+  using Statistics = IetfInterfaces::IetfInterfaceStatistics;
+  struct InterfacesParser;
+
+  // statistics counters by leaf name, shared by all the decoders
+  template <typename T> using Counter = std::optional<T> Statistics::*;
+
+  constexpr std::pair<const char *, Counter<yang::counter64>> kCounters64[] =
+      {{"in-octets", &Statistics::in_octets},
+       {"in-unicast-pkts", &Statistics::in_unicast_pkts},
+       {"in-broadcast-pkts", &Statistics::in_broadcast_pkts},
+       {"in-multicast-pkts", &Statistics::in_multicast_pkts},
+       {"out-octets", &Statistics::out_octets},
+       {"out-unicast-pkts", &Statistics::out_unicast_pkts},
+       {"out-broadcast-pkts", &Statistics::out_broadcast_pkts},
+       {"out-multicast-pkts", &Statistics::out_multicast_pkts}};
+  constexpr std::pair<const char *, Counter<yang::counter32>> kCounters32[] =
+      {{"in-discards", &Statistics::in_discards},
+       {"in-errors", &Statistics::in_errors},
+       {"in-unknown-protos", &Statistics::in_unknown_protos},
+       {"out-discards", &Statistics::out_discards},
+       {"out-errors", &Statistics::out_errors}};
+
+  // yang:date-and-time as stored: libyang's "+00:00" becomes 'Z' for UTC
+  std::string utcTime(std::string_view v) {
+    const bool utc = v.ends_with("+00:00");
+    if (utc)
+      v.remove_suffix(6);
+    std::string out;
+    out.reserve(v.size() + utc);
+    out.append(v);
+    if (utc)
+      out.push_back('Z');
+    return out;
+  }
 
-  auto model = std::make_unique<IetfInterfaces>();
+  // ip and prefix-length of an ietf-ip address entry
+  struct AddressLeaves {
+    const char *ip = nullptr;
+    const char *prefix_length = nullptr;
+  };
+
+  template <typename IpConfig>
+  using IpDispatch =
+      detail::SchemaDispatch<const InterfacesParser &, IpConfig &>;
+
+  // Field handlers for deserialize(), keyed by schema node and built once
+  // per context.
+  struct InterfacesParser {
+    const struct lysc_node *interface_list = nullptr;
+    detail::SchemaDispatch<const InterfacesParser &, Interface &> interface;
+    // name and statistics only, for deserializeStatistics()
+    detail::SchemaDispatch<const InterfacesParser &, Interface &> counters;
+    detail::SchemaDispatch<Statistics &> statistics;
+    IpDispatch<IetfInterfaces::IetfIpv4> ipv4;
+    IpDispatch<IetfInterfaces::IetfIpv6> ipv6;
+    detail::SchemaDispatch<AddressLeaves &> ipv4_address, ipv6_address;
+
+    explicit InterfacesParser(const YangContext &ctx);
+
+    template <typename IpConfig>
+    const detail::SchemaDispatch<AddressLeaves &> &address() const {
+      if constexpr (std::is_same_v<IpConfig, IetfInterfaces::IetfIpv4>)
+        return ipv4_address;
+      else
+        return ipv6_address;
+    }
+  };
+
+  const char *value(struct lyd_node *n) { return lyd_get_value(n); }
+
+  template <typename IpConfig>
+  void addIpHandlers(const struct ly_ctx *c, const std::string &base,
+                     IpDispatch<IpConfig> &ip,
+                     detail::SchemaDispatch<AddressLeaves &> &address) {
+    ip.add(c, (base + "/mtu").c_str(),
+           [](struct lyd_node *n, const InterfacesParser &, IpConfig &cfg) {
+             cfg.mtu = YangValue(n).as<uint32_t>();
+           });
+    ip.add(c, (base + "/address").c_str(),
+           [](struct lyd_node *n, const InterfacesParser &p, IpConfig &cfg) {
+             AddressLeaves leaves;
+             p.address<IpConfig>().dispatch(n, leaves);
+             if (!leaves.ip)
+               return;
+             typename IpConfig::Address a;
+             a.address = leaves.ip;
+             if (leaves.prefix_length)
+               a.address = std::format("{}/{}", a.address,
+                                       leaves.prefix_length);
+             cfg.address.push_back(std::move(a));
+           });
+    address.add(c, (base + "/address/ip").c_str(),
+                [](struct lyd_node *n, AddressLeaves &a) { a.ip = value(n); });
+    address.add(c, (base + "/address/prefix-length").c_str(),
+                [](struct lyd_node *n, AddressLeaves &a) {
+                  a.prefix_length = value(n);
+                });
+  }
 
+  template <typename IpConfig>
+  void parseIp(struct lyd_node *n, const InterfacesParser &p,
+               const IpDispatch<IpConfig> &table,
+               std::optional<IpConfig> &out) {
+    IpConfig ip;
+    table.dispatch(n, p, ip);
+    // a container without addresses is dropped
+    if (!ip.address.empty())
+      out = std::move(ip);
+  }
+
+  template <auto Member>
+  void readCounter(struct lyd_node *n, Statistics &s) {
+    using T = typename std::remove_reference_t<decltype(s.*Member)>::value_type;
+    s.*Member = YangValue(n).as<T>();
+  }
+
+  // Shorthand for the interface handlers below.
+  using InterfaceHandler = void (*)(struct lyd_node *,
+                                    const InterfacesParser &, Interface &);
+
+  InterfacesParser::InterfacesParser(const YangContext &ctx) {
+    const struct ly_ctx *c = ctx.raw();
+    const std::string list = "/ietf-interfaces:interfaces/interface";
+    interface_list = lys_find_path(c, nullptr, list.c_str(), 0);
+
+    auto add = [&](const char *child, InterfaceHandler handler) {
+      interface.add(c, (list + '/' + child).c_str(), handler);
+    };
+    InterfaceHandler name = [](struct lyd_node *n, const InterfacesParser &,
+                               Interface &i) { i.name = value(n); };
+    add("name", name);
+    add("description", [](struct lyd_node *n, const InterfacesParser &,
+                          Interface &i) { i.description = value(n); });
+    add("type", [](struct lyd_node *n, const InterfacesParser &,
+                   Interface &i) {
+      i.type = yang::ianaIfTypeFromString(YangValue(n).identityName());
+    });
+    add("enabled", [](struct lyd_node *n, const InterfacesParser &,
+                      Interface &i) { i.enabled = YangValue(n).asBool(); });
+    add("admin-status",
+        [](struct lyd_node *n, const InterfacesParser &, Interface &i) {
+          i.admin_status = YangValue(n).enumName();
+        });
+    add("oper-status",
+        [](struct lyd_node *n, const InterfacesParser &, Interface &i) {
+          i.oper_status = YangValue(n).enumName();
+        });
+    add("last-change", [](struct lyd_node *n, const InterfacesParser &,
+                          Interface &i) { i.last_change = value(n); });
+    add("if-index",
+        [](struct lyd_node *n, const InterfacesParser &, Interface &i) {
+          i.if_index = YangValue(n).as<int32_t>();
+        });
+    add("phys-address", [](struct lyd_node *n, const InterfacesParser &,
+                           Interface &i) { i.phys_address = value(n); });
+    add("higher-layer-if",
+        [](struct lyd_node *n, const InterfacesParser &, Interface &i) {
+          i.higher_layer_if.push_back(value(n));
+        });
+    add("lower-layer-if",
+        [](struct lyd_node *n, const InterfacesParser &, Interface &i) {
+          i.lower_layer_if.push_back(value(n));
+        });
+
+    InterfaceHandler stats = [](struct lyd_node *n, const InterfacesParser &p,
+                                Interface &i) {
+      p.statistics.dispatch(n, i.statistics.emplace());
+    };
+    add("statistics", stats);
+    counters.add(c, (list + "/name").c_str(), name);
+    counters.add(c, (list + "/statistics").c_str(), stats);
+
+    const std::string stat = list + "/statistics/";
+    statistics.add(c, (stat + "discontinuity-time").c_str(),
+                   [](struct lyd_node *n, Statistics &s) {
+                     s.discontinuity_time = utcTime(value(n));
+                   });
+    // counters are read as the integers libyang stored
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (statistics.add(c, (stat + kCounters64[I].first).c_str(),
+                      readCounter<kCounters64[I].second>),
+       ...);
+    }(std::make_index_sequence<std::size(kCounters64)>());
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      (statistics.add(c, (stat + kCounters32[I].first).c_str(),
+                      readCounter<kCounters32[I].second>),
+       ...);
+    }(std::make_index_sequence<std::size(kCounters32)>());
+
+    // ietf-ip augmentation; left out of contexts without ietf-ip
+    add("ietf-ip:ipv4", [](struct lyd_node *n, const InterfacesParser &p,
+                           Interface &i) { parseIp(n, p, p.ipv4, i.ipv4); });
+    add("ietf-ip:ipv6", [](struct lyd_node *n, const InterfacesParser &p,
+                           Interface &i) { parseIp(n, p, p.ipv6, i.ipv6); });
+    addIpHandlers(c, list + "/ietf-ip:ipv4", ipv4, ipv4_address);
+    addIpHandlers(c, list + "/ietf-ip:ipv6", ipv6, ipv6_address);
+  }
+
+} // namespace
+
+// The interfaces container: `tree` itself or its top-level sibling.
+static struct lyd_node *interfacesNode(const YangContext &ctx,
+                                       struct lyd_node *tree) {
+  if (!tree)
+    throw YangDataError(ctx);
   struct lyd_node *ifs = nullptr;
   if (tree->schema && tree->schema->name &&
       strcmp(tree->schema->name, "interfaces") == 0) {
@@ -153,144 +410,607 @@ IetfInterfaces::deserialize(const YangContext &ctx, struct lyd_node *tree) {
   }
   if (!ifs)
     throw YangDataError(ctx);
+  return ifs;
+}
 
-  const char *v = nullptr;
-  static const std::regex ns_prefix(R"(^[^:]+:)");
+std::unique_ptr<IetfInterfaces>
+IetfInterfaces::deserialize(const YangContext &ctx, struct lyd_node *tree) {
+  struct lyd_node *ifs = interfacesNode(ctx, tree);
+  auto model = std::make_unique<IetfInterfaces>();
 
+  // one pass over each entry's children, dispatched on the schema node
+  const auto parser = ctx.schemaCache<InterfacesParser>();
   for (struct lyd_node *ch = lyd_child(ifs); ch; ch = ch->next) {
-    if (!ch->schema || !ch->schema->name)
-      continue;
-    if (strcmp(ch->schema->name, "interface") != 0)
+    if (!ch->schema || ch->schema != parser->interface_list)
       continue;
 
     IetfInterfaces::IetfInterface itf;
+    parser->interface.dispatch(ch, *parser, itf);
+    if (itf.name.empty())
+      throw YangDataError(ctx);
+    model->ifs_.push_back(std::move(itf));
+  }
+
+  return model;
+}
+
+void IetfInterfaces::deserializeStatistics(
+    const YangContext &ctx, struct lyd_node *tree,
+    const std::function<void(const std::string &, IetfInterfaceStatistics &&)>
+        &on_statistics) {
+  struct lyd_node *ifs = interfacesNode(ctx, tree);
+  const auto parser = ctx.schemaCache<InterfacesParser>();
+  for (struct lyd_node *ch = lyd_child(ifs); ch; ch = ch->next) {
+    if (!ch->schema || ch->schema != parser->interface_list)
+      continue;
 
-    struct lyd_node *n = find_child_node(ch, "name");
-    if (n && (v = node_value(n)))
-      itf.name = v;
+    IetfInterfaces::IetfInterface itf;
+    parser->counters.dispatch(ch, *parser, itf);
     if (itf.name.empty())
       throw YangDataError(ctx);
+    if (itf.statistics.has_value())
+      on_statistics(itf.name, std::move(*itf.statistics));
+  }
+}
 
-    n = find_child_node(ch, "description");
-    if (n && (v = node_value(n)))
-      itf.description = std::string(v);
-
-    n = find_child_node(ch, "type");
-    if (n && (v = node_value(n))) {
-      std::string sv(v);
-      sv = std::regex_replace(sv, ns_prefix, "");
-      itf.type = yang::ianaIfTypeFromString(sv);
-    }
-
-    n = find_child_node(ch, "enabled");
-    if (n && (v = node_value(n)))
-      itf.enabled = !(strcmp(v, "false") == 0 || strcmp(v, "0") == 0);
-
-    n = find_child_node(ch, "admin-status");
-    if (n && (v = node_value(n)))
-      itf.admin_status = std::string(v);
-
-    n = find_child_node(ch, "oper-status");
-    if (n && (v = node_value(n)))
-      itf.oper_status = std::string(v);
-
-    // statistics/discontinuity-time
-    n = find_child_node(ch, "statistics");
-    if (n) {
-      struct lyd_node *stat = find_child_node(n, "discontinuity-time");
-      if (stat && (v = node_value(stat))) {
-        IetfInterfaces::IetfInterfaceStatistics s;
-        std::string dt(v);
-        // Normalize libyang's "+00:00" to 'Z' for UTC
-        if (dt.size() >= 6 && dt.compare(dt.size() - 6, 6, "+00:00") == 0)
-          dt = dt.substr(0, dt.size() - 6) + "Z";
-        s.discontinuity_time = dt;
-        itf.statistics = s;
-      }
-    }
+namespace {
 
-    // ipv4 augmentation
-    n = find_child_node(ch, "ipv4");
-    if (n) {
-      IetfInterfaces::IetfIpv4 ip4;
-      struct lyd_node *mtu_leaf = find_child_node(n, "mtu");
-      if (mtu_leaf && (v = node_value(mtu_leaf)))
-        ip4.mtu = static_cast<uint32_t>(std::stoul(v));
+  template <typename T> T readNumber(YangReader &r) {
+    std::string_view v = r.text();
+    T out{};
+    auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), out);
+    if (ec != std::errc() || end != v.data() + v.size())
+      r.fail("bad value '" + std::string(v) + "' for '" +
+             std::string(r.name()) + "'");
+    return out;
+  }
 
-      for (struct lyd_node *addr = lyd_child(n); addr; addr = addr->next) {
-        if (!addr->schema || !addr->schema->name)
-          continue;
-        if (strcmp(addr->schema->name, "address") != 0)
-          continue;
-        struct lyd_node *ip_leaf = find_child_node(addr, "ip");
-        if (ip_leaf && (v = node_value(ip_leaf))) {
-          IetfInterfaces::IetfIpv4::Address a;
-          a.address = std::string(v);
-          struct lyd_node *pl = find_child_node(addr, "prefix-length");
-          if (pl && (v = node_value(pl)))
-            a.address = std::format("{}/{}", a.address, v);
-          ip4.address.push_back(std::move(a));
+  template <typename IpConfig>
+  void readIp(YangReader &r, std::optional<IpConfig> &out) {
+    IpConfig ip;
+    const std::size_t level = r.depth();
+    while (r.nextChild(level)) {
+      if (r.name() == "mtu") {
+        ip.mtu = readNumber<uint32_t>(r);
+      } else if (r.name() == "address") {
+        std::string addr, prefix_length;
+        const std::size_t entry = r.depth();
+        while (r.nextChild(entry)) {
+          if (r.name() == "ip")
+            addr = r.text();
+          else if (r.name() == "prefix-length")
+            prefix_length = r.text();
         }
+        if (addr.empty())
+          continue;
+        if (!prefix_length.empty())
+          addr = std::format("{}/{}", addr, prefix_length);
+        ip.address.push_back({std::move(addr)});
+      }
+    }
+    // as in deserialize(), a container without addresses is dropped
+    if (!ip.address.empty())
+      out = std::move(ip);
+  }
+
+  void readStatistics(YangReader &r, Statistics &stats) {
+    const std::size_t level = r.depth();
+    while (r.nextChild(level)) {
+      const std::string_view leaf = r.name();
+      if (leaf == "discontinuity-time") {
+        stats.discontinuity_time = utcTime(r.text());
+        continue;
       }
-      if (!ip4.address.empty())
-        itf.ipv4 = std::move(ip4);
+      for (const auto &[name, member] : kCounters64)
+        if (leaf == name)
+          stats.*member = readNumber<yang::counter64>(r);
+      for (const auto &[name, member] : kCounters32)
+        if (leaf == name)
+          stats.*member = readNumber<yang::counter32>(r);
     }
+  }
 
-    // ipv6 augmentation
-    n = find_child_node(ch, "ipv6");
-    if (n) {
-      IetfInterfaces::IetfIpv6 ip6;
-      struct lyd_node *mtu6_leaf = find_child_node(n, "mtu");
-      if (mtu6_leaf && (v = node_value(mtu6_leaf)))
-        ip6.mtu = static_cast<uint32_t>(std::stoul(v));
+  void readInterface(YangReader &r, IetfInterfaces::IetfInterface &itf) {
+    const std::size_t level = r.depth();
+    while (r.nextChild(level)) {
+      const std::string_view module = r.module();
+      const std::string_view name = r.name();
+      if (module == "ietf-ip") {
+        if (name == "ipv4")
+          readIp(r, itf.ipv4);
+        else if (name == "ipv6")
+          readIp(r, itf.ipv6);
+        continue;
+      }
+      if (module != "ietf-interfaces")
+        continue;
 
-      for (struct lyd_node *addr = lyd_child(n); addr; addr = addr->next) {
-        if (!addr->schema || !addr->schema->name)
-          continue;
-        if (strcmp(addr->schema->name, "address") != 0)
-          continue;
-        struct lyd_node *ip_leaf = find_child_node(addr, "ip");
-        if (ip_leaf && (v = node_value(ip_leaf))) {
-          IetfInterfaces::IetfIpv6::Address a;
-          a.address = std::string(v);
-          struct lyd_node *pl = find_child_node(addr, "prefix-length");
-          if (pl && (v = node_value(pl)))
-            a.address = std::format("{}/{}", a.address, v);
-          ip6.address.push_back(std::move(a));
-        }
+      if (name == "name") {
+        itf.name = r.text();
+      } else if (name == "description") {
+        itf.description = std::string(r.text());
+      } else if (name == "type") {
+        itf.type = yang::ianaIfTypeFromString(r.identity());
+      } else if (name == "enabled") {
+        std::string_view v = r.text();
+        itf.enabled = !(v == "false" || v == "0");
+      } else if (name == "admin-status") {
+        itf.admin_status = std::string(r.text());
+      } else if (name == "oper-status") {
+        itf.oper_status = std::string(r.text());
+      } else if (name == "last-change") {
+        itf.last_change = std::string(r.text());
+      } else if (name == "if-index") {
+        itf.if_index = readNumber<int32_t>(r);
+      } else if (name == "phys-address") {
+        itf.phys_address = std::string(r.text());
+      } else if (name == "higher-layer-if") {
+        itf.higher_layer_if.emplace_back(r.text());
+      } else if (name == "lower-layer-if") {
+        itf.lower_layer_if.emplace_back(r.text());
+      } else if (name == "statistics") {
+        readStatistics(r, itf.statistics.emplace());
       }
-      if (!ip6.address.empty())
-        itf.ipv6 = std::move(ip6);
+    }
+    if (itf.name.empty())
+      r.fail("interface without a name");
+  }
+
+  // Builds `entry` as typed libyang nodes, so that libyang checks every
+  // value read into it: serialize() creates the configuration, and each
+  // state leaf the reader filled is added to its interface entry.
+  void validateEntry(const YangContext &ctx, const IetfInterfaces &entry) {
+    TreeGuard tree{entry.serialize(ctx)};
+    const struct lys_module *mod = ctx.schemaCache<InterfacesSchema>()->if_mod;
+    const IetfInterfaces::IetfInterface &itf = entry.getInterfaces().front();
+    struct lyd_node *node = lyd_child(tree.root);
+    auto term = [&](struct lyd_node *parent, const char *name,
+                    const std::string &v) {
+      check(ctx, lyd_new_term(parent, mod, name, v.c_str(), 0, nullptr));
+    };
+
+    if (itf.admin_status)
+      term(node, "admin-status", *itf.admin_status);
+    if (itf.oper_status)
+      term(node, "oper-status", *itf.oper_status);
+    if (itf.last_change)
+      term(node, "last-change", *itf.last_change);
+    if (itf.if_index)
+      term(node, "if-index", std::to_string(*itf.if_index));
+    if (itf.phys_address)
+      term(node, "phys-address", *itf.phys_address);
+    for (const auto &ref : itf.higher_layer_if)
+      term(node, "higher-layer-if", ref);
+    for (const auto &ref : itf.lower_layer_if)
+      term(node, "lower-layer-if", ref);
+    if (!itf.statistics)
+      return;
+
+    const Statistics &s = *itf.statistics;
+    struct lyd_node *stats = nullptr;
+    check(ctx, lyd_new_inner(node, mod, "statistics", 0, &stats));
+    if (s.discontinuity_time)
+      term(stats, "discontinuity-time", *s.discontinuity_time);
+    for (const auto &[name, member] : kCounters64)
+      if (s.*member)
+        term(stats, name, std::to_string(*(s.*member)));
+    for (const auto &[name, member] : kCounters32)
+      if (s.*member)
+        term(stats, name, std::to_string(*(s.*member)));
+  }
+
+} // namespace
+
+void IetfInterfaces::read(
+    YangReader &reader,
+    const std::function<void(IetfInterface &&)> &on_interface, bool validate) {
+  while (reader.nextChild(0)) {
+    if (reader.module() != "ietf-interfaces" || reader.name() != "interfaces")
+      continue;
+    while (reader.nextChild(1)) {
+      if (reader.name() != "interface")
+        continue;
+      IetfInterfaces entry;
+      entry.ifs_.emplace_back();
+      readInterface(reader, entry.ifs_.back());
+      if (validate)
+        validateEntry(reader.context(), entry);
+      on_interface(std::move(entry.ifs_.back()));
+    }
+  }
+}
+
+std::unique_ptr<IetfInterfaces> IetfInterfaces::read(YangReader &reader,
+                                                     bool validate) {
+  auto model = std::make_unique<IetfInterfaces>();
+  read(
+      reader,
+      [&](IetfInterface &&itf) { model->ifs_.push_back(std::move(itf)); },
+      validate);
+  return model;
+}
+
+namespace {
+
+  // enumeration leaves are sent as their integer value (RFC 9254 6.6)
+  constexpr std::pair<std::string_view, std::int64_t> kAdminStatus[] = {
+      {"up", 1}, {"down", 2}, {"testing", 3}};
+  constexpr std::pair<std::string_view, std::int64_t> kOperStatus[] = {
+      {"up", 1},      {"down", 2},        {"testing", 3},
+      {"unknown", 4}, {"dormant", 5},     {"not-present", 6},
+      {"lower-layer-down", 7}};
+
+  template <std::size_t N>
+  std::int64_t
+  enumValue(const std::pair<std::string_view, std::int64_t> (&table)[N],
+            std::string_view name, const SidRef &node) {
+    for (const auto &[n, v] : table)
+      if (n == name)
+        return v;
+    throw std::invalid_argument("bad value '" + std::string(name) +
+                                "' for " + node.path());
+  }
+
+  template <std::size_t N>
+  std::string
+  readEnum(CborReader &r,
+           const std::pair<std::string_view, std::int64_t> (&table)[N]) {
+    const auto type = r.next();
+    if (type == CborReader::Type::Text) // by name, as in a union (tag 44)
+      return std::string(r.payload());
+    if (type == CborReader::Type::Unsigned)
+      for (const auto &[n, v] : table)
+        if (static_cast<std::uint64_t>(v) == r.argument())
+          return std::string(n);
+    r.fail("bad enumeration value");
+  }
+
+  struct IpSids {
+    SidRef container, mtu, address, ip, prefix_length;
+
+    IpSids(const SidMap &m, const std::string &base)
+        : container(m, base), mtu(m, base + "/mtu"),
+          address(m, base + "/address"), ip(m, base + "/address/ip"),
+          prefix_length(m, base + "/address/prefix-length") {}
+  };
+
+  // SIDs of the nodes IetfInterfaces encodes, looked up once per call.
+  struct InterfacesSids {
+    const SidMap &map;
+    SidRef interfaces, interface, name, description, type, enabled,
+        link_up_down_trap_enable, admin_status, oper_status, last_change,
+        if_index, phys_address, higher_layer_if, lower_layer_if, speed,
+        statistics, discontinuity_time;
+    std::vector<SidRef> counters64, counters32; // as kCounters64/32
+    IpSids ipv4, ipv6;
+
+    static std::string at(const char *leaf) {
+      return std::string("/ietf-interfaces:interfaces/interface/") + leaf;
     }
 
-    n = find_child_node(ch, "last-change");
-    if (n && (v = node_value(n)))
-      itf.last_change = std::string(v);
+    explicit InterfacesSids(const SidMap &m)
+        : map(m), interfaces(m, "/ietf-interfaces:interfaces"),
+          interface(m, "/ietf-interfaces:interfaces/interface"),
+          name(m, at("name")), description(m, at("description")),
+          type(m, at("type")), enabled(m, at("enabled")),
+          link_up_down_trap_enable(m, at("link-up-down-trap-enable")),
+          admin_status(m, at("admin-status")),
+          oper_status(m, at("oper-status")),
+          last_change(m, at("last-change")), if_index(m, at("if-index")),
+          phys_address(m, at("phys-address")),
+          higher_layer_if(m, at("higher-layer-if")),
+          lower_layer_if(m, at("lower-layer-if")), speed(m, at("speed")),
+          statistics(m, at("statistics")),
+          discontinuity_time(m, at("statistics/discontinuity-time")),
+          ipv4(m, at("ietf-ip:ipv4")), ipv6(m, at("ietf-ip:ipv6")) {
+      for (const auto &[leaf, member] : kCounters64)
+        counters64.emplace_back(m, at("statistics/") + leaf);
+      for (const auto &[leaf, member] : kCounters32)
+        counters32.emplace_back(m, at("statistics/") + leaf);
+    }
+  };
+
+  template <typename IpConfig>
+  void writeCborIp(CborWriter &w, const IpSids &s, std::uint64_t parent,
+                   const IpConfig &ip) {
+    const std::uint64_t self = *s.container;
+    w.key(self, parent);
+    w.beginMap(ip.mtu.has_value() + !ip.address.empty());
+    if (ip.mtu.has_value()) {
+      w.key(*s.mtu, self);
+      w.unsignedInt(*ip.mtu);
+    }
+    if (ip.address.empty())
+      return;
+    const std::uint64_t list = *s.address;
+    w.key(list, self);
+    w.beginArray(ip.address.size());
+    for (const auto &addr : ip.address) {
+      const auto slash = addr.address.find('/');
+      const bool has_prefix = slash != std::string::npos;
+      w.beginMap(1 + has_prefix);
+      w.key(*s.ip, list);
+      w.text(std::string_view(addr.address).substr(0, slash));
+      if (has_prefix) {
+        std::string_view len = std::string_view(addr.address).substr(slash + 1);
+        std::uint8_t prefix_length = 0;
+        auto [end, ec] =
+            std::from_chars(len.data(), len.data() + len.size(), prefix_length);
+        if (ec != std::errc() || end != len.data() + len.size())
+          throw std::invalid_argument("bad prefix length in '" +
+                                      addr.address + "'");
+        w.key(*s.prefix_length, list);
+        w.unsignedInt(prefix_length);
+      }
+    }
+  }
 
-    n = find_child_node(ch, "if-index");
-    if (n && (v = node_value(n)))
-      itf.if_index = std::stoi(v);
+  template <typename IpConfig>
+  void readCborIp(CborReader &r, const IpSids &s, std::uint64_t self,
+                  std::optional<IpConfig> &out) {
+    IpConfig ip;
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t sid = self + r.readInteger();
+      if (s.mtu == sid) {
+        ip.mtu = static_cast<uint32_t>(r.readUnsigned());
+      } else if (s.address == sid) {
+        auto entries = r.expectArray();
+        while (r.more(entries)) {
+          std::string addr, prefix_length;
+          auto leaves = r.expectMap();
+          while (r.more(leaves)) {
+            const std::uint64_t leaf = sid + r.readInteger();
+            if (s.ip == leaf)
+              addr = r.readText();
+            else if (s.prefix_length == leaf)
+              prefix_length = std::to_string(r.readUnsigned());
+            else
+              r.skip();
+          }
+          if (addr.empty())
+            continue;
+          if (!prefix_length.empty())
+            addr += '/' + prefix_length;
+          ip.address.push_back({std::move(addr)});
+        }
+      } else {
+        r.skip();
+      }
+    }
+    // as in deserialize(), a container without addresses is dropped
+    if (!ip.address.empty())
+      out = std::move(ip);
+  }
 
-    n = find_child_node(ch, "phys-address");
-    if (n && (v = node_value(n)))
-      itf.phys_address = std::string(v);
+  void writeCborStatistics(CborWriter &w, const InterfacesSids &s,
+                           std::uint64_t parent, const Statistics &stats) {
+    std::size_t n = stats.discontinuity_time.has_value();
+    for (const auto &[leaf, member] : kCounters64)
+      n += (stats.*member).has_value();
+    for (const auto &[leaf, member] : kCounters32)
+      n += (stats.*member).has_value();
+
+    const std::uint64_t self = *s.statistics;
+    w.key(self, parent);
+    w.beginMap(n);
+    if (stats.discontinuity_time.has_value()) {
+      w.key(*s.discontinuity_time, self);
+      w.text(*stats.discontinuity_time);
+    }
+    for (std::size_t i = 0; i < std::size(kCounters64); ++i)
+      if (const auto &v = stats.*kCounters64[i].second) {
+        w.key(*s.counters64[i], self);
+        w.unsignedInt(*v);
+      }
+    for (std::size_t i = 0; i < std::size(kCounters32); ++i)
+      if (const auto &v = stats.*kCounters32[i].second) {
+        w.key(*s.counters32[i], self);
+        w.unsignedInt(*v);
+      }
+  }
 
-    // leaf-lists: higher-layer-if / lower-layer-if
-    for (struct lyd_node *ll = lyd_child(ch); ll; ll = ll->next) {
-      if (!ll->schema || !ll->schema->name)
+  Statistics readCborStatistics(CborReader &r, const InterfacesSids &s,
+                                std::uint64_t self) {
+    Statistics stats;
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t sid = self + r.readInteger();
+      if (s.discontinuity_time == sid) {
+        stats.discontinuity_time = std::string(r.readText());
         continue;
-      if (strcmp(ll->schema->name, "higher-layer-if") == 0) {
-        if ((v = node_value(ll)))
-          itf.higher_layer_if.push_back(v);
       }
-      if (strcmp(ll->schema->name, "lower-layer-if") == 0) {
-        if ((v = node_value(ll)))
-          itf.lower_layer_if.push_back(v);
+      bool known = false;
+      for (std::size_t i = 0; i < std::size(kCounters64) && !known; ++i)
+        if ((known = s.counters64[i] == sid))
+          stats.*kCounters64[i].second = r.readUnsigned();
+      for (std::size_t i = 0; i < std::size(kCounters32) && !known; ++i)
+        if ((known = s.counters32[i] == sid))
+          stats.*kCounters32[i].second =
+              static_cast<yang::counter32>(r.readUnsigned());
+      if (!known)
+        r.skip();
+    }
+    return stats;
+  }
+
+  void writeCborInterface(CborWriter &w, const InterfacesSids &s,
+                          const IetfInterfaces::IetfInterface &itf) {
+    using Trap = IetfInterfaces::IetfInterface::LinkUpDownTrap;
+    const std::size_t n =
+        1 + itf.description.has_value() + itf.type.has_value() +
+        !itf.enabled + itf.link_up_down_trap_enable.has_value() +
+        itf.admin_status.has_value() + itf.oper_status.has_value() +
+        itf.last_change.has_value() + itf.if_index.has_value() +
+        itf.phys_address.has_value() + !itf.higher_layer_if.empty() +
+        !itf.lower_layer_if.empty() + itf.speed.has_value() +
+        itf.statistics.has_value() + itf.ipv4.has_value() +
+        itf.ipv6.has_value();
+
+    const std::uint64_t p = *s.interface;
+    w.beginMap(n);
+    w.key(*s.name, p);
+    w.text(itf.name);
+    if (itf.description) {
+      w.key(*s.description, p);
+      w.text(*itf.description);
+    }
+    if (itf.type) {
+      w.key(*s.type, p);
+      w.identity(s.map, std::string("iana-if-type:")
+                            .append(yang::ianaIfTypeToString(*itf.type)));
+    }
+    if (!itf.enabled) { // default true
+      w.key(*s.enabled, p);
+      w.boolean(false);
+    }
+    if (itf.link_up_down_trap_enable) {
+      w.key(*s.link_up_down_trap_enable, p);
+      w.unsignedInt(*itf.link_up_down_trap_enable == Trap::Enabled ? 1 : 2);
+    }
+    if (itf.admin_status) {
+      w.key(*s.admin_status, p);
+      w.integer(enumValue(kAdminStatus, *itf.admin_status, s.admin_status));
+    }
+    if (itf.oper_status) {
+      w.key(*s.oper_status, p);
+      w.integer(enumValue(kOperStatus, *itf.oper_status, s.oper_status));
+    }
+    if (itf.last_change) {
+      w.key(*s.last_change, p);
+      w.text(*itf.last_change);
+    }
+    if (itf.if_index) {
+      w.key(*s.if_index, p);
+      w.integer(*itf.if_index);
+    }
+    if (itf.phys_address) {
+      w.key(*s.phys_address, p);
+      w.text(*itf.phys_address);
+    }
+    for (const auto *list : {&itf.higher_layer_if, &itf.lower_layer_if}) {
+      if (list->empty())
+        continue;
+      w.key(list == &itf.higher_layer_if ? *s.higher_layer_if
+                                          : *s.lower_layer_if,
+            p);
+      w.beginArray(list->size());
+      for (const auto &v : *list)
+        w.text(v);
+    }
+    if (itf.speed) {
+      w.key(*s.speed, p);
+      w.unsignedInt(*itf.speed);
+    }
+    if (itf.statistics)
+      writeCborStatistics(w, s, p, *itf.statistics);
+    if (itf.ipv4)
+      writeCborIp(w, s.ipv4, p, *itf.ipv4);
+    if (itf.ipv6)
+      writeCborIp(w, s.ipv6, p, *itf.ipv6);
+  }
+
+  IetfInterfaces::IetfInterface readCborInterface(CborReader &r,
+                                                  const InterfacesSids &s,
+                                                  std::uint64_t p) {
+    using Trap = IetfInterfaces::IetfInterface::LinkUpDownTrap;
+    IetfInterfaces::IetfInterface itf;
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t sid = p + r.readInteger();
+      if (s.name == sid) {
+        itf.name = r.readText();
+      } else if (s.description == sid) {
+        itf.description = std::string(r.readText());
+      } else if (s.type == sid) {
+        itf.type = yang::ianaIfTypeFromString(r.readIdentity(s.map));
+      } else if (s.enabled == sid) {
+        itf.enabled = r.readBool();
+      } else if (s.link_up_down_trap_enable == sid) {
+        itf.link_up_down_trap_enable =
+            r.readUnsigned() == 1 ? Trap::Enabled : Trap::Disabled;
+      } else if (s.admin_status == sid) {
+        itf.admin_status = readEnum(r, kAdminStatus);
+      } else if (s.oper_status == sid) {
+        itf.oper_status = readEnum(r, kOperStatus);
+      } else if (s.last_change == sid) {
+        itf.last_change = std::string(r.readText());
+      } else if (s.if_index == sid) {
+        itf.if_index = static_cast<int32_t>(r.readInteger());
+      } else if (s.phys_address == sid) {
+        itf.phys_address = std::string(r.readText());
+      } else if (s.higher_layer_if == sid || s.lower_layer_if == sid) {
+        auto &list = s.higher_layer_if == sid ? itf.higher_layer_if
+                                              : itf.lower_layer_if;
+        auto entries = r.expectArray();
+        while (r.more(entries))
+          list.emplace_back(r.readText());
+      } else if (s.speed == sid) {
+        itf.speed = r.readUnsigned();
+      } else if (s.statistics == sid) {
+        itf.statistics = readCborStatistics(r, s, sid);
+      } else if (s.ipv4.container == sid) {
+        readCborIp(r, s.ipv4, sid, itf.ipv4);
+      } else if (s.ipv6.container == sid) {
+        readCborIp(r, s.ipv6, sid, itf.ipv6);
+      } else {
+        r.skip();
       }
     }
+    if (itf.name.empty())
+      r.fail("interface without a name");
+    return itf;
+  }
+
+} // namespace
+
+void IetfInterfaces::writeCbor(const SidMap &sids, YangOutput &out) const {
+  const InterfacesSids s(sids);
+  CborWriter w(out);
+  const std::uint64_t container = *s.interfaces;
+  w.beginMap(1);
+  w.key(container);
+  w.beginMap(!ifs_.empty());
+  if (!ifs_.empty()) {
+    w.key(*s.interface, container);
+    w.beginArray(ifs_.size());
+    for (const auto &itf : ifs_)
+      writeCborInterface(w, s, itf);
+  }
+  out.flush();
+}
 
-    model->addInterface(std::move(itf));
+void IetfInterfaces::readCbor(
+    const SidMap &sids, YangInput &in,
+    const std::function<void(IetfInterface &&)> &on_interface) {
+  const InterfacesSids s(sids);
+  CborReader r(in);
+  auto top = r.expectMap();
+  while (r.more(top)) {
+    const std::uint64_t sid = static_cast<std::uint64_t>(r.readInteger());
+    if (!(s.interfaces == sid)) {
+      r.skip();
+      continue;
+    }
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t list = sid + r.readInteger();
+      if (!(s.interface == list)) {
+        r.skip();
+        continue;
+      }
+      auto entries = r.expectArray();
+      while (r.more(entries))
+        on_interface(readCborInterface(r, s, list));
+    }
   }
+}
 
+std::unique_ptr<IetfInterfaces> IetfInterfaces::readCbor(const SidMap &sids,
+                                                         YangInput &in) {
+  auto model = std::make_unique<IetfInterfaces>();
+  readCbor(sids, in, [&](IetfInterface &&itf) {
+    model->ifs_.push_back(std::move(itf));
+  });
   return model;
 }
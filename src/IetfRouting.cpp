@@ -1,7 +1,16 @@
 #include "IetfRouting.hpp"
+#include "Cbor.hpp"
 #include "Exceptions.hpp"
+#include "SchemaDispatch.hpp"
+#include "YangIdentity.hpp"
+#include "YangValue.hpp"
 #include "IetfInterfaces.hpp"
+#include <charconv>
 #include <libyang/libyang.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 
 using namespace yang;
 
@@ -10,95 +19,569 @@ static void check_ly_err(const YangContext &ctx, LY_ERR err) {
     throw YangDataError(ctx);
 }
 
-struct lyd_node *IetfRouting::serialize(const YangContext &ctx) const {
-  struct ly_ctx *c = ctx.raw();
+std::span<const ModuleSpec> IetfRouting::requiredModules() {
+  // the interfaces subtree is parsed with IetfInterfaces
+  static const std::vector<ModuleSpec> modules = [] {
+    auto if_modules = IetfInterfaces::requiredModules();
+    std::vector<ModuleSpec> all(if_modules.begin(), if_modules.end());
+    all.emplace_back("ietf-routing", "2018-03-13", nullptr);
+    // destination prefixes and next-hop addresses of RIB routes
+    all.emplace_back("ietf-ipv4-unicast-routing", "2018-03-13", nullptr);
+    all.emplace_back("ietf-ipv6-unicast-routing", "2018-03-13", nullptr);
+    return all;
+  }();
+  return modules;
+}
 
-  struct lyd_node *root = nullptr;
-  check_ly_err(
-      ctx, lyd_new_path(nullptr, c, "/ietf-routing:routing", NULL, 0, &root));
+namespace {
 
-  // router-id
-  if (routing_.router_id.has_value()) {
-    struct lyd_node *tmp = nullptr;
-    check_ly_err(ctx, lyd_new_path(root, c, "router-id",
-                                   routing_.router_id->c_str(), 0, &tmp));
-  }
-
-  // interfaces leaf-list
-  for (const auto &ifname : routing_.interfaces) {
-    struct lyd_node *tmp = nullptr;
-    check_ly_err(ctx, lyd_new_path(root, c, "interfaces/interface",
-                                   ifname.c_str(), 0, &tmp));
-  }
-
-  // control-plane-protocol entries (type + name + description)
-  for (const auto &cpp : routing_.control_plane_protocols) {
-    std::string pred = "control-plane-protocols/control-plane-protocol[type='" +
-                       cpp.type + "'][name='" + cpp.name + "']";
-    struct lyd_node *tmp = nullptr;
-    check_ly_err(ctx, lyd_new_path(root, c, (pred + "/type").c_str(),
-                                   cpp.type.c_str(), 0, &tmp));
-    check_ly_err(ctx, lyd_new_path(root, c, (pred + "/name").c_str(),
-                                   cpp.name.c_str(), 0, &tmp));
-    if (cpp.description.has_value())
-      check_ly_err(ctx, lyd_new_path(root, c, (pred + "/description").c_str(),
-                                     cpp.description->c_str(), 0, &tmp));
-
-    // static-routes: create minimal entries
-    for (const auto &r : cpp.static_routes) {
-      if (r.route_preference.has_value()) {
-        struct lyd_node *tmp2 = nullptr;
-        check_ly_err(
-            ctx, lyd_new_path(
-                     root, c,
-                     (pred + "/static-routes/route/route-preference").c_str(),
-                     std::to_string(*r.route_preference).c_str(), 0, &tmp2));
-      }
-    }
-  }
-
-  // ribs
-  for (const auto &rib : routing_.ribs) {
-    std::string pred = "ribs/rib[name='" + rib.name + "']";
-    struct lyd_node *tmp = nullptr;
-    check_ly_err(ctx, lyd_new_path(root, c, (pred + "/name").c_str(),
-                                   rib.name.c_str(), 0, &tmp));
-    check_ly_err(ctx, lyd_new_path(root, c, (pred + "/address-family").c_str(),
-                                   rib.address_family.c_str(), 0, &tmp));
-    if (rib.description.has_value())
-      check_ly_err(ctx, lyd_new_path(root, c, (pred + "/description").c_str(),
-                                     rib.description->c_str(), 0, &tmp));
-    for (const auto &r : rib.routes) {
+  constexpr std::pair<std::string_view, IetfRouting::SpecialNextHop>
+      kSpecialNextHops[] = {
+          {"blackhole", IetfRouting::SpecialNextHop::Blackhole},
+          {"unreachable", IetfRouting::SpecialNextHop::Unreachable},
+          {"prohibit", IetfRouting::SpecialNextHop::Prohibit},
+          {"receive", IetfRouting::SpecialNextHop::Receive},
+  };
+
+  // Enum name; a literal, so data() is NUL-terminated.
+  std::string_view specialNextHopName(IetfRouting::SpecialNextHop special) {
+    for (const auto &[text, known] : kSpecialNextHops)
+      if (known == special)
+        return text;
+    return {};
+  }
+
+  // Modules of the nodes serialize() and write() create, resolved once per
+  // context. Destination prefixes and next-hop addresses of a family whose
+  // module is not implemented are not written.
+  struct RoutingSchema {
+    const struct lys_module *rt = nullptr;
+    const struct lys_module *v4 = nullptr;
+    const struct lys_module *v6 = nullptr;
+
+    explicit RoutingSchema(const YangContext &ctx)
+        : rt(implemented(ctx, "ietf-routing")),
+          v4(implemented(ctx, "ietf-ipv4-unicast-routing")),
+          v6(implemented(ctx, "ietf-ipv6-unicast-routing")) {
+      if (!rt)
+        throw YangDataError(ctx);
+    }
+
+    // Module of the IPv4 (index 1) or IPv6 (index 2) alternative of a
+    // destination prefix or next-hop address variant.
+    const struct lys_module *family(std::size_t index) const {
+      return index == 1 ? v4 : index == 2 ? v6 : nullptr;
+    }
+
+    static const struct lys_module *implemented(const YangContext &ctx,
+                                                std::string_view name) {
+      const struct lys_module *m = ctx.GetLoadedModuleByName(name).raw();
+      return m && m->implemented ? m : nullptr;
+    }
+  };
+
+  // Text of an inet prefix or address variant; empty for monostate.
+  template <typename... T>
+  std::string text(const std::variant<std::monostate, T...> &v) {
+    return std::visit(
+        [](const auto &x) -> std::string {
+          if constexpr (requires { x.toString(); })
+            return x.toString();
+          else
+            return {};
+        },
+        v);
+  }
+
+  // Values printed from typed fields are valid by construction; libyang
+  // need not check them again.
+  constexpr std::uint32_t kPrinted = LYD_NEW_VAL_STORE_ONLY;
+
+  // Frees a partially built tree if serialization throws.
+  struct TreeGuard {
+    struct lyd_node *root;
+    ~TreeGuard() {
+      if (root)
+        lyd_free_all(root);
+    }
+    struct lyd_node *release() { return std::exchange(root, nullptr); }
+  };
+
+  // Creates nodes under known parents with the cached modules, instead of
+  // resolving a path from the root for every leaf.
+  class TreeBuilder {
+  public:
+    TreeBuilder(const YangContext &ctx, const RoutingSchema &schema)
+        : ctx_(ctx), schema_(schema), rt_(schema.rt) {}
+
+    struct lyd_node *inner(struct lyd_node *parent, const char *name) {
+      struct lyd_node *node = nullptr;
+      check_ly_err(ctx_, lyd_new_inner(parent, rt_, name, 0, &node));
+      return node;
+    }
+
+    // Entry of a keyless list (the state lists under ribs).
+    struct lyd_node *entry(struct lyd_node *parent, const char *name) {
+      struct lyd_node *node = nullptr;
+      check_ly_err(ctx_, lyd_new_list(parent, rt_, name, 0, &node));
+      return node;
+    }
+
+    void term(struct lyd_node *parent, const char *name, const char *value,
+              std::uint32_t options = 0,
+              const struct lys_module *module = nullptr) {
+      check_ly_err(ctx_, lyd_new_term(parent, module ? module : rt_, name,
+                                      value, options, nullptr));
+    }
+
+    // The routes of a RIB, under its `routes` container.
+    void route(struct lyd_node *routes, const IetfRouting::Route &r) {
+      struct lyd_node *node = entry(routes, "route");
+      if (const auto *m = schema_.family(r.destination_prefix.index()))
+        term(node, "destination-prefix", text(r.destination_prefix).c_str(),
+             kPrinted, m);
       if (r.route_preference.has_value()) {
-        struct lyd_node *tmp2 = nullptr;
-        check_ly_err(
-            ctx, lyd_new_path(
-                     root, c, (pred + "/routes/route/route-preference").c_str(),
-                     std::to_string(*r.route_preference).c_str(), 0, &tmp2));
+        char digits[16] = {};
+        std::to_chars(digits, digits + sizeof(digits) - 1,
+                      *r.route_preference);
+        term(node, "route-preference", digits, kPrinted);
+      }
+      if (r.next_hop.has_value())
+        nextHop(inner(node, "next-hop"), *r.next_hop);
+      if (r.metadata.has_value()) {
+        const auto &meta = *r.metadata;
+        if (meta.source_protocol)
+          term(node, "source-protocol",
+               qualified(meta.source_protocol).c_str(), kPrinted);
+        if (meta.active)
+          term(node, "active", "");
+        if (meta.last_updated.has_value())
+          term(node, "last-updated", meta.last_updated->c_str());
+      }
+    }
+
+    // "module:name", formatted once per identity
+    const std::string &qualified(YangIdentity id) {
+      auto [it, inserted] = identities_.try_emplace(id);
+      if (inserted)
+        it->second = id.qualified();
+      return it->second;
+    }
+
+  private:
+    // One case of the next-hop-options choice: special, else list, else
+    // simple. The state next-hop list is keyless; entry indexes are not
+    // written.
+    void nextHop(struct lyd_node *parent, const IetfRouting::NextHop &hop) {
+      if (hop.special_next_hop.has_value()) {
+        term(parent, "special-next-hop",
+             specialNextHopName(*hop.special_next_hop).data(), kPrinted);
+      } else if (!hop.next_hop_list.empty()) {
+        struct lyd_node *list = inner(parent, "next-hop-list");
+        for (const auto &e : hop.next_hop_list) {
+          struct lyd_node *node = entry(list, "next-hop");
+          if (e.outgoing_interface.has_value())
+            term(node, "outgoing-interface", e.outgoing_interface->c_str());
+        }
+      } else {
+        if (hop.outgoing_interface.has_value())
+          term(parent, "outgoing-interface", hop.outgoing_interface->c_str());
+        if (const auto *m = schema_.family(hop.address.index()))
+          term(parent, "next-hop-address", text(hop.address).c_str(),
+               kPrinted, m);
+      }
+    }
+
+    const YangContext &ctx_;
+    const RoutingSchema &schema_;
+    const struct lys_module *rt_;
+    std::unordered_map<YangIdentity, std::string> identities_;
+  };
+
+} // namespace
+
+struct lyd_node *IetfRouting::serialize(const YangContext &ctx) const {
+  const auto schema = ctx.schemaCache<RoutingSchema>();
+  TreeBuilder b(ctx, *schema);
+
+  TreeGuard tree{nullptr};
+  check_ly_err(ctx,
+               lyd_new_inner(nullptr, schema->rt, "routing", 0, &tree.root));
+  struct lyd_node *root = tree.root;
+
+  if (routing_.router_id.has_value())
+    b.term(root, "router-id", routing_.router_id->c_str());
+
+  if (!routing_.interfaces.empty()) {
+    struct lyd_node *ifs = b.inner(root, "interfaces");
+    for (const auto &ifname : routing_.interfaces)
+      b.term(ifs, "interface", ifname.c_str());
+  }
+
+  // The base module defines no list under static-routes (the per-family
+  // augments do), so static routes are not serialized.
+  if (!routing_.control_plane_protocols.empty()) {
+    struct lyd_node *cpps = b.inner(root, "control-plane-protocols");
+    for (const auto &cpp : routing_.control_plane_protocols) {
+      struct lyd_node *entry = nullptr;
+      check_ly_err(ctx, lyd_new_list(cpps, schema->rt,
+                                     "control-plane-protocol", 0, &entry,
+                                     b.qualified(cpp.type).c_str(),
+                                     cpp.name.c_str()));
+      if (cpp.description.has_value())
+        b.term(entry, "description", cpp.description->c_str());
+    }
+  }
+
+  if (!routing_.ribs.empty()) {
+    struct lyd_node *ribs = b.inner(root, "ribs");
+    for (const auto &rib : routing_.ribs) {
+      struct lyd_node *entry = nullptr;
+      check_ly_err(ctx, lyd_new_list(ribs, schema->rt, "rib", 0, &entry,
+                                     rib.name.c_str()));
+      b.term(entry, "address-family",
+             b.qualified(rib.address_family).c_str(), kPrinted);
+      if (rib.description.has_value())
+        b.term(entry, "description", rib.description->c_str());
+      if (!rib.routes.empty()) {
+        struct lyd_node *routes = b.inner(entry, "routes");
+        for (const auto &r : rib.routes)
+          b.route(routes, r);
       }
     }
   }
 
-  return root;
+  return tree.release();
 }
 
-static struct lyd_node *find_child_by_name(struct lyd_node *parent,
-                                           const char *name) {
-  if (!parent)
-    return nullptr;
-  for (struct lyd_node *c = lyd_child(parent); c; c = c->next) {
-    if (c->schema && c->schema->name && strcmp(c->schema->name, name) == 0)
-      return c;
+namespace {
+
+  // One route entry, children in schema order: the augmented
+  // destination-prefix comes last.
+  void writeRoute(YangWriter &w, const RoutingSchema &schema,
+                  const IetfRouting::Route &r) {
+    static constexpr const char *rt = "ietf-routing";
+    w.beginEntry();
+    if (r.route_preference.has_value())
+      w.leaf(rt, "route-preference", *r.route_preference);
+    if (r.next_hop.has_value()) {
+      // the same case of next-hop-options as serialize()
+      const auto &hop = *r.next_hop;
+      w.beginContainer(rt, "next-hop");
+      if (hop.special_next_hop.has_value()) {
+        w.leaf(rt, "special-next-hop",
+               specialNextHopName(*hop.special_next_hop));
+      } else if (!hop.next_hop_list.empty()) {
+        w.beginContainer(rt, "next-hop-list");
+        w.beginList(rt, "next-hop");
+        for (const auto &e : hop.next_hop_list) {
+          w.beginEntry();
+          if (e.outgoing_interface.has_value())
+            w.leaf(rt, "outgoing-interface", *e.outgoing_interface);
+          w.endEntry();
+        }
+        w.endList();
+        w.endContainer();
+      } else {
+        if (hop.outgoing_interface.has_value())
+          w.leaf(rt, "outgoing-interface", *hop.outgoing_interface);
+        if (const auto *m = schema.family(hop.address.index()))
+          w.leaf(m->name, "next-hop-address", text(hop.address));
+      }
+      w.endContainer();
+    }
+    if (r.metadata.has_value()) {
+      const auto &meta = *r.metadata;
+      if (meta.source_protocol)
+        w.identity(rt, "source-protocol", meta.source_protocol.name(),
+                   meta.source_protocol.module());
+      if (meta.active)
+        w.empty(rt, "active");
+      if (meta.last_updated.has_value())
+        w.leaf(rt, "last-updated", *meta.last_updated);
+    }
+    if (const auto *m = schema.family(r.destination_prefix.index()))
+      w.leaf(m->name, "destination-prefix", text(r.destination_prefix));
+    w.endEntry();
+  }
+
+} // namespace
+
+void IetfRouting::write(YangWriter &w) const {
+  static constexpr const char *rt = "ietf-routing";
+  const auto schema = w.context().schemaCache<RoutingSchema>();
+
+  w.beginContainer(rt, "routing");
+  if (routing_.router_id.has_value())
+    w.leaf(rt, "router-id", *routing_.router_id);
+
+  if (!routing_.interfaces.empty()) {
+    w.beginContainer(rt, "interfaces");
+    w.leafList(rt, "interface", routing_.interfaces);
+    w.endContainer();
+  }
+
+  // The base module defines no list under static-routes (the per-family
+  // augments do), so static routes are not streamed.
+  if (!routing_.control_plane_protocols.empty()) {
+    w.beginContainer(rt, "control-plane-protocols");
+    w.beginList(rt, "control-plane-protocol");
+    for (const auto &cpp : routing_.control_plane_protocols) {
+      w.beginEntry();
+      w.identity(rt, "type", cpp.type.name(), cpp.type.module());
+      w.leaf(rt, "name", cpp.name);
+      if (cpp.description.has_value())
+        w.leaf(rt, "description", *cpp.description);
+      w.endEntry();
+    }
+    w.endList();
+    w.endContainer();
   }
-  return nullptr;
-}
 
-static const char *get_node_value(struct lyd_node *n) {
-  if (!n)
-    return nullptr;
-  return lyd_get_value(n);
+  if (!routing_.ribs.empty()) {
+    w.beginContainer(rt, "ribs");
+    w.beginList(rt, "rib");
+    for (const auto &rib : routing_.ribs) {
+      w.beginEntry();
+      w.leaf(rt, "name", rib.name);
+      w.identity(rt, "address-family", rib.address_family.name(),
+                 rib.address_family.module());
+      if (!rib.routes.empty()) {
+        w.beginContainer(rt, "routes");
+        w.beginList(rt, "route");
+        for (const auto &r : rib.routes)
+          writeRoute(w, *schema, r);
+        w.endList();
+        w.endContainer();
+      }
+      // description follows routes in the schema
+      if (rib.description.has_value())
+        w.leaf(rt, "description", *rib.description);
+      w.endEntry();
+    }
+    w.endList();
+    w.endContainer();
+  }
+  w.endContainer();
 }
 
+namespace {
+
+  using Routing = IetfRouting::Routing;
+  struct RoutingParser;
+
+  template <typename Target>
+  using RoutingDispatch =
+      detail::SchemaDispatch<const RoutingParser &, Target &>;
+
+  // Field handlers for deserialize(), keyed by schema node and built once
+  // per context. Containers that only wrap a list or leaf-list get a table
+  // of their own holding that one child.
+  struct RoutingParser {
+    // identityref values resolve to handles through the context's table
+    std::shared_ptr<const YangIdentityTable> identities;
+    RoutingDispatch<Routing> routing;
+    RoutingDispatch<Routing> interfaces;
+    RoutingDispatch<Routing> cpps;
+    RoutingDispatch<IetfRouting::ControlPlaneProtocol> cpp;
+    RoutingDispatch<Routing> ribs;
+    RoutingDispatch<IetfRouting::Rib> rib;
+    RoutingDispatch<std::vector<IetfRouting::Route>> routes;
+    RoutingDispatch<IetfRouting::Route> route;
+    RoutingDispatch<IetfRouting::NextHop> next_hop;
+    RoutingDispatch<IetfRouting::NextHop> next_hop_list;
+    detail::SchemaDispatch<IetfRouting::NextHopListEntry &> next_hop_entry;
+
+    explicit RoutingParser(const YangContext &ctx);
+  };
+
+  const char *value(struct lyd_node *n) { return lyd_get_value(n); }
+
+  IetfRouting::RouteMetadata &metadata(IetfRouting::Route &r) {
+    if (!r.metadata)
+      r.metadata.emplace();
+    return *r.metadata;
+  }
+
+  // Binary form of an inet address or prefix leaf. A zone index, which
+  // ipv4-address and ipv6-address allow, is dropped.
+  template <typename T> std::optional<T> parsed(struct lyd_node *n) {
+    std::string_view v = YangValue(n).canonical();
+    return T::parse(v.substr(0, v.find('%')));
+  }
+
+  RoutingParser::RoutingParser(const YangContext &ctx)
+      : identities(ctx.schemaCache<YangIdentityTable>()) {
+    const struct ly_ctx *c = ctx.raw();
+    auto at = [](const char *node) {
+      return std::string("/ietf-routing:routing/") + node;
+    };
+    const std::string cpp_list =
+        at("control-plane-protocols/control-plane-protocol");
+
+    routing.add(c, at("router-id").c_str(),
+                [](struct lyd_node *n, const RoutingParser &, Routing &r) {
+                  r.router_id = value(n);
+                });
+    routing.add(c, at("interfaces").c_str(),
+                [](struct lyd_node *n, const RoutingParser &p, Routing &r) {
+                  p.interfaces.dispatch(n, p, r);
+                });
+    routing.add(c, at("control-plane-protocols").c_str(),
+                [](struct lyd_node *n, const RoutingParser &p, Routing &r) {
+                  p.cpps.dispatch(n, p, r);
+                });
+    routing.add(c, at("ribs").c_str(),
+                [](struct lyd_node *n, const RoutingParser &p, Routing &r) {
+                  p.ribs.dispatch(n, p, r);
+                });
+
+    // routing-local interfaces leaf-list: append any names that are not
+    // already present from the parsed top-level interfaces
+    interfaces.add(c, at("interfaces/interface").c_str(),
+                   [](struct lyd_node *n, const RoutingParser &, Routing &r) {
+                     const char *name = value(n);
+                     for (const auto &known : r.interfaces)
+                       if (known == name)
+                         return;
+                     r.interfaces.emplace_back(name);
+                   });
+
+    cpps.add(c, cpp_list.c_str(),
+             [](struct lyd_node *n, const RoutingParser &p, Routing &r) {
+               IetfRouting::ControlPlaneProtocol cp;
+               p.cpp.dispatch(n, p, cp);
+               r.control_plane_protocols.push_back(std::move(cp));
+             });
+    cpp.add(c, (cpp_list + "/type").c_str(),
+            [](struct lyd_node *n, const RoutingParser &p,
+               IetfRouting::ControlPlaneProtocol &cp) {
+              cp.type = (*p.identities)[YangValue(n).identity()];
+            });
+    cpp.add(c, (cpp_list + "/name").c_str(),
+            [](struct lyd_node *n, const RoutingParser &,
+               IetfRouting::ControlPlaneProtocol &cp) { cp.name = value(n); });
+    cpp.add(c, (cpp_list + "/description").c_str(),
+            [](struct lyd_node *n, const RoutingParser &,
+               IetfRouting::ControlPlaneProtocol &cp) {
+              cp.description = value(n);
+            });
+    // The base module defines no list under static-routes (the per-family
+    // augments do), so there are no static routes to collect.
+
+    ribs.add(c, at("ribs/rib").c_str(),
+             [](struct lyd_node *n, const RoutingParser &p, Routing &r) {
+               IetfRouting::Rib entry;
+               p.rib.dispatch(n, p, entry);
+               r.ribs.push_back(std::move(entry));
+             });
+    rib.add(c, at("ribs/rib/name").c_str(),
+            [](struct lyd_node *n, const RoutingParser &,
+               IetfRouting::Rib &r) { r.name = value(n); });
+    rib.add(c, at("ribs/rib/address-family").c_str(),
+            [](struct lyd_node *n, const RoutingParser &p,
+               IetfRouting::Rib &r) {
+              r.address_family = (*p.identities)[YangValue(n).identity()];
+            });
+    rib.add(c, at("ribs/rib/description").c_str(),
+            [](struct lyd_node *n, const RoutingParser &,
+               IetfRouting::Rib &r) { r.description = value(n); });
+    rib.add(c, at("ribs/rib/routes").c_str(),
+            [](struct lyd_node *n, const RoutingParser &p,
+               IetfRouting::Rib &r) { p.routes.dispatch(n, p, r.routes); });
+    routes.add(c, at("ribs/rib/routes/route").c_str(),
+               [](struct lyd_node *n, const RoutingParser &p,
+                  std::vector<IetfRouting::Route> &r) {
+                 IetfRouting::Route route;
+                 p.route.dispatch(n, p, route);
+                 r.push_back(std::move(route));
+               });
+
+    using Route = IetfRouting::Route;
+    const std::string route_at = at("ribs/rib/routes/route/");
+    auto route_add = [&](const std::string &node,
+                         RoutingDispatch<Route>::Handler handler) {
+      route.add(c, (route_at + node).c_str(), handler);
+    };
+    route_add("ietf-ipv4-unicast-routing:destination-prefix",
+              [](struct lyd_node *n, const RoutingParser &, Route &r) {
+                if (auto prefix = parsed<Ipv4Prefix>(n))
+                  r.destination_prefix = *prefix;
+              });
+    route_add("ietf-ipv6-unicast-routing:destination-prefix",
+              [](struct lyd_node *n, const RoutingParser &, Route &r) {
+                if (auto prefix = parsed<Ipv6Prefix>(n))
+                  r.destination_prefix = *prefix;
+              });
+    route_add("route-preference",
+              [](struct lyd_node *n, const RoutingParser &, Route &r) {
+                r.route_preference = YangValue(n).as<uint32_t>();
+              });
+    route_add("next-hop",
+              [](struct lyd_node *n, const RoutingParser &p, Route &r) {
+                p.next_hop.dispatch(n, p, r.next_hop.emplace());
+              });
+    route_add("source-protocol",
+              [](struct lyd_node *n, const RoutingParser &p, Route &r) {
+                metadata(r).source_protocol =
+                    (*p.identities)[YangValue(n).identity()];
+              });
+    route_add("active", [](struct lyd_node *, const RoutingParser &,
+                           Route &r) { metadata(r).active = true; });
+    route_add("last-updated",
+              [](struct lyd_node *n, const RoutingParser &, Route &r) {
+                metadata(r).last_updated = value(n);
+              });
+
+    // the cases of the next-hop-options choice
+    using NextHop = IetfRouting::NextHop;
+    const std::string hop_at = route_at + "next-hop/";
+    auto hop_add = [&](const std::string &node,
+                       RoutingDispatch<NextHop>::Handler handler) {
+      next_hop.add(c, (hop_at + node).c_str(), handler);
+    };
+    hop_add("outgoing-interface",
+            [](struct lyd_node *n, const RoutingParser &, NextHop &h) {
+              h.outgoing_interface = value(n);
+            });
+    hop_add("ietf-ipv4-unicast-routing:next-hop-address",
+            [](struct lyd_node *n, const RoutingParser &, NextHop &h) {
+              if (auto address = parsed<Ipv4Address>(n))
+                h.address = *address;
+            });
+    hop_add("ietf-ipv6-unicast-routing:next-hop-address",
+            [](struct lyd_node *n, const RoutingParser &, NextHop &h) {
+              if (auto address = parsed<Ipv6Address>(n))
+                h.address = *address;
+            });
+    hop_add("special-next-hop",
+            [](struct lyd_node *n, const RoutingParser &, NextHop &h) {
+              const std::string_view name = YangValue(n).enumName();
+              for (const auto &[text, special] : kSpecialNextHops)
+                if (text == name)
+                  h.special_next_hop = special;
+            });
+    hop_add("next-hop-list",
+            [](struct lyd_node *n, const RoutingParser &p, NextHop &h) {
+              p.next_hop_list.dispatch(n, p, h);
+            });
+
+    // the state list is keyless: entries keep an empty index
+    const std::string list_at = hop_at + "next-hop-list/next-hop";
+    next_hop_list.add(
+        c, list_at.c_str(),
+        [](struct lyd_node *n, const RoutingParser &p, NextHop &h) {
+          p.next_hop_entry.dispatch(n, h.next_hop_list.emplace_back());
+        });
+    next_hop_entry.add(c, (list_at + "/outgoing-interface").c_str(),
+                       [](struct lyd_node *n,
+                          IetfRouting::NextHopListEntry &e) {
+                         e.outgoing_interface = value(n);
+                       });
+  }
+
+} // namespace
+
 std::unique_ptr<IetfRouting> IetfRouting::deserialize(const YangContext &ctx,
                                                       struct lyd_node *tree) {
   if (!tree)
@@ -106,8 +589,6 @@ std::unique_ptr<IetfRouting> IetfRouting::deserialize(const YangContext &ctx,
 
   auto model = std::make_unique<IetfRouting>();
 
-  const char *v = nullptr;
-
   // 1) If a top-level /ietf-interfaces:interfaces exists, parse it first
   //    so the routing model can obtain full interface objects up-front.
   struct lyd_node *ifs_tree = nullptr;
@@ -135,121 +616,433 @@ std::unique_ptr<IetfRouting> IetfRouting::deserialize(const YangContext &ctx,
   if (!rt)
     throw YangDataError(ctx);
 
-  // router-id
-  struct lyd_node *rid = find_child_by_name(rt, "router-id");
-  if (rid && (v = get_node_value(rid)))
-    model->mutableRouting().router_id = std::string(v);
-
-  // routing-local interfaces leaf-list: append any names that are not
-  // already present from the parsed top-level interfaces above.
-  struct lyd_node *ifs = find_child_by_name(rt, "interfaces");
-  if (ifs) {
-    for (struct lyd_node *ch = lyd_child(ifs); ch; ch = ch->next) {
-      if (!ch->schema || !ch->schema->name)
-        continue;
-      if (strcmp(ch->schema->name, "interface") == 0) {
-        const char *val = get_node_value(ch);
-        if (val) {
-          bool found = false;
-          for (const auto &n : model->mutableRouting().interfaces) {
-            if (n == val) {
-              found = true;
-              break;
-            }
-          }
-          if (!found)
-            model->mutableRouting().interfaces.push_back(std::string(val));
+  // 3) one pass over each node's children, dispatched on the schema node
+  const auto parser = ctx.schemaCache<RoutingParser>();
+  parser->routing.dispatch(rt, *parser, model->routing_);
+
+  return model;
+}
+
+namespace {
+
+  // SIDs of the nodes IetfRouting encodes, looked up once per call.
+  // Choice and case nodes have no SID: the next-hop-options cases sit
+  // directly under next-hop.
+  struct RoutingSids {
+    const SidMap &map;
+    SidRef routing, router_id, interfaces, interface, cpps, cpp, cpp_type,
+        cpp_name, cpp_description, ribs, rib, rib_name, address_family,
+        rib_description, routes, route, destination_prefix_v4,
+        destination_prefix_v6, route_preference, next_hop,
+        outgoing_interface, next_hop_address_v4, next_hop_address_v6,
+        special_next_hop, next_hop_list, next_hop_entry,
+        entry_outgoing_interface, source_protocol, active, last_updated;
+
+    static std::string at(const char *node) {
+      return std::string("/ietf-routing:routing/") + node;
+    }
+    // prefixes of the nodes the per-family modules augment in
+    static constexpr const char *kV4 = "/ietf-ipv4-unicast-routing:";
+    static constexpr const char *kV6 = "/ietf-ipv6-unicast-routing:";
+
+    explicit RoutingSids(const SidMap &m)
+        : map(m), routing(m, "/ietf-routing:routing"),
+          router_id(m, at("router-id")), interfaces(m, at("interfaces")),
+          interface(m, at("interfaces/interface")),
+          cpps(m, at("control-plane-protocols")),
+          cpp(m, at("control-plane-protocols/control-plane-protocol")),
+          cpp_type(m, cpp.path() + "/type"), cpp_name(m, cpp.path() + "/name"),
+          cpp_description(m, cpp.path() + "/description"),
+          ribs(m, at("ribs")), rib(m, at("ribs/rib")),
+          rib_name(m, at("ribs/rib/name")),
+          address_family(m, at("ribs/rib/address-family")),
+          rib_description(m, at("ribs/rib/description")),
+          routes(m, at("ribs/rib/routes")),
+          route(m, at("ribs/rib/routes/route")),
+          destination_prefix_v4(m, route.path() + kV4 + "destination-prefix"),
+          destination_prefix_v6(m, route.path() + kV6 + "destination-prefix"),
+          route_preference(m, route.path() + "/route-preference"),
+          next_hop(m, route.path() + "/next-hop"),
+          outgoing_interface(m, next_hop.path() + "/outgoing-interface"),
+          next_hop_address_v4(m, next_hop.path() + kV4 + "next-hop-address"),
+          next_hop_address_v6(m, next_hop.path() + kV6 + "next-hop-address"),
+          special_next_hop(m, next_hop.path() + "/special-next-hop"),
+          next_hop_list(m, next_hop.path() + "/next-hop-list"),
+          next_hop_entry(m, next_hop_list.path() + "/next-hop"),
+          entry_outgoing_interface(
+              m, next_hop_entry.path() + "/outgoing-interface"),
+          source_protocol(m, route.path() + "/source-protocol"),
+          active(m, route.path() + "/active"),
+          last_updated(m, route.path() + "/last-updated") {}
+
+    // SID of the IPv4 (index 1) or IPv6 (index 2) alternative, like
+    // RoutingSchema::family()
+    static const SidRef &family(std::size_t index, const SidRef &v4,
+                                const SidRef &v6) {
+      return index == 1 ? v4 : v6;
+    }
+  };
+
+  YangIdentity readCborIdentity(CborReader &r, const SidMap &sids) {
+    return YangIdentity::parse(r.readIdentity(sids), "ietf-routing");
+  }
+
+  // special-next-hop is an enumeration without explicit values, so each
+  // name is sent as its position in the schema (RFC 9254 6.6)
+  std::uint64_t specialNextHopValue(IetfRouting::SpecialNextHop special) {
+    std::uint64_t value = 0;
+    while (kSpecialNextHops[value].second != special)
+      ++value;
+    return value;
+  }
+
+  IetfRouting::SpecialNextHop readCborSpecialNextHop(CborReader &r) {
+    const auto type = r.next();
+    if (type == CborReader::Type::Text) { // by name, as in a union (tag 44)
+      for (const auto &[text, special] : kSpecialNextHops)
+        if (text == r.payload())
+          return special;
+    } else if (type == CborReader::Type::Unsigned &&
+               r.argument() < std::size(kSpecialNextHops)) {
+      return kSpecialNextHops[r.argument()].second;
+    }
+    r.fail("bad special-next-hop value");
+  }
+
+  // An inet prefix or address leaf, in its text form.
+  template <typename T> T readCborInet(CborReader &r, const char *what) {
+    auto parsed = T::parse(r.readText());
+    if (!parsed)
+      r.fail(what);
+    return *parsed;
+  }
+
+  // The case of next-hop-options that write() picks: special, else the
+  // list, else the simple next hop.
+  void writeCborNextHop(CborWriter &w, const RoutingSids &s,
+                        const IetfRouting::NextHop &hop) {
+    const std::uint64_t p = *s.next_hop;
+    if (hop.special_next_hop.has_value()) {
+      w.beginMap(1);
+      w.key(*s.special_next_hop, p);
+      w.unsignedInt(specialNextHopValue(*hop.special_next_hop));
+    } else if (!hop.next_hop_list.empty()) {
+      const std::uint64_t container = *s.next_hop_list;
+      const std::uint64_t list = *s.next_hop_entry;
+      w.beginMap(1);
+      w.key(container, p);
+      w.beginMap(1);
+      w.key(list, container);
+      w.beginArray(hop.next_hop_list.size());
+      for (const auto &e : hop.next_hop_list) {
+        w.beginMap(e.outgoing_interface.has_value());
+        if (e.outgoing_interface.has_value()) {
+          w.key(*s.entry_outgoing_interface, list);
+          w.text(*e.outgoing_interface);
         }
       }
+    } else {
+      const std::size_t family = hop.address.index();
+      w.beginMap(hop.outgoing_interface.has_value() + (family != 0));
+      if (hop.outgoing_interface.has_value()) {
+        w.key(*s.outgoing_interface, p);
+        w.text(*hop.outgoing_interface);
+      }
+      if (family != 0) {
+        w.key(*RoutingSids::family(family, s.next_hop_address_v4,
+                                   s.next_hop_address_v6),
+              p);
+        w.text(text(hop.address));
+      }
     }
   }
 
-  // control-plane-protocols
-  struct lyd_node *cpps = find_child_by_name(rt, "control-plane-protocols");
-  if (cpps) {
-    for (struct lyd_node *entry = lyd_child(cpps); entry; entry = entry->next) {
-      if (!entry->schema || !entry->schema->name)
-        continue;
-      if (strcmp(entry->schema->name, "control-plane-protocol") != 0)
-        continue;
-      ControlPlaneProtocol cp;
-      struct lyd_node *t = find_child_by_name(entry, "type");
-      if (t && (v = get_node_value(t))) {
-        std::string sv(v);
-        auto pos = sv.find(':');
-        if (pos != std::string::npos)
-          sv = sv.substr(pos + 1);
-        cp.type = sv;
-      }
-      struct lyd_node *nnode = find_child_by_name(entry, "name");
-      if (nnode && (v = get_node_value(nnode)))
-        cp.name = v;
-      struct lyd_node *d = find_child_by_name(entry, "description");
-      if (d && (v = get_node_value(d)))
-        cp.description = std::string(v);
-
-      // static-routes (parse route-preference)
-      struct lyd_node *sr = find_child_by_name(entry, "static-routes");
-      if (sr) {
-        for (struct lyd_node *r = lyd_child(sr); r; r = r->next) {
-          if (!r->schema || !r->schema->name)
-            continue;
-          if (strcmp(r->schema->name, "route") != 0)
+  // One route entry, with the same leaves as write().
+  void writeCborRoute(CborWriter &w, const RoutingSids &s,
+                      const IetfRouting::Route &r) {
+    const std::uint64_t p = *s.route;
+    const std::size_t family = r.destination_prefix.index();
+    const IetfRouting::RouteMetadata none;
+    const auto &meta = r.metadata ? *r.metadata : none;
+    const bool source = static_cast<bool>(meta.source_protocol);
+    w.beginMap((family != 0) + r.route_preference.has_value() +
+               r.next_hop.has_value() + source + meta.active +
+               meta.last_updated.has_value());
+    if (family != 0) {
+      w.key(*RoutingSids::family(family, s.destination_prefix_v4,
+                                 s.destination_prefix_v6),
+            p);
+      w.text(text(r.destination_prefix));
+    }
+    if (r.route_preference.has_value()) {
+      w.key(*s.route_preference, p);
+      w.unsignedInt(*r.route_preference);
+    }
+    if (r.next_hop.has_value()) {
+      w.key(*s.next_hop, p);
+      writeCborNextHop(w, s, *r.next_hop);
+    }
+    if (source) {
+      w.key(*s.source_protocol, p);
+      w.identity(s.map, meta.source_protocol.qualified());
+    }
+    if (meta.active) {
+      w.key(*s.active, p);
+      w.null(); // type empty (RFC 9254 6.11)
+    }
+    if (meta.last_updated.has_value()) {
+      w.key(*s.last_updated, p);
+      w.text(*meta.last_updated);
+    }
+  }
+
+  void writeCborRib(CborWriter &w, const RoutingSids &s,
+                    const IetfRouting::Rib &rib) {
+    const std::uint64_t p = *s.rib;
+    w.beginMap(2 + !rib.routes.empty() + rib.description.has_value());
+    w.key(*s.rib_name, p);
+    w.text(rib.name);
+    w.key(*s.address_family, p);
+    w.identity(s.map, rib.address_family.qualified());
+    if (!rib.routes.empty()) {
+      const std::uint64_t container = *s.routes;
+      w.key(container, p);
+      w.beginMap(1);
+      w.key(*s.route, container);
+      w.beginArray(rib.routes.size());
+      for (const auto &r : rib.routes)
+        writeCborRoute(w, s, r);
+    }
+    if (rib.description.has_value()) {
+      w.key(*s.rib_description, p);
+      w.text(*rib.description);
+    }
+  }
+
+  IetfRouting::NextHop readCborNextHop(CborReader &r, const RoutingSids &s,
+                                       std::uint64_t p) {
+    IetfRouting::NextHop hop;
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t sid = p + r.readInteger();
+      if (s.outgoing_interface == sid) {
+        hop.outgoing_interface = std::string(r.readText());
+      } else if (s.next_hop_address_v4 == sid) {
+        hop.address = readCborInet<Ipv4Address>(r, "bad next-hop-address");
+      } else if (s.next_hop_address_v6 == sid) {
+        hop.address = readCborInet<Ipv6Address>(r, "bad next-hop-address");
+      } else if (s.special_next_hop == sid) {
+        hop.special_next_hop = readCborSpecialNextHop(r);
+      } else if (s.next_hop_list == sid) {
+        auto lists = r.expectMap();
+        while (r.more(lists)) {
+          const std::uint64_t list = sid + r.readInteger();
+          if (!(s.next_hop_entry == list)) {
+            r.skip();
             continue;
-          Route route;
-          struct lyd_node *rp = find_child_by_name(r, "route-preference");
-          if (rp && (v = get_node_value(rp)))
-            route.route_preference = static_cast<uint32_t>(std::stoul(v));
-          cp.static_routes.push_back(route);
+          }
+          auto entries = r.expectArray();
+          while (r.more(entries)) {
+            auto &entry = hop.next_hop_list.emplace_back();
+            auto leaves = r.expectMap();
+            while (r.more(leaves)) {
+              if (s.entry_outgoing_interface == list + r.readInteger())
+                entry.outgoing_interface = std::string(r.readText());
+              else
+                r.skip();
+            }
+          }
         }
+      } else {
+        r.skip();
       }
+    }
+    return hop;
+  }
 
-      model->mutableRouting().control_plane_protocols.push_back(cp);
+  IetfRouting::Route readCborRoute(CborReader &r, const RoutingSids &s,
+                                   std::uint64_t p) {
+    IetfRouting::Route route;
+    auto leaves = r.expectMap();
+    while (r.more(leaves)) {
+      const std::uint64_t sid = p + r.readInteger();
+      if (s.destination_prefix_v4 == sid) {
+        route.destination_prefix =
+            readCborInet<Ipv4Prefix>(r, "bad destination-prefix");
+      } else if (s.destination_prefix_v6 == sid) {
+        route.destination_prefix =
+            readCborInet<Ipv6Prefix>(r, "bad destination-prefix");
+      } else if (s.route_preference == sid) {
+        route.route_preference = static_cast<uint32_t>(r.readUnsigned());
+      } else if (s.next_hop == sid) {
+        route.next_hop = readCborNextHop(r, s, sid);
+      } else if (s.source_protocol == sid) {
+        metadata(route).source_protocol = readCborIdentity(r, s.map);
+      } else if (s.active == sid) {
+        r.skip(); // the null of type empty
+        metadata(route).active = true;
+      } else if (s.last_updated == sid) {
+        metadata(route).last_updated = std::string(r.readText());
+      } else {
+        r.skip();
+      }
     }
+    return route;
   }
 
-  // ribs
-  struct lyd_node *ribs = find_child_by_name(rt, "ribs");
-  if (ribs) {
-    for (struct lyd_node *entry = lyd_child(ribs); entry; entry = entry->next) {
-      if (!entry->schema || !entry->schema->name)
-        continue;
-      if (strcmp(entry->schema->name, "rib") != 0)
-        continue;
-      Rib rib;
-      struct lyd_node *nnode = find_child_by_name(entry, "name");
-      if (nnode && (v = get_node_value(nnode)))
-        rib.name = v;
-      struct lyd_node *af = find_child_by_name(entry, "address-family");
-      if (af && (v = get_node_value(af))) {
-        std::string sv(v);
-        auto pos = sv.find(':');
-        if (pos != std::string::npos)
-          sv = sv.substr(pos + 1);
-        rib.address_family = sv;
-      }
-      struct lyd_node *desc = find_child_by_name(entry, "description");
-      if (desc && (v = get_node_value(desc)))
-        rib.description = std::string(v);
-
-      struct lyd_node *routes = find_child_by_name(entry, "routes");
-      if (routes) {
-        for (struct lyd_node *r = lyd_child(routes); r; r = r->next) {
-          if (!r->schema || !r->schema->name)
+  IetfRouting::Rib readCborRib(CborReader &r, const RoutingSids &s,
+                               std::uint64_t p) {
+    IetfRouting::Rib rib;
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t sid = p + r.readInteger();
+      if (s.rib_name == sid) {
+        rib.name = r.readText();
+      } else if (s.address_family == sid) {
+        rib.address_family = readCborIdentity(r, s.map);
+      } else if (s.rib_description == sid) {
+        rib.description = std::string(r.readText());
+      } else if (s.routes == sid) {
+        auto routes = r.expectMap();
+        while (r.more(routes)) {
+          const std::uint64_t list = sid + r.readInteger();
+          if (!(s.route == list)) {
+            r.skip();
             continue;
-          if (strcmp(r->schema->name, "route") != 0)
-            continue;
-          Route route;
-          struct lyd_node *rp = find_child_by_name(r, "route-preference");
-          if (rp && (v = get_node_value(rp)))
-            route.route_preference = static_cast<uint32_t>(std::stoul(v));
-          rib.routes.push_back(route);
+          }
+          auto entries = r.expectArray();
+          while (r.more(entries))
+            rib.routes.push_back(readCborRoute(r, s, list));
         }
+      } else {
+        r.skip();
       }
+    }
+    return rib;
+  }
+
+} // namespace
 
-      model->mutableRouting().ribs.push_back(rib);
+void IetfRouting::writeCbor(const SidMap &sids, YangOutput &out) const {
+  const RoutingSids s(sids);
+  CborWriter w(out);
+  const std::uint64_t top = *s.routing;
+  w.beginMap(1);
+  w.key(top);
+  w.beginMap(routing_.router_id.has_value() + !routing_.interfaces.empty() +
+             !routing_.control_plane_protocols.empty() +
+             !routing_.ribs.empty());
+
+  if (routing_.router_id.has_value()) {
+    w.key(*s.router_id, top);
+    w.text(*routing_.router_id);
+  }
+
+  if (!routing_.interfaces.empty()) {
+    const std::uint64_t container = *s.interfaces;
+    w.key(container, top);
+    w.beginMap(1);
+    w.key(*s.interface, container);
+    w.beginArray(routing_.interfaces.size());
+    for (const auto &name : routing_.interfaces)
+      w.text(name);
+  }
+
+  if (!routing_.control_plane_protocols.empty()) {
+    const std::uint64_t container = *s.cpps;
+    const std::uint64_t list = *s.cpp;
+    w.key(container, top);
+    w.beginMap(1);
+    w.key(list, container);
+    w.beginArray(routing_.control_plane_protocols.size());
+    for (const auto &cpp : routing_.control_plane_protocols) {
+      w.beginMap(2 + cpp.description.has_value());
+      w.key(*s.cpp_type, list);
+      w.identity(sids, cpp.type.qualified());
+      w.key(*s.cpp_name, list);
+      w.text(cpp.name);
+      if (cpp.description.has_value()) {
+        w.key(*s.cpp_description, list);
+        w.text(*cpp.description);
+      }
     }
   }
 
+  if (!routing_.ribs.empty()) {
+    const std::uint64_t container = *s.ribs;
+    w.key(container, top);
+    w.beginMap(1);
+    w.key(*s.rib, container);
+    w.beginArray(routing_.ribs.size());
+    for (const auto &rib : routing_.ribs)
+      writeCborRib(w, s, rib);
+  }
+  out.flush();
+}
+
+std::unique_ptr<IetfRouting> IetfRouting::readCbor(const SidMap &sids,
+                                                   YangInput &in) {
+  const RoutingSids s(sids);
+  CborReader r(in);
+  auto model = std::make_unique<IetfRouting>();
+  Routing &routing = model->routing_;
+
+  // the leaf-list and both lists sit alone in a container: {key: [...]}
+  auto list_in = [&](std::uint64_t container, const SidRef &list,
+                     const std::function<void()> &entry) {
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      if (!(list == container + r.readInteger())) {
+        r.skip();
+        continue;
+      }
+      auto entries = r.expectArray();
+      while (r.more(entries))
+        entry();
+    }
+  };
+
+  auto top = r.expectMap();
+  while (r.more(top)) {
+    const std::uint64_t rt = static_cast<std::uint64_t>(r.readInteger());
+    if (!(s.routing == rt)) {
+      r.skip();
+      continue;
+    }
+    auto members = r.expectMap();
+    while (r.more(members)) {
+      const std::uint64_t sid = rt + r.readInteger();
+      if (s.router_id == sid) {
+        routing.router_id = std::string(r.readText());
+      } else if (s.interfaces == sid) {
+        list_in(sid, s.interface,
+                [&] { routing.interfaces.emplace_back(r.readText()); });
+      } else if (s.cpps == sid) {
+        list_in(sid, s.cpp, [&] {
+          const std::uint64_t list = *s.cpp; // matched, so known
+          ControlPlaneProtocol cpp;
+          auto leaves = r.expectMap();
+          while (r.more(leaves)) {
+            const std::uint64_t leaf = list + r.readInteger();
+            if (s.cpp_type == leaf)
+              cpp.type = readCborIdentity(r, sids);
+            else if (s.cpp_name == leaf)
+              cpp.name = r.readText();
+            else if (s.cpp_description == leaf)
+              cpp.description = std::string(r.readText());
+            else
+              r.skip();
+          }
+          routing.control_plane_protocols.push_back(std::move(cpp));
+        });
+      } else if (s.ribs == sid) {
+        list_in(sid, s.rib, [&] {
+          routing.ribs.push_back(readCborRib(r, s, *s.rib));
+        });
+      } else {
+        r.skip();
+      }
+    }
+  }
   return model;
 }
@@ -0,0 +1,304 @@
+#include "ModuleIndex.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+using namespace yang;
+
+static constexpr const char *kIndexHeader = "yang-module-index 1";
+
+static bool statMtime(const std::string &path, std::int64_t &sec,
+                      std::int64_t &nsec) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0)
+    return false;
+  sec = st.st_mtim.tv_sec;
+  nsec = st.st_mtim.tv_nsec;
+  return true;
+}
+
+// "name@revision.yang" -> {name, revision}; "name.yin" -> {name, ""}.
+static bool parseFileName(const std::string &file, ModuleIndex::Entry &e) {
+  std::string stem;
+  if (file.size() > 5 && file.compare(file.size() - 5, 5, ".yang") == 0) {
+    stem = file.substr(0, file.size() - 5);
+    e.format = LYS_IN_YANG;
+  } else if (file.size() > 4 && file.compare(file.size() - 4, 4, ".yin") == 0) {
+    stem = file.substr(0, file.size() - 4);
+    e.format = LYS_IN_YIN;
+  } else {
+    return false;
+  }
+  auto at = stem.find('@');
+  e.name = stem.substr(0, at);
+  e.revision = at == std::string::npos ? std::string() : stem.substr(at + 1);
+  return !e.name.empty();
+}
+
+ModuleIndex::ModuleIndex(ModuleIndex &&other) noexcept
+    : dirs_(std::move(other.dirs_)), stamps_(std::move(other.stamps_)),
+      modules_(std::move(other.modules_)), entries_(other.entries_) {}
+
+ModuleIndex &ModuleIndex::operator=(ModuleIndex &&other) noexcept {
+  dirs_ = std::move(other.dirs_);
+  stamps_ = std::move(other.stamps_);
+  modules_ = std::move(other.modules_);
+  entries_ = other.entries_;
+  return *this;
+}
+
+ModuleIndex ModuleIndex::scan(const std::vector<std::string> &dirs) {
+  namespace fs = std::filesystem;
+  ModuleIndex idx;
+  idx.dirs_ = dirs;
+
+  auto stamp = [&idx](const std::string &dir) {
+    DirStamp s;
+    s.path = dir;
+    if (statMtime(dir, s.mtime_sec, s.mtime_nsec))
+      idx.stamps_.push_back(std::move(s));
+  };
+
+  for (const auto &dir : dirs) {
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec))
+      continue;
+    stamp(dir);
+    for (fs::recursive_directory_iterator
+             it(dir, fs::directory_options::skip_permission_denied, ec),
+         end;
+         !ec && it != end; it.increment(ec)) {
+      if (it->is_directory(ec)) {
+        stamp(it->path().string());
+        continue;
+      }
+      Entry e;
+      if (!parseFileName(it->path().filename().string(), e))
+        continue;
+      e.path = it->path().string();
+      // the first directory in search order wins for duplicate files
+      auto &list = idx.modules_[e.name];
+      bool dup = std::any_of(list.begin(), list.end(), [&e](const Entry &x) {
+        return x.revision == e.revision;
+      });
+      if (!dup) {
+        list.push_back(std::move(e));
+        ++idx.entries_;
+      }
+    }
+  }
+
+  for (auto &[name, list] : idx.modules_) {
+    std::stable_sort(list.begin(), list.end(),
+                     [](const Entry &a, const Entry &b) {
+                       if (a.revision.empty() != b.revision.empty())
+                         return b.revision.empty();
+                       return a.revision > b.revision;
+                     });
+  }
+  return idx;
+}
+
+std::optional<ModuleIndex>
+ModuleIndex::load(const std::string &file,
+                  const std::vector<std::string> &dirs) {
+  std::ifstream in(file);
+  if (!in)
+    return std::nullopt;
+  std::string line;
+  if (!std::getline(in, line) || line != kIndexHeader)
+    return std::nullopt;
+
+  ModuleIndex idx;
+  while (std::getline(in, line)) {
+    if (line.size() < 2 || line[1] != ' ')
+      return std::nullopt;
+    std::istringstream ls(line.substr(2));
+    if (line[0] == 'S') {
+      // S <search dir>
+      idx.dirs_.push_back(line.substr(2));
+    } else if (line[0] == 'D') {
+      // D <sec> <nsec> <dir>
+      DirStamp s;
+      ls >> s.mtime_sec >> s.mtime_nsec;
+      ls.get();
+      std::getline(ls, s.path);
+      std::int64_t sec = 0, nsec = 0;
+      if (!statMtime(s.path, sec, nsec) || sec != s.mtime_sec ||
+          nsec != s.mtime_nsec)
+        return std::nullopt;
+      idx.stamps_.push_back(std::move(s));
+    } else if (line[0] == 'M') {
+      // M <name> <revision|-> <format> <path>
+      Entry e;
+      int format = 0;
+      ls >> e.name >> e.revision >> format;
+      ls.get();
+      std::getline(ls, e.path);
+      if (e.revision == "-")
+        e.revision.clear();
+      e.format = static_cast<LYS_INFORMAT>(format);
+      idx.modules_[e.name].push_back(std::move(e));
+      ++idx.entries_;
+    } else {
+      return std::nullopt;
+    }
+  }
+  if (idx.dirs_ != dirs)
+    return std::nullopt;
+  return idx;
+}
+
+ModuleIndex ModuleIndex::loadOrScan(const std::string &file,
+                                    const std::vector<std::string> &dirs) {
+  if (auto idx = load(file, dirs))
+    return std::move(*idx);
+  ModuleIndex idx = scan(dirs);
+  (void)idx.save(file);
+  return idx;
+}
+
+bool ModuleIndex::save(const std::string &file) const {
+  const std::string tmp = file + ".tmp." + std::to_string(::getpid());
+  {
+    std::ofstream out(tmp, std::ios::trunc);
+    if (!out)
+      return false;
+    out << kIndexHeader << '\n';
+    for (const auto &d : dirs_)
+      out << "S " << d << '\n';
+    for (const auto &s : stamps_)
+      out << "D " << s.mtime_sec << ' ' << s.mtime_nsec << ' ' << s.path
+          << '\n';
+    for (const auto &[name, list] : modules_) {
+      for (const auto &e : list)
+        out << "M " << e.name << ' '
+            << (e.revision.empty() ? std::string("-") : e.revision) << ' '
+            << static_cast<int>(e.format) << ' ' << e.path << '\n';
+    }
+    if (!out.flush()) {
+      ::unlink(tmp.c_str());
+      return false;
+    }
+  }
+  if (::rename(tmp.c_str(), file.c_str()) != 0) {
+    ::unlink(tmp.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::vector<std::string> ModuleIndex::scannedDirectories() const {
+  std::vector<std::string> dirs;
+  dirs.reserve(stamps_.size());
+  for (const auto &s : stamps_)
+    dirs.push_back(s.path);
+  return dirs;
+}
+
+const ModuleIndex::Entry *ModuleIndex::find(std::string_view name,
+                                            std::string_view revision) const {
+  auto it = modules_.find(std::string(name));
+  if (it == modules_.end() || it->second.empty())
+    return nullptr;
+  const auto &list = it->second;
+  if (revision.empty())
+    return &list.front();
+  for (const auto &e : list) {
+    if (e.revision == revision)
+      return &e;
+  }
+  // undated files sort last
+  return list.back().revision.empty() ? &list.back() : nullptr;
+}
+
+LY_ERR ModuleIndex::importCallback(
+    const char *mod_name, const char *mod_rev, const char *submod_name,
+    const char *submod_rev, void *user_data, LYS_INFORMAT *format,
+    const char **module_data, ly_module_imp_data_free_clb *free_module_data) {
+  auto *idx = static_cast<const ModuleIndex *>(user_data);
+  if (!idx)
+    return LY_ENOTFOUND;
+  const char *name = submod_name ? submod_name : mod_name;
+  const char *rev = submod_name ? submod_rev : mod_rev;
+  const Entry *e = idx->find(name ? name : "", rev ? rev : "");
+  if (!e)
+    return LY_ENOTFOUND;
+
+  int fd = ::open(e->path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return LY_ENOTFOUND;
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+    ::close(fd);
+    return LY_ENOTFOUND;
+  }
+  const std::size_t size = static_cast<std::size_t>(st.st_size);
+  const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+  // libyang expects NUL-terminated text. The tail of the last page of a
+  // mapping is zero-filled, so mmap works unless the file ends exactly on a
+  // page boundary; that (rare) case falls back to a heap copy.
+  void *data = nullptr;
+  std::size_t mapped = 0;
+  if (size % page != 0) {
+    data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+      data = nullptr;
+    else
+      mapped = size;
+  }
+  if (!data) {
+    char *buf = static_cast<char *>(std::malloc(size + 1));
+    std::size_t got = 0;
+    while (buf && got < size) {
+      ssize_t n = ::read(fd, buf + got, size - got);
+      if (n <= 0)
+        break;
+      got += static_cast<std::size_t>(n);
+    }
+    if (!buf || got != size) {
+      std::free(buf);
+      ::close(fd);
+      return LY_ESYS;
+    }
+    buf[size] = '\0';
+    data = buf;
+  }
+  ::close(fd);
+
+  {
+    std::lock_guard<std::mutex> lock(idx->mapped_mutex_);
+    idx->mapped_[data] = mapped;
+  }
+  *format = e->format;
+  *module_data = static_cast<const char *>(data);
+  *free_module_data = &ModuleIndex::releaseCallback;
+  return LY_SUCCESS;
+}
+
+void ModuleIndex::releaseCallback(void *module_data, void *user_data) {
+  auto *idx = static_cast<const ModuleIndex *>(user_data);
+  std::size_t mapped = 0;
+  {
+    std::lock_guard<std::mutex> lock(idx->mapped_mutex_);
+    auto it = idx->mapped_.find(module_data);
+    if (it == idx->mapped_.end())
+      return;
+    mapped = it->second;
+    idx->mapped_.erase(it);
+  }
+  if (mapped)
+    ::munmap(module_data, mapped);
+  else
+    std::free(module_data);
+}
@@ -0,0 +1,123 @@
+#include "NextHopGroupTable.hpp"
+#include "HeapBytes.hpp"
+
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace yang;
+using NextHop = IetfRouting::NextHop;
+using detail::heapBytes;
+
+namespace {
+
+  // Appends `s` with its length in front, so fields cannot run together.
+  void appendString(std::string &key, const std::string &s) {
+    const auto n = static_cast<std::uint32_t>(s.size());
+    key.append(reinterpret_cast<const char *>(&n), sizeof(n));
+    key.append(s);
+  }
+
+  void appendOptional(std::string &key, const std::optional<std::string> &s) {
+    key.push_back(s.has_value());
+    if (s)
+      appendString(key, *s);
+  }
+
+  // Hash of every field of a next hop, through its bytes.
+  std::size_t hashOf(const NextHop &hop) {
+    std::string key;
+    appendOptional(key, hop.outgoing_interface);
+    key.push_back(static_cast<char>(hop.address.index()));
+    std::visit(
+        [&](const auto &a) {
+          if constexpr (requires { a.bytes; })
+            key.append(a.bytes.begin(), a.bytes.end());
+        },
+        hop.address);
+    key.push_back(hop.special_next_hop
+                      ? static_cast<char>(1 + int(*hop.special_next_hop))
+                      : 0);
+    for (const auto &entry : hop.next_hop_list) {
+      appendString(key, entry.index);
+      appendOptional(key, entry.outgoing_interface);
+    }
+    return std::hash<std::string_view>()(key);
+  }
+
+} // namespace
+
+NextHopGroupTable::Id NextHopGroupTable::intern(const NextHop &hop) {
+  const std::size_t hash = hashOf(hop);
+  auto [first, last] = index_.equal_range(hash);
+  for (auto it = first; it != last; ++it) {
+    Group &g = groups_[it->second];
+    if (g.hop == hop) {
+      ++g.refs;
+      return it->second;
+    }
+  }
+
+  Id id;
+  if (!free_.empty()) {
+    id = free_.back();
+    free_.pop_back();
+  } else {
+    if (groups_.size() > std::numeric_limits<Id>::max())
+      throw std::length_error("NextHopGroupTable: too many groups");
+    id = static_cast<Id>(groups_.size());
+    groups_.emplace_back();
+  }
+  groups_[id] = {hop, hash, 1};
+  index_.emplace(hash, id);
+  return id;
+}
+
+void NextHopGroupTable::unindex(Id id) {
+  auto [first, last] = index_.equal_range(groups_[id].hash);
+  for (auto it = first; it != last; ++it) {
+    if (it->second == id) {
+      index_.erase(it);
+      return;
+    }
+  }
+}
+
+void NextHopGroupTable::release(Id id) {
+  Group &g = groups_.at(id);
+  if (g.refs == 0)
+    throw std::logic_error("NextHopGroupTable: release of a free group");
+  if (--g.refs != 0)
+    return;
+  unindex(id);
+  g.hop = NextHop();
+  free_.push_back(id);
+}
+
+void NextHopGroupTable::update(Id id, NextHop hop) {
+  Group &g = groups_.at(id);
+  if (g.refs == 0)
+    throw std::logic_error("NextHopGroupTable: update of a free group");
+  unindex(id);
+  g.hash = hashOf(hop);
+  g.hop = std::move(hop);
+  index_.emplace(g.hash, id);
+}
+
+std::size_t NextHopGroupTable::memoryUsage() const noexcept {
+  std::size_t bytes = groups_.capacity() * sizeof(Group) +
+                      free_.capacity() * sizeof(Id);
+  for (const auto &g : groups_) {
+    bytes += heapBytes(g.hop.outgoing_interface);
+    bytes += g.hop.next_hop_list.capacity() *
+             sizeof(IetfRouting::NextHopListEntry);
+    for (const auto &entry : g.hop.next_hop_list)
+      bytes += heapBytes(entry.index) + heapBytes(entry.outgoing_interface);
+  }
+  // a node per entry (next pointer, key, id) plus the buckets
+  bytes += index_.size() * (sizeof(void *) + sizeof(std::size_t) * 2);
+  bytes += index_.bucket_count() * sizeof(void *);
+  return bytes;
+}
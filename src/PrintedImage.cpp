@@ -0,0 +1,68 @@
+#include "PrintedImage.hpp"
+
+#include <sys/mman.h>
+
+using namespace yang;
+
+std::size_t detail::pageSize() {
+  static const std::size_t page =
+      static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return page;
+}
+
+void *detail::mapAt(void *addr, std::size_t len, int prot, bool shared,
+                    int fd, off_t off) {
+  int flags = (shared ? MAP_SHARED : MAP_PRIVATE) |
+              (fd < 0 ? MAP_ANONYMOUS : 0);
+#if defined(MAP_FIXED_NOREPLACE)
+  flags |= MAP_FIXED_NOREPLACE;
+#elif defined(MAP_EXCL)
+  flags |= MAP_FIXED | MAP_EXCL;
+#endif
+  void *p = ::mmap(addr, len, prot, flags, fd, off);
+  if (p == MAP_FAILED)
+    return nullptr;
+  if (p != addr) {
+    ::munmap(p, len);
+    return nullptr;
+  }
+  return p;
+}
+
+void *detail::mapForPrint(std::size_t len, int fd, off_t off) {
+  const int prot = PROT_READ | PROT_WRITE;
+  const bool shared = fd >= 0;
+  if (void *p =
+          mapAt(reinterpret_cast<void *>(kImageBaseHint), len, prot, shared,
+                fd, off))
+    return p;
+  void *p = ::mmap(nullptr, len, prot,
+                   (shared ? MAP_SHARED : MAP_PRIVATE | MAP_ANONYMOUS), fd,
+                   off);
+  return p == MAP_FAILED ? nullptr : p;
+}
+
+bool detail::writeAll(int fd, const void *data, std::size_t len) {
+  const char *p = static_cast<const char *>(data);
+  while (len > 0) {
+    ssize_t n = ::write(fd, p, len);
+    if (n <= 0)
+      return false;
+    p += n;
+    len -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+bool detail::readAll(int fd, void *data, std::size_t len, off_t off) {
+  char *p = static_cast<char *>(data);
+  while (len > 0) {
+    ssize_t n = ::pread(fd, p, len, off);
+    if (n <= 0)
+      return false;
+    p += n;
+    off += n;
+    len -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
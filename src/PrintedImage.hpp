@@ -0,0 +1,48 @@
+#pragma once
+
+// Internal helpers shared by the code that stores printed (precompiled)
+// libyang contexts outside the heap: snapshot files and shared memory.
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace yang::detail {
+
+  // Preferred address for printed images. A printed context contains
+  // absolute pointers into its own memory, so it can only be reused when it
+  // is mapped back at the address it was printed at; using a fixed hint far
+  // away from the usual heap/library ranges makes that succeed reliably.
+  inline constexpr std::uintptr_t kImageBaseHint =
+      sizeof(void *) == 8 ? std::uintptr_t(0x5e0000000000ULL) : 0;
+
+  struct FdGuard {
+    int fd;
+    ~FdGuard() {
+      if (fd >= 0)
+        ::close(fd);
+    }
+  };
+
+  std::size_t pageSize();
+
+  inline std::size_t roundUp(std::size_t n, std::size_t align) {
+    return (n + align - 1) / align * align;
+  }
+
+  // Map `len` bytes at exactly `addr` (anonymous when fd < 0) with `prot`
+  // and MAP_SHARED or MAP_PRIVATE. Returns nullptr if the range is taken
+  // instead of silently relocating.
+  void *mapAt(void *addr, std::size_t len, int prot, bool shared, int fd,
+              off_t off);
+
+  // Writable mapping to print an image into: at kImageBaseHint when that
+  // range is free, else anywhere. Anonymous when fd < 0, else a shared
+  // mapping of `fd` at `off`. Returns nullptr on failure.
+  void *mapForPrint(std::size_t len, int fd, off_t off);
+
+  bool writeAll(int fd, const void *data, std::size_t len);
+  bool readAll(int fd, void *data, std::size_t len, off_t off);
+
+} // namespace yang::detail
@@ -0,0 +1,262 @@
+#include "RibTransaction.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+using namespace yang;
+using detail::PrefixKey;
+using Route = IetfRouting::Route;
+
+namespace {
+
+  PrefixKey prefixKey(const IetfRouting::DestinationPrefix &prefix) {
+    PrefixKey key;
+    if (const auto *p = std::get_if<Ipv4Prefix>(&prefix)) {
+      std::copy(p->address.bytes.begin(), p->address.bytes.end(),
+                key.bytes.begin());
+      key.length = p->length;
+      key.family = 4;
+    } else if (const auto *p = std::get_if<Ipv6Prefix>(&prefix)) {
+      key.bytes = p->address.bytes;
+      key.length = p->length;
+      key.family = 6;
+    }
+    return key;
+  }
+
+  // routes without a destination prefix are left out of the index
+  bool indexed(const Route &r) {
+    return !std::holds_alternative<std::monostate>(r.destination_prefix);
+  }
+
+  YangIdentity sourceProtocol(const Route &r) {
+    return r.metadata ? r.metadata->source_protocol : YangIdentity();
+  }
+
+  bool isActive(const Route &r) { return r.metadata && r.metadata->active; }
+
+  void setActive(Route &r, bool active) {
+    if (active)
+      (r.metadata ? *r.metadata : r.metadata.emplace()).active = true;
+    else if (r.metadata)
+      r.metadata->active = false;
+  }
+
+  std::string describe(const Route &r) {
+    std::string s = std::visit(
+        [](const auto &p) -> std::string {
+          if constexpr (requires { p.toString(); })
+            return p.toString();
+          else
+            return {};
+        },
+        r.destination_prefix);
+    if (const YangIdentity protocol = sourceProtocol(r))
+      s += " from " + protocol.qualified();
+    return s;
+  }
+
+  // A route as RibTransaction names it.
+  struct RouteKey {
+    PrefixKey prefix;
+    YangIdentity source_protocol;
+
+    bool operator==(const RouteKey &) const = default;
+  };
+
+  struct RouteKeyHash {
+    std::size_t operator()(const RouteKey &k) const noexcept {
+      return detail::PrefixKeyHash()(k.prefix) * 31 +
+             k.source_protocol.id();
+    }
+  };
+
+} // namespace
+
+std::size_t detail::PrefixKeyHash::operator()(const PrefixKey &k) const
+    noexcept {
+  static_assert(sizeof(PrefixKey) == 18, "PrefixKey has padding");
+  return std::hash<std::string_view>()(
+      std::string_view(reinterpret_cast<const char *>(&k), sizeof(k)));
+}
+
+void RibTransaction::push(Op op, Route route) {
+  if (!indexed(route))
+    throw std::invalid_argument("RibTransaction: route without a "
+                                "destination prefix");
+  ops_.push_back({op, std::move(route)});
+}
+
+void RibTransaction::add(Route route) { push(Op::Add, std::move(route)); }
+
+void RibTransaction::replace(Route route) {
+  push(Op::Replace, std::move(route));
+}
+
+void RibTransaction::withdraw(const IetfRouting::DestinationPrefix &prefix,
+                              YangIdentity source_protocol) {
+  Route route;
+  route.destination_prefix = prefix;
+  if (source_protocol)
+    route.metadata.emplace().source_protocol = source_protocol;
+  push(Op::Withdraw, std::move(route));
+}
+
+RibUpdater::RibUpdater(IetfRouting::Rib &rib) : rib_(rib) {
+  if (rib_.routes.size() >= RibDelta::kNoRoute)
+    throw std::length_error("RibUpdater: too many routes");
+  index_.reserve(rib_.routes.size());
+  for (std::uint32_t i = 0; i < rib_.routes.size(); ++i) {
+    const Route &r = rib_.routes[i];
+    if (indexed(r))
+      index_[prefixKey(r.destination_prefix)].push_back(i);
+  }
+  for (const auto &[prefix, routes] : index_)
+    select(routes);
+}
+
+std::uint32_t RibUpdater::find(const PrefixKey &prefix,
+                               YangIdentity source_protocol) const {
+  auto it = index_.find(prefix);
+  if (it == index_.end())
+    return RibDelta::kNoRoute;
+  for (std::uint32_t i : it->second)
+    if (sourceProtocol(rib_.routes[i]) == source_protocol)
+      return i;
+  return RibDelta::kNoRoute;
+}
+
+std::uint32_t RibUpdater::select(const Candidates &routes) {
+  constexpr auto kLast = std::numeric_limits<std::uint64_t>::max();
+  auto rank = [&](std::uint32_t i) {
+    const Route &r = rib_.routes[i];
+    return std::pair(r.route_preference ? *r.route_preference : kLast,
+                     !isActive(r));
+  };
+  std::uint32_t best = RibDelta::kNoRoute;
+  for (std::uint32_t i : routes) {
+    if (best == RibDelta::kNoRoute || rank(i) < rank(best) ||
+        (rank(i) == rank(best) && i < best))
+      best = i;
+  }
+  for (std::uint32_t i : routes)
+    setActive(rib_.routes[i], i == best);
+  return best;
+}
+
+void RibUpdater::remove(std::uint32_t route) {
+  auto &routes = rib_.routes;
+  auto unlist = [&](std::uint32_t i) -> Candidates & {
+    Candidates &c = index_.find(prefixKey(routes[i].destination_prefix))
+                        ->second;
+    *std::find(c.begin(), c.end(), i) = c.back();
+    c.pop_back();
+    return c;
+  };
+  const PrefixKey prefix = prefixKey(routes[route].destination_prefix);
+  unlist(route);
+  const auto last = static_cast<std::uint32_t>(routes.size() - 1);
+  if (route != last) {
+    // the last route takes the freed slot
+    if (indexed(routes[last]))
+      unlist(last).push_back(route);
+    routes[route] = std::move(routes[last]);
+  }
+  routes.pop_back();
+  if (auto it = index_.find(prefix); it->second.empty())
+    index_.erase(it);
+}
+
+RibDelta RibUpdater::apply(const RibTransaction &txn) {
+  using Op = RibTransaction::Op;
+
+  // Check every operation against the RIB as the earlier ones leave it,
+  // before anything changes.
+  {
+    std::unordered_map<RouteKey, bool, RouteKeyHash> present;
+    std::size_t adds = 0;
+    for (const auto &op : txn.operations()) {
+      const RouteKey key{prefixKey(op.route.destination_prefix),
+                         sourceProtocol(op.route)};
+      auto [it, inserted] = present.try_emplace(key);
+      if (inserted)
+        it->second = find(key.prefix, key.source_protocol) !=
+                     RibDelta::kNoRoute;
+      if (op.op == Op::Add && it->second)
+        throw std::invalid_argument("RibTransaction: route exists: " +
+                                    describe(op.route));
+      if (op.op != Op::Add && !it->second)
+        throw std::invalid_argument("RibTransaction: no route " +
+                                    describe(op.route));
+      it->second = op.op != Op::Withdraw;
+      adds += op.op == Op::Add;
+    }
+    if (rib_.routes.size() + adds >= RibDelta::kNoRoute)
+      throw std::length_error("RibUpdater: too many routes");
+  }
+
+  // the active route of each touched prefix, as it was
+  struct Touched {
+    PrefixKey key;
+    IetfRouting::DestinationPrefix prefix;
+    std::optional<Route> was;
+  };
+  std::vector<Touched> touched;
+  std::unordered_set<PrefixKey, detail::PrefixKeyHash> seen;
+
+  for (const auto &op : txn.operations()) {
+    const PrefixKey prefix = prefixKey(op.route.destination_prefix);
+    if (seen.insert(prefix).second) {
+      touched.push_back({prefix, op.route.destination_prefix, std::nullopt});
+      Touched &t = touched.back();
+      if (auto it = index_.find(prefix); it != index_.end())
+        for (std::uint32_t i : it->second)
+          if (isActive(rib_.routes[i]))
+            t.was = rib_.routes[i];
+    }
+
+    const std::uint32_t at = find(prefix, sourceProtocol(op.route));
+    switch (op.op) {
+    case Op::Add:
+      index_[prefix].push_back(
+          static_cast<std::uint32_t>(rib_.routes.size()));
+      rib_.routes.push_back(op.route);
+      setActive(rib_.routes.back(), false);
+      break;
+    case Op::Replace: {
+      // an active route stays active on a tie
+      const bool active = isActive(rib_.routes[at]);
+      rib_.routes[at] = op.route;
+      setActive(rib_.routes[at], active);
+      break;
+    }
+    case Op::Withdraw:
+      remove(at);
+      break;
+    }
+  }
+
+  RibDelta delta;
+  for (const Touched &t : touched) {
+    auto it = index_.find(t.key);
+    const std::uint32_t now =
+        it == index_.end() ? RibDelta::kNoRoute : select(it->second);
+    if (now == RibDelta::kNoRoute) {
+      if (t.was)
+        delta.changes.push_back(
+            {t.prefix, RibDelta::Change::Withdrawn, RibDelta::kNoRoute});
+    } else if (!t.was) {
+      delta.changes.push_back({t.prefix, RibDelta::Change::Added, now});
+    } else if (!(*t.was == rib_.routes[now])) {
+      delta.changes.push_back({t.prefix, RibDelta::Change::Replaced, now});
+    }
+  }
+  return delta;
+}
@@ -0,0 +1,168 @@
+#include "RouteStore.hpp"
+#include "HeapBytes.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+using namespace yang;
+using detail::heapBytes;
+
+RouteStore::RouteStore(std::shared_ptr<NextHopGroupTable> groups)
+    : groups_(std::move(groups)) {
+  if (!groups_)
+    throw std::invalid_argument("RouteStore: no next-hop group table");
+}
+
+RouteStore::RouteStore(std::span<const IetfRouting::Route> routes,
+                       std::shared_ptr<NextHopGroupTable> groups)
+    : RouteStore(std::move(groups)) {
+  records_.reserve(routes.size());
+  for (const auto &r : routes)
+    push_back(r);
+}
+
+RouteStore::RouteStore(const RouteStore &other)
+    : records_(other.records_), groups_(other.groups_),
+      last_updated_(other.last_updated_) {
+  for (const auto &rec : records_)
+    if (rec.present & kNextHop)
+      groups_->acquire(rec.next_hop);
+}
+
+RouteStore &RouteStore::operator=(RouteStore other) noexcept {
+  std::swap(records_, other.records_);
+  std::swap(groups_, other.groups_);
+  std::swap(last_updated_, other.last_updated_);
+  return *this;
+}
+
+RouteStore::~RouteStore() {
+  // a moved-from store has no records left
+  for (const auto &rec : records_)
+    if (rec.present & kNextHop)
+      groups_->release(rec.next_hop);
+}
+
+void RouteStore::push_back(const IetfRouting::Route &route) {
+  if (records_.size() >= std::numeric_limits<std::uint32_t>::max())
+    throw std::length_error("RouteStore: too many routes");
+  Record rec;
+  if (const auto *p = std::get_if<Ipv4Prefix>(&route.destination_prefix)) {
+    std::copy(p->address.bytes.begin(), p->address.bytes.end(),
+              rec.prefix.begin());
+    rec.prefix_length = p->length;
+    rec.family = 4;
+  } else if (const auto *p =
+                 std::get_if<Ipv6Prefix>(&route.destination_prefix)) {
+    rec.prefix = p->address.bytes;
+    rec.prefix_length = p->length;
+    rec.family = 6;
+  }
+  if (route.route_preference) {
+    rec.present |= kPreference;
+    rec.preference = *route.route_preference;
+  }
+  if (route.next_hop) {
+    rec.present |= kNextHop;
+    rec.next_hop = groups_->intern(*route.next_hop);
+  }
+  const std::string *last_updated = nullptr;
+  if (const auto &meta = route.metadata) {
+    rec.present |= kMetadata;
+    rec.source_protocol = meta->source_protocol;
+    if (meta->active)
+      rec.present |= kActive;
+    if (meta->last_updated) {
+      rec.present |= kLastUpdated;
+      last_updated = &*meta->last_updated;
+    }
+  }
+  // the record first, then its side entry; on failure neither stays and
+  // the group reference taken above is returned
+  const auto index = static_cast<std::uint32_t>(records_.size());
+  try {
+    records_.push_back(rec);
+    if (last_updated)
+      last_updated_.emplace_back(index, *last_updated);
+  } catch (...) {
+    if (records_.size() > index)
+      records_.pop_back();
+    if (rec.present & kNextHop)
+      groups_->release(rec.next_hop);
+    throw;
+  }
+}
+
+void RouteStore::setNextHop(std::size_t i,
+                            const std::optional<IetfRouting::NextHop> &hop) {
+  Record &rec = records_.at(i);
+  const bool had = rec.present & kNextHop;
+  const NextHopGroupTable::Id old = rec.next_hop;
+  if (hop) {
+    // interned before the release, so an unchanged next hop keeps its group
+    rec.next_hop = groups_->intern(*hop);
+    rec.present |= kNextHop;
+  } else {
+    rec.next_hop = 0;
+    rec.present &= ~kNextHop;
+  }
+  if (had)
+    groups_->release(old);
+}
+
+IetfRouting::DestinationPrefix
+RouteStore::destinationPrefix(std::size_t i) const {
+  const Record &rec = records_[i];
+  if (rec.family == 4) {
+    Ipv4Prefix p;
+    std::copy_n(rec.prefix.begin(), 4, p.address.bytes.begin());
+    p.length = rec.prefix_length;
+    return p;
+  }
+  if (rec.family == 6)
+    return Ipv6Prefix{{rec.prefix}, rec.prefix_length};
+  return std::monostate();
+}
+
+IetfRouting::Route RouteStore::route(std::size_t i) const {
+  const Record &rec = records_[i];
+  IetfRouting::Route r;
+  r.destination_prefix = destinationPrefix(i);
+  if (rec.present & kPreference)
+    r.route_preference = rec.preference;
+  if (rec.present & kNextHop)
+    r.next_hop = (*groups_)[rec.next_hop];
+  if (rec.present & kMetadata) {
+    auto &meta = r.metadata.emplace();
+    meta.source_protocol = rec.source_protocol;
+    meta.active = rec.present & kActive;
+    if (rec.present & kLastUpdated) {
+      auto it = std::lower_bound(
+          last_updated_.begin(), last_updated_.end(), i,
+          [](const auto &entry, std::size_t route) {
+            return entry.first < route;
+          });
+      meta.last_updated = it->second;
+    }
+  }
+  return r;
+}
+
+std::vector<IetfRouting::Route> RouteStore::routes() const {
+  std::vector<IetfRouting::Route> out;
+  out.reserve(records_.size());
+  for (std::size_t i = 0; i < records_.size(); ++i)
+    out.push_back(route(i));
+  return out;
+}
+
+std::size_t RouteStore::memoryUsage() const noexcept {
+  std::size_t bytes =
+      records_.capacity() * sizeof(Record) + groups_->memoryUsage();
+  bytes += last_updated_.capacity() * sizeof(last_updated_[0]);
+  for (const auto &entry : last_updated_)
+    bytes += heapBytes(entry.second);
+  return bytes;
+}
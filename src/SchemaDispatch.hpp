@@ -0,0 +1,46 @@
+#pragma once
+
+// Internal helper for the model deserializers: one pass over the children
+// of a data node, dispatching each child on its compiled schema node.
+
+#include <cstdint>
+#include <libyang/libyang.h>
+#include <unordered_map>
+
+namespace yang::detail {
+
+  // Maps the schema nodes of a container's or list entry's children to
+  // field handlers. Tables are built once per context (see
+  // YangContext::schemaCache()) from schema paths, after which a data node
+  // costs one pointer lookup instead of a strcmp() against every field.
+  template <typename... Args> class SchemaDispatch {
+  public:
+    using Handler = void (*)(struct lyd_node *node, Args... args);
+
+    // Nodes missing from the context (a module that is not loaded, a
+    // disabled feature) are left out: their data cannot occur.
+    void add(const struct ly_ctx *ctx, const char *path, Handler handler) {
+      // a miss is expected here, keep it out of the log
+      uint32_t quiet = 0;
+      uint32_t *prev = ly_temp_log_options(&quiet);
+      const struct lysc_node *schema = lys_find_path(ctx, nullptr, path, 0);
+      ly_temp_log_options(prev);
+      if (schema)
+        handlers_.emplace(schema, handler);
+    }
+
+    // Calls the handler of each child of `parent`; children without one
+    // are skipped.
+    void dispatch(const struct lyd_node *parent, Args... args) const {
+      for (struct lyd_node *c = lyd_child(parent); c; c = c->next) {
+        auto it = handlers_.find(c->schema);
+        if (it != handlers_.end())
+          it->second(c, args...);
+      }
+    }
+
+  private:
+    std::unordered_map<const struct lysc_node *, Handler> handlers_;
+  };
+
+} // namespace yang::detail
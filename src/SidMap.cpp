@@ -0,0 +1,108 @@
+#include "SidMap.hpp"
+#include "Exceptions.hpp"
+#include "PrintedImage.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <fcntl.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace yang;
+
+void SidMap::add(YangInput &in) {
+  struct Item {
+    std::string ns;
+    std::string identifier;
+    std::uint64_t sid = 0;
+  };
+
+  YangReader r(in);
+  while (r.nextChild(0)) {
+    if (r.module() != "ietf-sid-file" || r.name() != "sid-file")
+      continue;
+
+    // items may come before module-name, so collect them first
+    std::string module;
+    std::vector<Item> items;
+    while (r.nextChild(1)) {
+      if (r.name() == "module-name") {
+        module = r.text();
+        continue;
+      }
+      if (r.name() != "item")
+        continue;
+      Item item;
+      bool has_sid = false;
+      while (r.nextChild(2)) {
+        if (r.name() == "namespace") {
+          item.ns = r.text();
+        } else if (r.name() == "identifier") {
+          item.identifier = r.text();
+        } else if (r.name() == "sid") {
+          // uint64: a JSON string (RFC 7951 6.1), but accept a number too
+          std::string_view v = r.text();
+          auto [end, ec] =
+              std::from_chars(v.data(), v.data() + v.size(), item.sid);
+          if (ec != std::errc() || end != v.data() + v.size())
+            r.fail("bad sid '" + std::string(v) + "'");
+          has_sid = true;
+        }
+      }
+      if (!has_sid || item.identifier.empty())
+        r.fail("item without sid or identifier");
+      items.push_back(std::move(item));
+    }
+
+    for (auto &item : items) {
+      if (item.ns == "data")
+        addData(std::move(item.identifier), item.sid);
+      else if (item.ns == "identity")
+        addIdentity(module + ':' + item.identifier, item.sid);
+      // "module" and "feature" items are not used for encoding data
+    }
+  }
+}
+
+void SidMap::addFile(const std::string &path) {
+  int fd;
+  do
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  while (fd < 0 && errno == EINTR);
+  if (fd < 0)
+    throw std::system_error(errno, std::generic_category(),
+                            "SidMap: open " + path);
+  detail::FdGuard guard{fd};
+  auto in = YangInput::fromFd(fd);
+  add(in);
+}
+
+void SidMap::addData(std::string path, std::uint64_t sid) {
+  data_.insert_or_assign(std::move(path), sid);
+}
+
+void SidMap::addIdentity(std::string qualified_name, std::uint64_t sid) {
+  identity_names_.insert_or_assign(sid, qualified_name);
+  identities_.insert_or_assign(std::move(qualified_name), sid);
+}
+
+std::optional<std::uint64_t> SidMap::data(std::string_view path) const {
+  auto it = data_.find(path);
+  if (it == data_.end())
+    return std::nullopt;
+  return it->second;
+}
+
+std::optional<std::uint64_t> SidMap::identity(std::string_view name) const {
+  auto it = identities_.find(name);
+  if (it == identities_.end())
+    return std::nullopt;
+  return it->second;
+}
+
+const std::string *SidMap::identityName(std::uint64_t sid) const {
+  auto it = identity_names_.find(sid);
+  return it == identity_names_.end() ? nullptr : &it->second;
+}
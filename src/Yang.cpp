@@ -1,66 +1,291 @@
 #include "Yang.hpp"
+#include "EmbeddedModules.hpp"
+#include "FeatureProfile.hpp"
+#include "ModuleIndex.hpp"
 #include "YangContext.hpp"
+#include "YangContextPool.hpp"
+#include "YangContextRegistry.hpp"
+#include "YangContextSnapshot.hpp"
 
 #include "Exceptions.hpp"
+#include <cstdlib>
 #include <filesystem>
 #include <libyang/libyang.h>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
 
 using namespace yang;
 
-std::shared_ptr<YangContext>
-Yang::getContext(std::initializer_list<YangContextOption> opts) {
+// Configuration set before the first context is built; guarded because
+// builders for different registry keys may run concurrently.
+static std::mutex config_mutex;
+
+static std::optional<std::string> &snapshotPath() {
+  static std::optional<std::string> path;
+  return path;
+}
+
+static std::optional<std::string> &moduleIndexPath() {
+  static std::optional<std::string> path;
+  return path;
+}
+
+// Explicitly configured path, else the environment variable, else "".
+static std::string configuredPath(std::optional<std::string> &path,
+                                  const char *env_var) {
+  std::lock_guard<std::mutex> lock(config_mutex);
+  if (!path) {
+    const char *env = std::getenv(env_var);
+    path = env ? env : "";
+  }
+  return *path;
+}
+
+static std::optional<FeatureProfile> &featureProfile() {
+  static std::optional<FeatureProfile> profile;
+  return profile;
+}
+
+void Yang::setFeatureProfile(FeatureProfile profile) {
+  std::lock_guard<std::mutex> lock(config_mutex);
+  if (featureProfile())
+    throw std::logic_error(
+        "Yang::setFeatureProfile: profile already set or in use");
+  featureProfile() = std::move(profile);
+}
+
+// kDefaultModules with the configured feature profile applied. Fixed on
+// first use; the profile stays alive (and unchanged) for the process.
+static const std::vector<ModuleSpec> &defaultModules() {
+  static const std::vector<ModuleSpec> modules = [] {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    if (!featureProfile())
+      featureProfile().emplace();
+    return featureProfile()->apply(yang::kDefaultModules);
+  }();
+  return modules;
+}
+
+static int &sharedContextFd() {
+  static int fd = -1;
+  return fd;
+}
+
+void Yang::setSharedDefaultContext(int fd) {
+  std::lock_guard<std::mutex> lock(config_mutex);
+  sharedContextFd() = fd;
+}
+
+void Yang::setSnapshotPath(const std::string &path) {
+  std::lock_guard<std::mutex> lock(config_mutex);
+  snapshotPath() = path;
+}
+
+void Yang::setModuleIndexPath(const std::string &path) {
+  std::lock_guard<std::mutex> lock(config_mutex);
+  moduleIndexPath() = path;
+}
+
+static unsigned flagsOf(std::initializer_list<YangContextOption> opts) {
   unsigned flags = 0u;
   for (auto o : opts)
     flags |= static_cast<unsigned>(o);
-
-  static std::shared_ptr<YangContext> instance;
-  if (!instance) {
-    instance = std::make_shared<YangContext>(flags);
-  }
-  return instance;
+  return flags;
 }
 
-std::shared_ptr<YangContext> Yang::getDefaultContext() {
-  static bool initialized = false;
-  // Create a context that does not auto-initialize ietf-yang-library
-  auto instance = getContext({YangContextOption::NoYanglibrary});
-  if (!instance)
-    throw std::runtime_error("failed to create YangContext");
-  if (initialized)
-    return instance;
-
-  const auto &candidates = yang::kDefaultSearchPaths;
-  size_t added = 0;
-  for (const auto &p : candidates) {
-    std::filesystem::path pp{p};
-    if (std::filesystem::exists(pp) && std::filesystem::is_directory(pp)) {
-      instance->addSearchPath(pp.string());
-      ++added;
+// kDefaultSearchPaths entries that exist on this host.
+static const std::vector<std::string> &existingSearchPaths() {
+  static const std::vector<std::string> paths = [] {
+    std::vector<std::string> found;
+    for (const auto &p : yang::kDefaultSearchPaths) {
+      std::filesystem::path pp{p};
+      if (std::filesystem::exists(pp) && std::filesystem::is_directory(pp))
+        found.push_back(pp.string());
     }
-  }
+    return found;
+  }();
+  return paths;
+}
 
-  if (added == 0) {
-    throw yang::YangDataError(*instance);
+// One index over the default search paths, shared by every context.
+static std::shared_ptr<const ModuleIndex> defaultModuleIndex() {
+  static const std::shared_ptr<const ModuleIndex> index = [] {
+    const auto &paths = existingSearchPaths();
+    const std::string file =
+        configuredPath(moduleIndexPath(), "YANG_MODULE_INDEX");
+    return std::make_shared<const ModuleIndex>(
+        file.empty() ? ModuleIndex::scan(paths)
+                     : ModuleIndex::loadOrScan(file, paths));
+  }();
+  return index;
+}
+
+// Point `ctx` at the module sources: the embedded bundle when the library
+// has one, else the module index with the search paths as a fallback.
+static void configureModuleSources(YangContext &ctx) {
+  if (ctx.useEmbeddedModules())
+    return;
+
+  // Imports are resolved through the in-memory index; the search paths
+  // remain as a fallback for anything the index does not know about.
+  const auto &paths = existingSearchPaths();
+  ctx.setModuleIndex(defaultModuleIndex());
+  for (const auto &p : paths)
+    ctx.addSearchPath(p);
+
+  if (paths.empty()) {
+    throw yang::YangDataError(ctx);
   }
+}
+
+std::shared_ptr<YangContext>
+Yang::getContext(std::initializer_list<YangContextOption> opts) {
+  const unsigned flags = flagsOf(opts);
+  return YangContextRegistry::global().get(
+      YangContextRegistry::key(flags),
+      [flags] { return std::make_shared<YangContext>(flags); });
+}
+
+std::shared_ptr<YangContext>
+Yang::getContext(std::initializer_list<YangContextOption> opts,
+                 std::span<const ModuleSpec> modules) {
+  const unsigned flags = flagsOf(opts);
+  return YangContextRegistry::global().get(
+      YangContextRegistry::key(flags, modules), [flags, modules] {
+        auto instance = std::make_shared<YangContext>(flags);
+        configureModuleSources(*instance);
+        instance->loadModules(modules);
+        return instance;
+      });
+}
+
+// Flags of the default context. With modules compiled into the library
+// nothing is read from disk: no search directories are probed and libyang
+// never looks at the CWD. Schema hashes are kept so that data can be
+// exchanged as LYB (see YangModel::parseLyb()).
+static unsigned defaultContextFlags() {
+  const bool embedded = !yang::embeddedModules().empty();
+  return toFlags(YangContextOption::NoYanglibrary) |
+         toFlags(YangContextOption::LybHashes) |
+         (embedded ? toFlags(YangContextOption::DisableSearchdirs) : 0u);
+}
+
+// A default context compiled from the module sources, bypassing the snapshot.
+static std::shared_ptr<YangContext> compileDefaultContext() {
+  // Create a context that does not auto-initialize ietf-yang-library
+  auto instance = std::make_shared<YangContext>(defaultContextFlags());
+  configureModuleSources(*instance);
 
   struct ly_ctx *c = static_cast<struct ly_ctx *>(instance->raw());
   if (!c) {
     throw yang::YangDataError(*instance);
   }
 
-  for (const auto &pr : yang::kDefaultModules) {
-    const std::string &name = std::get<0>(pr);
-    const std::string &rev = std::get<1>(pr);
-    const char **features =
-        std::get<2>(pr); // pointer-to-array (nullptr for now)
-    // delegate module loading to the context helper (throws on failure)
-    instance->loadModuleInContext(name, rev, features);
+  // parse everything first, then compile the whole context once
+  instance->loadModules(defaultModules());
+  return instance;
+}
+
+static std::shared_ptr<YangContext> buildDefaultContext() {
+  const unsigned flags = defaultContextFlags();
+  const bool embedded = !yang::embeddedModules().empty();
+
+  int shared_fd;
+  {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    shared_fd = sharedContextFd();
+  }
+  if (shared_fd >= 0) {
+    if (auto attached = YangSharedContext::attach(shared_fd))
+      return attached;
   }
 
-  initialized = true;
+  const std::string snapshot_path =
+      configuredPath(snapshotPath(), "YANG_CONTEXT_SNAPSHOT");
+  std::optional<YangContextSnapshot> snapshot;
+  if (!snapshot_path.empty()) {
+    snapshot.emplace(snapshot_path,
+                     YangContextSnapshot::fingerprint(
+                         flags, defaultModules(),
+                         embedded ? std::vector<std::string>()
+                                  : existingSearchPaths()));
+    if (auto cached = snapshot->load())
+      return cached;
+  }
+
+  auto instance = compileDefaultContext();
+
+  // Best effort: a failed save only costs the next process a full compile.
+  if (snapshot)
+    (void)snapshot->save(*instance);
+
   return instance;
 }
+
+std::shared_ptr<YangContext> Yang::getDefaultContext() {
+  // its own namespace: getContext() with the same options and modules
+  // compiles a plain context, skipping the snapshot and shared attach paths
+  static const std::string key =
+      "default:" +
+      YangContextRegistry::key(defaultContextFlags(), defaultModules());
+  return YangContextRegistry::global().get(key, &buildDefaultContext);
+}
+
+// Modules of the models used so far, in first-use order. Guarded by
+// lazy_mutex, which is also held while the context for a new union compiles.
+static std::mutex lazy_mutex;
+
+static std::vector<ModuleSpec> &lazyModules() {
+  static std::vector<ModuleSpec> modules;
+  return modules;
+}
+
+// Same options and module sources as the default context, `modules` loaded.
+static std::shared_ptr<YangContext>
+lazyContext(std::span<const ModuleSpec> modules) {
+  return YangContextRegistry::global().get(
+      "lazy:" + YangContextRegistry::key(defaultContextFlags(), modules),
+      [modules] {
+        auto instance = std::make_shared<YangContext>(defaultContextFlags());
+        configureModuleSources(*instance);
+        if (!modules.empty())
+          instance->loadModules(modules);
+        return instance;
+      });
+}
+
+std::shared_ptr<YangContext> Yang::getLazyContext() {
+  std::lock_guard<std::mutex> lock(lazy_mutex);
+  return lazyContext(lazyModules());
+}
+
+std::shared_ptr<YangContext>
+Yang::getContextWith(std::span<const ModuleSpec> modules) {
+  std::lock_guard<std::mutex> lock(lazy_mutex);
+  std::vector<ModuleSpec> all = lazyModules();
+  for (const auto &m : modules) {
+    bool known = false;
+    for (const auto &k : all)
+      known = known || (std::get<0>(k) == std::get<0>(m) &&
+                        std::get<1>(k) == std::get<1>(m));
+    if (!known)
+      all.push_back(m);
+  }
+  // a failed build leaves the module set as it was
+  auto ctx = lazyContext(all);
+  lazyModules() = std::move(all);
+  return ctx;
+}
+
+YangSharedContext Yang::publishDefaultContext() {
+  return YangSharedContext::publish(*getDefaultContext());
+}
+
+YangContextPool &Yang::getDefaultPool() {
+  static YangContextPool pool(getDefaultContext(), 0, &compileDefaultContext);
+  return pool;
+}
@@ -1,8 +1,14 @@
 #include "YangContext.hpp"
+#include "EmbeddedModules.hpp"
 #include "Exceptions.hpp"
 #include "YangSchemaModule.hpp"
 
 #include <libyang/libyang.h>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace yang;
 
@@ -14,7 +20,18 @@ YangContext::YangContext(unsigned options) : options_(options) {
   }
 }
 
-YangContext::YangContext(struct ly_ctx *raw_ctx) noexcept : ctx_(raw_ctx) {}
+// the options an adopted context was created (or printed) with
+static unsigned optionsOf(const struct ly_ctx *raw_ctx) noexcept {
+  return raw_ctx ? ly_ctx_get_options(raw_ctx) : 0;
+}
+
+YangContext::YangContext(struct ly_ctx *raw_ctx) noexcept
+    : ctx_(raw_ctx), options_(optionsOf(raw_ctx)) {}
+
+YangContext::YangContext(struct ly_ctx *raw_ctx,
+                         std::shared_ptr<void> storage) noexcept
+    : ctx_(raw_ctx), options_(optionsOf(raw_ctx)),
+      storage_(std::move(storage)) {}
 
 YangContext::~YangContext() {
   if (ctx_) {
@@ -30,28 +47,175 @@ void YangContext::addSearchPath(const std::string &path) {
   search_paths_.push_back(path);
 }
 
+void YangContext::setModuleIndex(std::shared_ptr<const ModuleIndex> index) {
+  if (!ctx_)
+    return;
+  // the callback's user data must stay valid for as long as it is installed
+  if (index)
+    ly_ctx_set_module_imp_clb(ctx_, &ModuleIndex::importCallback,
+                              const_cast<ModuleIndex *>(index.get()));
+  else
+    ly_ctx_set_module_imp_clb(ctx_, nullptr, nullptr);
+  module_index_ = std::move(index);
+}
+
+bool YangContext::useEmbeddedModules() {
+  if (!ctx_ || embeddedModules().empty())
+    return false;
+  ly_ctx_set_module_imp_clb(ctx_, &embeddedModuleImportCallback, nullptr);
+  module_index_.reset();
+  return true;
+}
+
 struct lys_module *YangContext::loadModuleInContext(const std::string &name,
                                                     const std::string &revision,
                                                     const char **features) {
+  if (isPrinted())
+    throw std::logic_error("cannot load modules into a printed context");
   const char *rev = revision.empty() ? nullptr : revision.c_str();
   struct lys_module *mod =
       ly_ctx_load_module(ctx_, name.c_str(), rev, features);
+  generation_.fetch_add(1, std::memory_order_release);
   if (!mod)
     throw YangDataError(*this);
   return mod;
 }
 
-YangSchemaModule
-YangContext::GetLoadedModuleByName(const std::string &name) const {
+ModuleLoadStats
+YangContext::loadModules(std::span<const ModuleSpec> modules) {
+  if (isPrinted())
+    throw std::logic_error("cannot load modules into a printed context");
   if (!ctx_)
-    return YangSchemaModule(nullptr);
+    throw YangError();
+
+  // Switch to explicit compilation for the duration of the batch unless the
+  // caller created the context that way already.
+  const bool was_explicit =
+      (ly_ctx_get_options(ctx_) & LY_CTX_EXPLICIT_COMPILE) != 0;
+  if (!was_explicit &&
+      ly_ctx_set_options(ctx_, LY_CTX_EXPLICIT_COMPILE) != LY_SUCCESS)
+    throw YangDataError(*this);
+  struct RestoreOptions {
+    struct ly_ctx *ctx;
+    bool active;
+    ~RestoreOptions() {
+      if (active)
+        ly_ctx_unset_options(ctx, LY_CTX_EXPLICIT_COMPILE);
+    }
+  } restore{ctx_, !was_explicit};
+
+  using clock = std::chrono::steady_clock;
+  ModuleLoadStats stats;
+  const auto start = clock::now();
+  for (const auto &m : modules) {
+    try {
+      loadModuleInContext(std::get<0>(m), std::get<1>(m), std::get<2>(m));
+    } catch (...) {
+      // libyang cannot unload the modules parsed before the failure; compile
+      // them so they are not picked up uncompiled by a later load
+      ly_ctx_compile(ctx_);
+      generation_.fetch_add(1, std::memory_order_release);
+      throw;
+    }
+    ++stats.modules;
+  }
+  const auto parsed = clock::now();
+  const LY_ERR compiled_rc = ly_ctx_compile(ctx_);
+  generation_.fetch_add(1, std::memory_order_release);
+  if (compiled_rc != LY_SUCCESS)
+    throw YangDataError(*this);
+  const auto compiled = clock::now();
+
+  stats.parse = parsed - start;
+  stats.compile = compiled - parsed;
+  load_stats_ = stats;
+  (void)moduleCache(); // index the new module set right away
+  return stats;
+}
+
+ModuleLoadStats
+YangContext::ensureModules(std::span<const ModuleSpec> modules) {
+  std::lock_guard<std::mutex> lock(ensure_mutex_);
+  std::vector<ModuleSpec> missing;
+  for (const auto &m : modules) {
+    const std::string &rev = std::get<1>(m);
+    const struct lys_module *mod = ly_ctx_get_module(
+        ctx_, std::get<0>(m).c_str(), rev.empty() ? nullptr : rev.c_str());
+    if (!mod || !mod->implemented)
+      missing.push_back(m);
+  }
+  if (missing.empty())
+    return ModuleLoadStats{};
+  return loadModules(missing);
+}
+
+struct YangContext::ModuleCache {
+  Version version;
+  // keys point into the libyang dictionary and live as long as the modules
+  std::unordered_map<std::string_view, std::vector<const struct lys_module *>>
+      by_name;
+  std::unordered_map<std::string_view, const struct lys_module *> by_ns;
+};
+
+std::shared_ptr<const YangContext::ModuleCache>
+YangContext::moduleCache() const {
+  if (!ctx_)
+    return nullptr;
+  const Version version = currentVersion();
+  auto cache = module_cache_.load(std::memory_order_acquire);
+  if (cache && cache->version == version)
+    return cache;
+
+  auto fresh = std::make_shared<ModuleCache>();
+  fresh->version = version;
   uint32_t idx = 0;
   const struct lys_module *m = nullptr;
   while ((m = ly_ctx_get_module_iter(ctx_, &idx)) != nullptr) {
-    YangSchemaModule mod(m);
-    const char *n = mod.name();
-    if (n && name == n)
-      return mod;
+    if (!m->name)
+      continue;
+    fresh->by_name[m->name].push_back(m);
+    if (m->ns) {
+      auto [it, inserted] = fresh->by_ns.emplace(m->ns, m);
+      if (!inserted && m->implemented && !it->second->implemented)
+        it->second = m;
+    }
+  }
+  // Concurrent readers may rebuild the same tables; either copy is valid.
+  cache = std::move(fresh);
+  module_cache_.store(cache, std::memory_order_release);
+  return cache;
+}
+
+YangSchemaModule
+YangContext::GetLoadedModuleByName(std::string_view name) const {
+  auto cache = moduleCache();
+  if (!cache)
+    return YangSchemaModule(nullptr);
+  auto it = cache->by_name.find(name);
+  return YangSchemaModule(it == cache->by_name.end() ? nullptr
+                                                     : it->second.front());
+}
+
+YangSchemaModule YangContext::GetLoadedModule(std::string_view name,
+                                              std::string_view revision) const {
+  auto cache = moduleCache();
+  if (!cache)
+    return YangSchemaModule(nullptr);
+  auto it = cache->by_name.find(name);
+  if (it == cache->by_name.end())
+    return YangSchemaModule(nullptr);
+  for (const struct lys_module *m : it->second) {
+    if (revision == (m->revision ? m->revision : ""))
+      return YangSchemaModule(m);
   }
   return YangSchemaModule(nullptr);
 }
+
+YangSchemaModule
+YangContext::GetLoadedModuleByNamespace(std::string_view ns) const {
+  auto cache = moduleCache();
+  if (!cache)
+    return YangSchemaModule(nullptr);
+  auto it = cache->by_ns.find(ns);
+  return YangSchemaModule(it == cache->by_ns.end() ? nullptr : it->second);
+}
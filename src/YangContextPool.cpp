@@ -0,0 +1,128 @@
+#include "YangContextPool.hpp"
+#include "Exceptions.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <libyang/libyang.h>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+using namespace yang;
+
+YangContextPool::Lease::Lease(Lease &&other) noexcept
+    : pool_(std::exchange(other.pool_, nullptr)),
+      ctx_(std::move(other.ctx_)) {}
+
+YangContextPool::Lease &
+YangContextPool::Lease::operator=(Lease &&other) noexcept {
+  if (this != &other) {
+    release();
+    pool_ = std::exchange(other.pool_, nullptr);
+    ctx_ = std::move(other.ctx_);
+  }
+  return *this;
+}
+
+YangContextPool::Lease::~Lease() { release(); }
+
+void YangContextPool::Lease::release() noexcept {
+  if (pool_ && ctx_)
+    pool_->giveBack(std::move(ctx_));
+  pool_ = nullptr;
+  ctx_.reset();
+}
+
+YangContextPool::YangContextPool(std::shared_ptr<YangContext> master,
+                                 std::size_t capacity, Builder fallback)
+    : master_(std::move(master)), capacity_(capacity),
+      fallback_(std::move(fallback)) {
+  if (!master_ || !master_->raw())
+    throw std::invalid_argument("YangContextPool: no master context");
+  if (capacity_ == 0)
+    capacity_ = std::max(1u, std::thread::hardware_concurrency());
+}
+
+YangContextPool::~YangContextPool() = default;
+
+std::shared_ptr<YangContext> YangContextPool::clone(const YangContext &master) {
+  int size = 0;
+  if (!master.raw() ||
+      ly_ctx_compiled_size(master.raw(), &size) != LY_SUCCESS || size <= 0)
+    return nullptr;
+
+  // The printed context references its own buffer by absolute address, so
+  // the buffer is owned by the clone and released after ly_ctx_destroy().
+  std::shared_ptr<void> storage(std::malloc(static_cast<std::size_t>(size)),
+                                &std::free);
+  if (!storage)
+    return nullptr;
+  void *end = nullptr;
+  if (ly_ctx_compiled_print(master.raw(), storage.get(), &end) != LY_SUCCESS)
+    return nullptr;
+
+  struct ly_ctx *raw = nullptr;
+  if (ly_ctx_new_printed(storage.get(), &raw) != LY_SUCCESS || !raw)
+    return nullptr;
+  return std::make_shared<YangContext>(raw, std::move(storage));
+}
+
+std::shared_ptr<YangContext> YangContextPool::create() {
+  if (auto ctx = clone(*master_))
+    return ctx;
+  if (fallback_) {
+    if (auto ctx = fallback_())
+      return ctx;
+  }
+  throw YangDataError(*master_);
+}
+
+YangContextPool::Lease
+YangContextPool::take(std::unique_lock<std::mutex> &lock) {
+  if (!idle_.empty()) {
+    auto ctx = std::move(idle_.back());
+    idle_.pop_back();
+    return Lease(this, std::move(ctx));
+  }
+
+  // Reserve the slot, then build outside the lock so other threads can keep
+  // leasing idle contexts meanwhile.
+  ++created_;
+  lock.unlock();
+  try {
+    return Lease(this, create());
+  } catch (...) {
+    lock.lock();
+    --created_;
+    lock.unlock();
+    available_.notify_one();
+    throw;
+  }
+}
+
+YangContextPool::Lease YangContextPool::acquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  available_.wait(lock,
+                  [this] { return !idle_.empty() || created_ < capacity_; });
+  return take(lock);
+}
+
+YangContextPool::Lease YangContextPool::tryAcquire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (idle_.empty() && created_ >= capacity_)
+    return Lease();
+  return take(lock);
+}
+
+std::size_t YangContextPool::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return created_;
+}
+
+void YangContextPool::giveBack(std::shared_ptr<YangContext> ctx) noexcept {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(ctx));
+  }
+  available_.notify_one();
+}
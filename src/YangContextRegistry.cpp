@@ -0,0 +1,68 @@
+#include "YangContextRegistry.hpp"
+
+#include <format>
+#include <utility>
+
+using namespace yang;
+
+YangContextRegistry &YangContextRegistry::global() {
+  static YangContextRegistry registry;
+  return registry;
+}
+
+std::string YangContextRegistry::key(unsigned options,
+                                     std::span<const ModuleSpec> modules) {
+  std::string k = std::format("{:x}", options);
+  for (const auto &m : modules) {
+    k += std::format("|{}@{}", std::get<0>(m), std::get<1>(m));
+    if (const char **features = std::get<2>(m)) {
+      k += '[';
+      for (const char **f = features; *f; ++f) {
+        k += *f;
+        k += ',';
+      }
+      k += ']';
+    }
+  }
+  return k;
+}
+
+std::shared_ptr<YangContextRegistry::Slot>
+YangContextRegistry::slot(const std::string &key) const {
+  auto map = slots_.load(std::memory_order_acquire);
+  auto it = map->find(key);
+  return it == map->end() ? nullptr : it->second;
+}
+
+std::shared_ptr<YangContext>
+YangContextRegistry::find(const std::string &key) const {
+  auto s = slot(key);
+  return s ? s->ctx.load(std::memory_order_acquire) : nullptr;
+}
+
+std::shared_ptr<YangContext>
+YangContextRegistry::get(const std::string &key, const Builder &build) {
+  auto s = slot(key);
+  if (!s) {
+    // Slow path, first request for this key: publish a new map with an
+    // empty slot. Insertions are serialized, lookups are not.
+    std::lock_guard<std::mutex> lock(insert_mutex_);
+    auto map = slots_.load(std::memory_order_acquire);
+    auto it = map->find(key);
+    if (it != map->end()) {
+      s = it->second;
+    } else {
+      auto next = std::make_shared<SlotMap>(*map);
+      s = std::make_shared<Slot>();
+      next->emplace(key, s);
+      slots_.store(std::move(next), std::memory_order_release);
+    }
+  }
+
+  if (auto ctx = s->ctx.load(std::memory_order_acquire))
+    return ctx;
+  std::call_once(s->once, [&] {
+    s->ctx.store(build(), std::memory_order_release);
+  });
+  return s->ctx.load(std::memory_order_acquire);
+}
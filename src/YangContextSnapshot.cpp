@@ -0,0 +1,255 @@
+#include "YangContextSnapshot.hpp"
+#include "EmbeddedModules.hpp"
+#include "ModuleIndex.hpp"
+#include "PrintedImage.hpp"
+#include "YangContext.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <libyang/libyang.h>
+#include <libyang/version.h>
+#include <memory>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <utility>
+
+using namespace yang;
+using namespace yang::detail;
+
+namespace {
+
+  constexpr char kMagic[8] = {'Y', 'A', 'N', 'G', 'C', 'T', 'X', '\0'};
+
+  // File layout: header, `dep_count` dependency records (each followed by
+  // `path_len` bytes of path), padding, then the page-aligned image.
+  struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t format_version;
+    std::uint32_t dep_count;
+    std::uint64_t fingerprint;
+    std::uint64_t base_address;
+    std::uint64_t image_size;
+    std::uint64_t image_offset;
+  };
+  static_assert(sizeof(SnapshotHeader) == 48);
+
+  struct DepRecord {
+    std::int64_t mtime_sec;
+    std::int64_t mtime_nsec;
+    std::uint32_t path_len;
+    std::uint32_t reserved;
+  };
+  static_assert(sizeof(DepRecord) == 24);
+
+  // The dependency records of a snapshot, each file listed once.
+  struct DepList {
+    std::string records;
+    std::uint32_t count = 0;
+    std::unordered_set<std::string> seen;
+
+    void add(const char *path) {
+      if (!path || !seen.insert(path).second)
+        return;
+      struct stat st;
+      if (::stat(path, &st) != 0)
+        return;
+      DepRecord rec{};
+      rec.mtime_sec = st.st_mtim.tv_sec;
+      rec.mtime_nsec = st.st_mtim.tv_nsec;
+      rec.path_len = static_cast<std::uint32_t>(std::strlen(path));
+      records.append(reinterpret_cast<const char *>(&rec), sizeof(rec));
+      records.append(path, rec.path_len);
+      ++count;
+    }
+  };
+
+  void fnv1a(std::uint64_t &h, const void *data, std::size_t len) {
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+    for (std::size_t i = 0; i < len; ++i) {
+      h ^= p[i];
+      h *= 0x100000001b3ULL;
+    }
+  }
+
+  void fnv1a(std::uint64_t &h, const std::string &s) {
+    fnv1a(h, s.data(), s.size() + 1); // include the terminator as separator
+  }
+
+} // namespace
+
+YangContextSnapshot::YangContextSnapshot(std::string path,
+                                         std::uint64_t fingerprint)
+    : path_(std::move(path)), fingerprint_(fingerprint) {}
+
+std::uint64_t
+YangContextSnapshot::fingerprint(unsigned options,
+                                 const std::vector<ModuleSpec> &modules,
+                                 const std::vector<std::string> &paths) {
+  std::uint64_t h = 0xcbf29ce484222325ULL;
+  fnv1a(h, std::string(LY_VERSION));
+  // embedded modules have no file to check, so their text counts here
+  fnv1a(h, std::string(embeddedModulesDigest()));
+  fnv1a(h, &options, sizeof(options));
+  for (const auto &m : modules) {
+    fnv1a(h, std::get<0>(m));
+    fnv1a(h, std::get<1>(m));
+    const char **features = std::get<2>(m);
+    // distinguish "no feature array" from an empty one
+    fnv1a(h, std::string(features ? "[" : "-"));
+    for (const char **f = features; f && *f; ++f)
+      fnv1a(h, std::string(*f));
+  }
+  for (const auto &p : paths)
+    fnv1a(h, p);
+  return h;
+}
+
+std::shared_ptr<YangContext> YangContextSnapshot::load() const {
+  FdGuard file{::open(path_.c_str(), O_RDONLY | O_CLOEXEC)};
+  if (file.fd < 0)
+    return nullptr;
+
+  SnapshotHeader hdr;
+  if (!readAll(file.fd, &hdr, sizeof(hdr), 0))
+    return nullptr;
+  if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 ||
+      hdr.format_version != kFormatVersion ||
+      hdr.fingerprint != fingerprint_ || hdr.image_size == 0 ||
+      hdr.image_offset % pageSize() != 0)
+    return nullptr;
+
+  // Any YANG file that changed since the snapshot was taken invalidates it.
+  off_t off = sizeof(hdr);
+  for (std::uint32_t i = 0; i < hdr.dep_count; ++i) {
+    DepRecord rec;
+    if (!readAll(file.fd, &rec, sizeof(rec), off))
+      return nullptr;
+    off += sizeof(rec);
+    std::string dep(rec.path_len, '\0');
+    if (!readAll(file.fd, dep.data(), dep.size(), off))
+      return nullptr;
+    off += rec.path_len;
+
+    struct stat st;
+    if (::stat(dep.c_str(), &st) != 0 || st.st_mtim.tv_sec != rec.mtime_sec ||
+        st.st_mtim.tv_nsec != rec.mtime_nsec)
+      return nullptr;
+  }
+
+  struct stat st;
+  if (::fstat(file.fd, &st) != 0 ||
+      static_cast<std::uint64_t>(st.st_size) <
+          hdr.image_offset + hdr.image_size)
+    return nullptr;
+
+  // MAP_PRIVATE: pages stay shared with the page cache until libyang writes
+  // to them, and nothing is ever written back to the snapshot file.
+  const std::size_t len = roundUp(hdr.image_size, pageSize());
+  void *image = mapAt(reinterpret_cast<void *>(hdr.base_address), len,
+                      PROT_READ | PROT_WRITE, false, file.fd,
+                      static_cast<off_t>(hdr.image_offset));
+  if (!image)
+    return nullptr;
+
+  struct ly_ctx *raw = nullptr;
+  if (ly_ctx_new_printed(image, &raw) != LY_SUCCESS || !raw) {
+    ::munmap(image, len);
+    return nullptr;
+  }
+  std::shared_ptr<void> storage(image,
+                                [len](void *p) { ::munmap(p, len); });
+  return std::make_shared<YangContext>(raw, std::move(storage));
+}
+
+bool YangContextSnapshot::save(const YangContext &ctx) const {
+  if (!ctx.raw() || ctx.isPrinted())
+    return false;
+
+  int size = 0;
+  if (ly_ctx_compiled_size(ctx.raw(), &size) != LY_SUCCESS || size <= 0)
+    return false;
+
+  // Print into a scratch mapping at the preferred base so the image can be
+  // mapped back at the same address by later processes.
+  const std::size_t len = roundUp(static_cast<std::size_t>(size), pageSize());
+  void *base = mapForPrint(len, -1, 0);
+  if (!base)
+    return false;
+  struct Unmap {
+    void *p;
+    std::size_t n;
+    ~Unmap() { ::munmap(p, n); }
+  } unmap{base, len};
+
+  void *end = nullptr;
+  if (ly_ctx_compiled_print(ctx.raw(), base, &end) != LY_SUCCESS || !end)
+    return false;
+  const std::size_t image_size = static_cast<std::size_t>(
+      static_cast<char *>(end) - static_cast<char *>(base));
+
+  // Record every module file the context was built from. Modules served
+  // by a ModuleIndex have no filepath; their files are looked up in the
+  // index the way its import callback found them, and the directories it
+  // scanned are recorded too, so a module added next to them also counts.
+  DepList deps;
+  const ModuleIndex *index = ctx.moduleIndex().get();
+  auto source = [index](const char *filepath, const char *name,
+                        const char *rev) -> const char * {
+    if (filepath || !index || !name)
+      return filepath;
+    const ModuleIndex::Entry *e = index->find(name, rev ? rev : "");
+    return e ? e->path.c_str() : nullptr;
+  };
+  uint32_t idx = 0;
+  const struct lys_module *m = nullptr;
+  while ((m = ly_ctx_get_module_iter(ctx.raw(), &idx)) != nullptr) {
+    deps.add(source(m->filepath, m->name, m->revision));
+    if (!m->parsed)
+      continue;
+    LY_ARRAY_FOR(m->parsed->includes, i) {
+      const struct lysp_include &inc = m->parsed->includes[i];
+      deps.add(source(inc.submodule ? inc.submodule->filepath : nullptr,
+                      inc.name, inc.rev));
+    }
+  }
+  if (index) {
+    for (const auto &dir : index->scannedDirectories())
+      deps.add(dir.c_str());
+  }
+
+  SnapshotHeader hdr{};
+  std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.format_version = kFormatVersion;
+  hdr.dep_count = deps.count;
+  hdr.fingerprint = fingerprint_;
+  hdr.base_address = reinterpret_cast<std::uintptr_t>(base);
+  hdr.image_size = image_size;
+  hdr.image_offset =
+      roundUp(sizeof(hdr) + deps.records.size(), pageSize());
+
+  const std::string tmp = path_ + ".tmp." + std::to_string(::getpid());
+  {
+    FdGuard out{::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                       0644)};
+    if (out.fd < 0)
+      return false;
+    const std::string pad(
+        hdr.image_offset - sizeof(hdr) - deps.records.size(), '\0');
+    if (!writeAll(out.fd, &hdr, sizeof(hdr)) ||
+        !writeAll(out.fd, deps.records.data(), deps.records.size()) ||
+        !writeAll(out.fd, pad.data(), pad.size()) ||
+        !writeAll(out.fd, base, image_size)) {
+      ::unlink(tmp.c_str());
+      return false;
+    }
+  }
+  if (::rename(tmp.c_str(), path_.c_str()) != 0) {
+    ::unlink(tmp.c_str());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,146 @@
+#include "YangIdentity.hpp"
+#include "YangContext.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <libyang/libyang.h>
+#include <mutex>
+#include <shared_mutex>
+
+using namespace yang;
+
+namespace {
+
+  // Interned "module:name" pairs; handle n is entries[n - 1]. A deque keeps
+  // the strings in place as it grows, so views into them stay valid.
+  struct Registry {
+    struct Entry {
+      std::string module;
+      std::string name;
+    };
+
+    std::shared_mutex mutex;
+    std::deque<Entry> entries;
+    std::unordered_map<std::string, std::uint32_t> ids; // by "module:name"
+
+    static Registry &get() {
+      static Registry registry;
+      return registry;
+    }
+
+    std::uint32_t intern(std::string_view module, std::string_view name) {
+      std::string key;
+      key.reserve(module.size() + 1 + name.size());
+      key.append(module).append(1, ':').append(name);
+      {
+        std::shared_lock lock(mutex);
+        if (auto it = ids.find(key); it != ids.end())
+          return it->second;
+      }
+      std::unique_lock lock(mutex);
+      auto [it, inserted] =
+          ids.emplace(std::move(key), static_cast<std::uint32_t>(0));
+      if (inserted) {
+        entries.push_back({std::string(module), std::string(name)});
+        it->second = static_cast<std::uint32_t>(entries.size());
+      }
+      return it->second;
+    }
+
+    const Entry &entry(std::uint32_t id) {
+      std::shared_lock lock(mutex);
+      return entries[id - 1];
+    }
+  };
+
+} // namespace
+
+YangIdentity::YangIdentity(std::string_view module, std::string_view name)
+    : id_(Registry::get().intern(module, name)) {}
+
+YangIdentity YangIdentity::parse(std::string_view identity,
+                                 std::string_view default_module) {
+  const auto colon = identity.find(':');
+  if (colon == std::string_view::npos)
+    return YangIdentity(default_module, identity);
+  return YangIdentity(identity.substr(0, colon), identity.substr(colon + 1));
+}
+
+std::string_view YangIdentity::module() const {
+  return id_ ? std::string_view(Registry::get().entry(id_).module) : "";
+}
+
+std::string_view YangIdentity::name() const {
+  return id_ ? std::string_view(Registry::get().entry(id_).name) : "";
+}
+
+std::string YangIdentity::qualified() const {
+  if (!id_)
+    return {};
+  const auto &e = Registry::get().entry(id_);
+  return e.module + ':' + e.name;
+}
+
+bool YangIdentity::derivedFrom(const YangContext &ctx,
+                               YangIdentity base) const {
+  return ctx.schemaCache<YangIdentityTable>()->derivedFrom(*this, base);
+}
+
+YangIdentityTable::YangIdentityTable(const YangContext &ctx) {
+  if (!ctx.raw())
+    return;
+
+  // libyang records the identities derived from each one; invert that
+  std::unordered_map<const struct lysc_ident *,
+                     std::vector<const struct lysc_ident *>>
+      direct;
+  uint32_t idx = 0;
+  const struct lys_module *m = nullptr;
+  while ((m = ly_ctx_get_module_iter(ctx.raw(), &idx)) != nullptr) {
+    LY_ARRAY_FOR(m->identities, i) {
+      const struct lysc_ident *ident = &m->identities[i];
+      const YangIdentity id(m->name, ident->name);
+      handles_.emplace(ident, id);
+      // with several revisions loaded, the implemented one wins
+      auto [it, inserted] = idents_.emplace(id.id(), ident);
+      if (!inserted && m->implemented)
+        it->second = ident;
+      LY_ARRAY_FOR(ident->derived, d)
+        direct[ident->derived[d]].push_back(ident);
+    }
+  }
+
+  for (const auto &[ident, id] : handles_) {
+    auto &bases = bases_[id.id()];
+    std::vector<const struct lysc_ident *> pending = direct[ident];
+    while (!pending.empty()) {
+      const struct lysc_ident *base = pending.back();
+      pending.pop_back();
+      auto base_id = handles_.find(base);
+      if (base_id == handles_.end() ||
+          std::find(bases.begin(), bases.end(), base_id->second) !=
+              bases.end())
+        continue;
+      bases.push_back(base_id->second);
+      const auto &up = direct[base];
+      pending.insert(pending.end(), up.begin(), up.end());
+    }
+  }
+}
+
+const struct lysc_ident *YangIdentityTable::find(YangIdentity id) const {
+  auto it = idents_.find(id.id());
+  return it != idents_.end() ? it->second : nullptr;
+}
+
+bool YangIdentityTable::derivedFrom(YangIdentity id, YangIdentity base) const {
+  if (id == base)
+    return static_cast<bool>(id);
+  auto it = bases_.find(id.id());
+  if (it == bases_.end())
+    return false;
+  for (YangIdentity b : it->second)
+    if (b == base)
+      return true;
+  return false;
+}
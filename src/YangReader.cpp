@@ -0,0 +1,600 @@
+#include "YangReader.hpp"
+#include "Exceptions.hpp"
+
+#include <cerrno>
+#include <charconv>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+using namespace yang;
+
+YangInput YangInput::fromString(std::string_view data) {
+  YangInput in;
+  in.pos_ = data.data();
+  in.end_ = data.data() + data.size();
+  return in;
+}
+
+YangInput YangInput::fromFd(int fd, std::size_t buffer_size) {
+  YangInput in;
+  in.fd_ = fd;
+  in.buf_.resize(buffer_size ? buffer_size : 1);
+  return in;
+}
+
+YangInput YangInput::fromCallback(Callback cb, std::size_t buffer_size) {
+  YangInput in;
+  in.cb_ = std::move(cb);
+  in.buf_.resize(buffer_size ? buffer_size : 1);
+  return in;
+}
+
+bool YangInput::refill() {
+  if (buf_.empty())
+    return false; // fromString(), or already at the end
+  std::size_t n = 0;
+  if (cb_) {
+    n = cb_(buf_.data(), buf_.size());
+  } else {
+    ssize_t r;
+    do
+      r = ::read(fd_, buf_.data(), buf_.size());
+    while (r < 0 && errno == EINTR);
+    if (r < 0)
+      throw std::system_error(errno, std::generic_category(),
+                              "YangInput: read");
+    n = static_cast<std::size_t>(r);
+  }
+  if (n == 0)
+    return false;
+  pos_ = buf_.data();
+  end_ = pos_ + n;
+  return true;
+}
+
+static bool isSpace(int c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static void appendUtf8(std::string &out, unsigned long cp) {
+  if (cp < 0x80) {
+    out.push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out.push_back(static_cast<char>(0xc0 | (cp >> 6)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else if (cp < 0x10000) {
+    out.push_back(static_cast<char>(0xe0 | (cp >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  } else {
+    out.push_back(static_cast<char>(0xf0 | (cp >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (cp & 0x3f)));
+  }
+}
+
+YangReader::YangReader(const YangContext &ctx, YangInput &in,
+                       YangFormat format)
+    : ctx_(&ctx), in_(in), format_(format) {}
+
+YangReader::YangReader(YangInput &in)
+    : ctx_(nullptr), in_(in), format_(YangFormat::Json) {}
+
+const YangContext &YangReader::context() const {
+  if (!ctx_)
+    throw std::logic_error("YangReader: no context");
+  return *ctx_;
+}
+
+void YangReader::fail(const std::string &what) const {
+  throw YangParseError(what, line_);
+}
+
+void YangReader::skipSpace() {
+  while (isSpace(in_.peek()))
+    get();
+}
+
+void YangReader::expect(char c) {
+  int got = get();
+  if (got != c)
+    fail(std::string("expected '") + c + "'" +
+         (got < 0 ? " before end of input" : ""));
+}
+
+YangReader::Event YangReader::step() {
+  Event e = format_ == YangFormat::Xml ? advanceXml() : advanceJson();
+  if (e == Event::Begin)
+    ++depth_;
+  else if (e == Event::End)
+    --depth_;
+  return e;
+}
+
+bool YangReader::nextChild(std::size_t level) {
+  for (;;) {
+    if (depth_ < level)
+      return false;
+    Event e = step();
+    if (e == Event::Done)
+      return false;
+    if (e == Event::Begin && depth_ == level + 1)
+      return true;
+  }
+}
+
+void YangReader::leafValue() {
+  leaf_closed_ = false;
+  switch (step()) {
+  case Event::Value:
+    return;
+  case Event::End: // JSON {} where a value was expected
+    text_.clear();
+    leaf_closed_ = true;
+    return;
+  default:
+    fail("expected a value for '" + name_ + "'");
+  }
+}
+
+std::string_view YangReader::text() {
+  leafValue();
+  if (!leaf_closed_ && step() != Event::End)
+    fail("expected the end of '" + name_ + "'");
+  return text_;
+}
+
+std::string YangReader::identity() {
+  leafValue();
+  std::string_view value = text_;
+  std::string_view prefix;
+  if (auto colon = value.find(':'); colon != std::string_view::npos) {
+    prefix = value.substr(0, colon);
+    value.remove_prefix(colon + 1);
+  }
+
+  std::string result;
+  if (format_ == YangFormat::Json) {
+    // unqualified identities belong to the leaf's module (RFC 7951 6.8)
+    result = prefix.empty() ? module_ : std::string(prefix);
+  } else {
+    // the element's namespace declarations are still in scope here
+    std::string_view ns = xmlNamespace(prefix);
+    auto mod = ns.empty() ? YangSchemaModule() :
+                            ctx_->GetLoadedModuleByNamespace(ns);
+    if (!mod)
+      fail("unknown prefix '" + std::string(prefix) + "' in '" + text_ +
+           "'");
+    result = mod.name();
+  }
+  result += ':';
+  result += value;
+
+  if (!leaf_closed_ && step() != Event::End)
+    fail("expected the end of '" + name_ + "'");
+  return result;
+}
+
+// XML
+
+std::string_view YangReader::xmlNamespace(std::string_view prefix) const {
+  for (auto it = ns_scope_.rbegin(); it != ns_scope_.rend(); ++it)
+    if (it->first == prefix)
+      return it->second;
+  return {};
+}
+
+void YangReader::xmlName(std::string &out) {
+  out.clear();
+  for (int c = in_.peek(); c >= 0 && !isSpace(c) && c != '=' && c != '>' &&
+                           c != '/' && c != '<';
+       c = in_.peek())
+    out.push_back(static_cast<char>(get()));
+  if (out.empty())
+    fail("expected a name");
+}
+
+void YangReader::xmlEntity(std::string &out) {
+  // the '&' has been consumed
+  char ref[12];
+  std::size_t n = 0;
+  for (int c = get(); c != ';'; c = get()) {
+    if (c < 0 || n == sizeof(ref))
+      fail("unterminated entity reference");
+    ref[n++] = static_cast<char>(c);
+  }
+  std::string_view name(ref, n);
+  if (name == "lt")
+    out.push_back('<');
+  else if (name == "gt")
+    out.push_back('>');
+  else if (name == "amp")
+    out.push_back('&');
+  else if (name == "quot")
+    out.push_back('"');
+  else if (name == "apos")
+    out.push_back('\'');
+  else if (name.size() > 1 && name[0] == '#') {
+    int base = 10;
+    name.remove_prefix(1);
+    if (name[0] == 'x') {
+      base = 16;
+      name.remove_prefix(1);
+    }
+    unsigned long cp = 0;
+    auto [end, ec] =
+        std::from_chars(name.data(), name.data() + name.size(), cp, base);
+    if (ec != std::errc() || end != name.data() + name.size() ||
+        cp > 0x10ffff)
+      fail("bad character reference");
+    appendUtf8(out, cp);
+  } else {
+    fail("unknown entity '&" + std::string(name) + ";'");
+  }
+}
+
+void YangReader::xmlSkipPast(std::string_view end, std::string *out) {
+  // naive matching is enough for the terminators used ("?>", "-->", "]]>")
+  std::size_t matched = 0;
+  while (matched < end.size()) {
+    int c = get();
+    if (c < 0)
+      fail("expected '" + std::string(end) + "' before end of input");
+    if (out)
+      out->push_back(static_cast<char>(c));
+    if (c == end[matched])
+      ++matched;
+    else
+      matched = c == end[0] ? 1 : 0;
+  }
+  if (out)
+    out->resize(out->size() - end.size());
+}
+
+void YangReader::xmlStart() {
+  XmlElement el;
+  el.scope = ns_scope_.size();
+  xmlName(el.qname);
+
+  bool empty = false;
+  for (;;) {
+    skipSpace();
+    int c = in_.peek();
+    if (c == '>') {
+      get();
+      break;
+    }
+    if (c == '/') {
+      get();
+      expect('>');
+      empty = true;
+      break;
+    }
+    if (c < 0)
+      fail("unterminated start tag <" + el.qname + ">");
+
+    xmlName(scratch_);
+    skipSpace();
+    expect('=');
+    skipSpace();
+    int quote = get();
+    if (quote != '"' && quote != '\'')
+      fail("expected a quoted attribute value");
+    std::string value;
+    for (c = get(); c != quote; c = get()) {
+      if (c < 0)
+        fail("unterminated attribute value");
+      if (c == '&')
+        xmlEntity(value);
+      else
+        value.push_back(static_cast<char>(c));
+    }
+    // other attributes (metadata) are not part of the data
+    if (scratch_ == "xmlns")
+      ns_scope_.emplace_back(std::string(), std::move(value));
+    else if (scratch_.starts_with("xmlns:"))
+      ns_scope_.emplace_back(scratch_.substr(6), std::move(value));
+  }
+
+  std::string_view qname = el.qname;
+  std::string_view prefix;
+  if (auto colon = qname.find(':'); colon != std::string_view::npos) {
+    prefix = qname.substr(0, colon);
+    qname.remove_prefix(colon + 1);
+  }
+  std::string_view ns = xmlNamespace(prefix);
+  if (ns.empty() && !prefix.empty())
+    fail("unbound prefix in <" + el.qname + ">");
+  YangSchemaModule mod =
+      ns.empty() ? YangSchemaModule() : ctx_->GetLoadedModuleByNamespace(ns);
+  module_ = mod ? mod.name() : "";
+  name_ = qname;
+
+  if (!elements_.empty())
+    elements_.back().children = true;
+  elements_.push_back(std::move(el));
+  if (empty) {
+    text_.clear();
+    pending_ = Pending::Value;
+  }
+}
+
+YangReader::Event YangReader::advanceXml() {
+  if (pending_ == Pending::Value) {
+    pending_ = Pending::End;
+    return Event::Value;
+  }
+  if (pending_ == Pending::End) {
+    pending_ = Pending::None;
+    ns_scope_.resize(elements_.back().scope);
+    elements_.pop_back();
+    return Event::End;
+  }
+
+  // Character data is collected for every element but only reported for
+  // elements without children, i.e. leaves.
+  text_.clear();
+  for (;;) {
+    int c = get();
+    if (c < 0) {
+      if (!elements_.empty())
+        fail("unexpected end of input inside <" + elements_.back().qname +
+             ">");
+      return Event::Done;
+    }
+    if (c == '&') {
+      xmlEntity(text_);
+      continue;
+    }
+    if (c != '<') {
+      text_.push_back(static_cast<char>(c));
+      continue;
+    }
+
+    c = in_.peek();
+    if (c == '?') {
+      xmlSkipPast("?>");
+    } else if (c == '!') {
+      get();
+      if (in_.peek() == '-') {
+        get();
+        expect('-');
+        xmlSkipPast("-->");
+      } else if (in_.peek() == '[') {
+        for (char k : std::string_view("[CDATA["))
+          expect(k);
+        xmlSkipPast("]]>", &text_);
+      } else {
+        xmlSkipPast(">"); // <!DOCTYPE ...>
+      }
+    } else if (c == '/') {
+      get();
+      xmlName(scratch_);
+      skipSpace();
+      expect('>');
+      if (elements_.empty() || elements_.back().qname != scratch_)
+        fail("unexpected end tag </" + scratch_ + ">");
+      if (!elements_.back().children) {
+        pending_ = Pending::End;
+        return Event::Value;
+      }
+      ns_scope_.resize(elements_.back().scope);
+      elements_.pop_back();
+      return Event::End;
+    } else {
+      xmlStart();
+      return Event::Begin;
+    }
+  }
+}
+
+// JSON (RFC 7951)
+
+void YangReader::jsonString(std::string &out) {
+  out.clear();
+  expect('"');
+  for (;;) {
+    int c = get();
+    if (c < 0)
+      fail("unterminated string");
+    if (c == '"')
+      return;
+    if (c < 0x20)
+      fail("control character in string");
+    if (c != '\\') {
+      out.push_back(static_cast<char>(c));
+      continue;
+    }
+    switch (c = get()) {
+    case '"':
+    case '\\':
+    case '/':
+      out.push_back(static_cast<char>(c));
+      break;
+    case 'b':
+      out.push_back('\b');
+      break;
+    case 'f':
+      out.push_back('\f');
+      break;
+    case 'n':
+      out.push_back('\n');
+      break;
+    case 'r':
+      out.push_back('\r');
+      break;
+    case 't':
+      out.push_back('\t');
+      break;
+    case 'u': {
+      auto hex4 = [this] {
+        char digits[4];
+        for (char &d : digits) {
+          int h = get();
+          if (h < 0)
+            fail("unterminated \\u escape");
+          d = static_cast<char>(h);
+        }
+        unsigned long v = 0;
+        auto [end, ec] = std::from_chars(digits, digits + 4, v, 16);
+        if (ec != std::errc() || end != digits + 4)
+          fail("bad \\u escape");
+        return v;
+      };
+      unsigned long cp = hex4();
+      if (cp >= 0xd800 && cp < 0xdc00) {
+        expect('\\');
+        expect('u');
+        unsigned long low = hex4();
+        if (low < 0xdc00 || low > 0xdfff)
+          fail("bad surrogate pair");
+        cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+      }
+      appendUtf8(out, cp);
+      break;
+    }
+    default:
+      fail("bad escape in string");
+    }
+  }
+}
+
+void YangReader::jsonScalar(std::string &out) {
+  if (in_.peek() == '"') {
+    jsonString(out);
+    return;
+  }
+  out.clear();
+  for (int c = in_.peek(); c >= 0 && !isSpace(c) && c != ',' && c != '}' &&
+                           c != ']';
+       c = in_.peek())
+    out.push_back(static_cast<char>(get()));
+  if (out.empty())
+    fail("expected a value");
+  if (out == "null") // [null]: value of an empty leaf
+    out.clear();
+}
+
+void YangReader::jsonSkipValue() {
+  int nesting = 0;
+  do {
+    skipSpace();
+    int c = in_.peek();
+    if (c == '"') {
+      jsonString(scratch_);
+    } else if (c == '{' || c == '[') {
+      get();
+      ++nesting;
+    } else if (c == '}' || c == ']') {
+      get();
+      --nesting;
+    } else if (c == ',' || c == ':') {
+      get();
+    } else {
+      jsonScalar(scratch_);
+    }
+  } while (nesting > 0);
+}
+
+YangReader::Event YangReader::jsonBegin(std::string module, std::string name) {
+  skipSpace();
+  int c = in_.peek();
+  if (c == '[')
+    fail("nested array in '" + name + "'");
+  if (c == '{') {
+    get();
+    json_.push_back({false, true, module, name});
+  } else {
+    jsonScalar(text_);
+    pending_ = Pending::Value;
+  }
+  module_ = std::move(module);
+  name_ = std::move(name);
+  return Event::Begin;
+}
+
+YangReader::Event YangReader::advanceJson() {
+  if (pending_ == Pending::Value) {
+    pending_ = Pending::End;
+    return Event::Value;
+  }
+  if (pending_ == Pending::End) {
+    pending_ = Pending::None;
+    return Event::End;
+  }
+
+  if (!json_started_) {
+    json_started_ = true;
+    skipSpace();
+    if (in_.peek() < 0)
+      return Event::Done;
+    expect('{');
+    json_.push_back({false, false, {}, {}});
+  }
+
+  for (;;) {
+    skipSpace();
+    if (json_.empty()) {
+      if (in_.peek() >= 0)
+        fail("data after the top-level object");
+      return Event::Done;
+    }
+
+    JsonFrame &frame = json_.back();
+    int c = in_.peek();
+    if (frame.array) {
+      if (c == ']') {
+        get();
+        json_.pop_back();
+        continue;
+      }
+      if (!frame.first)
+        expect(',');
+      frame.first = false;
+      return jsonBegin(frame.module, frame.name);
+    }
+
+    if (c == '}') {
+      get();
+      bool node = frame.node;
+      json_.pop_back();
+      if (node)
+        return Event::End;
+      continue;
+    }
+    if (!frame.first) {
+      expect(',');
+      skipSpace();
+    }
+    frame.first = false;
+
+    jsonString(scratch_);
+    skipSpace();
+    expect(':');
+    if (scratch_.starts_with('@')) { // metadata annotations
+      jsonSkipValue();
+      continue;
+    }
+    std::string module, name;
+    if (auto colon = scratch_.find(':'); colon != std::string::npos) {
+      module = scratch_.substr(0, colon);
+      name = scratch_.substr(colon + 1);
+    } else if (frame.node) {
+      module = frame.module;
+      name = scratch_;
+    } else {
+      fail("top-level member '" + scratch_ + "' without a module name");
+    }
+
+    skipSpace();
+    if (in_.peek() == '[') {
+      get();
+      json_.push_back({true, false, std::move(module), std::move(name)});
+      continue;
+    }
+    return jsonBegin(std::move(module), std::move(name));
+  }
+}
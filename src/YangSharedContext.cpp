@@ -0,0 +1,221 @@
+#include "YangSharedContext.hpp"
+#include "Exceptions.hpp"
+#include "PrintedImage.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <libyang/libyang.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+using namespace yang;
+using namespace yang::detail;
+
+namespace {
+
+  constexpr char kMagic[8] = {'Y', 'A', 'N', 'G', 'S', 'H', 'M', '\0'};
+
+  // Segment layout: this header in the first page, the image from
+  // `image_offset` (page-aligned) on.
+  struct SegmentHeader {
+    char magic[8];
+    std::uint32_t format_version;
+    std::uint32_t reserved;
+    std::uint64_t base_address;
+    std::uint64_t image_size;
+    std::uint64_t image_offset;
+  };
+  static_assert(sizeof(SegmentHeader) == 40);
+
+  [[noreturn]] void throwErrno(const char *what) {
+    throw std::system_error(errno, std::generic_category(), what);
+  }
+
+  int createAnonymous() {
+    int fd = -1;
+#if defined(MFD_CLOEXEC) && defined(MFD_ALLOW_SEALING)
+    fd = ::memfd_create("yang-context", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd >= 0)
+      return fd;
+#endif
+    // No memfd: an shm object that is unlinked right away behaves the same.
+    const std::string name = "/yang-context." + std::to_string(::getpid());
+    fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd >= 0)
+      ::shm_unlink(name.c_str());
+    return fd;
+  }
+
+} // namespace
+
+YangSharedContext::YangSharedContext(YangSharedContext &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), name_(std::move(other.name_)),
+      image_size_(other.image_size_) {}
+
+YangSharedContext &
+YangSharedContext::operator=(YangSharedContext &&other) noexcept {
+  if (this != &other) {
+    if (fd_ >= 0)
+      ::close(fd_);
+    fd_ = std::exchange(other.fd_, -1);
+    name_ = std::move(other.name_);
+    image_size_ = other.image_size_;
+  }
+  return *this;
+}
+
+YangSharedContext::~YangSharedContext() {
+  if (fd_ >= 0)
+    ::close(fd_);
+}
+
+YangSharedContext YangSharedContext::publish(const YangContext &ctx) {
+  int fd = createAnonymous();
+  if (fd < 0)
+    throwErrno("YangSharedContext: cannot create segment");
+  return publishTo(ctx, fd, std::string());
+}
+
+YangSharedContext YangSharedContext::publish(const YangContext &ctx,
+                                             const std::string &name) {
+  ::shm_unlink(name.c_str());
+  int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                      0644);
+  if (fd < 0)
+    throwErrno("YangSharedContext: shm_open");
+  try {
+    return publishTo(ctx, fd, name);
+  } catch (...) {
+    ::shm_unlink(name.c_str());
+    throw;
+  }
+}
+
+YangSharedContext YangSharedContext::publishTo(const YangContext &ctx, int fd,
+                                               std::string name) {
+  FdGuard guard{fd};
+  int size = 0;
+  if (!ctx.raw() ||
+      ly_ctx_compiled_size(ctx.raw(), &size) != LY_SUCCESS || size <= 0)
+    throw YangDataError(ctx);
+
+  const std::size_t len = roundUp(static_cast<std::size_t>(size), pageSize());
+  const off_t image_offset = static_cast<off_t>(pageSize());
+  if (::ftruncate(fd, image_offset + static_cast<off_t>(len)) != 0)
+    throwErrno("YangSharedContext: ftruncate");
+
+  // Print straight into the segment; the address it lands at is recorded
+  // so attach() can map it back at the same place.
+  void *base = mapForPrint(len, fd, image_offset);
+  if (!base)
+    throwErrno("YangSharedContext: mmap");
+  void *end = nullptr;
+  LY_ERR rc = ly_ctx_compiled_print(ctx.raw(), base, &end);
+  ::munmap(base, len);
+  if (rc != LY_SUCCESS || !end)
+    throw YangDataError(ctx);
+
+  SegmentHeader hdr{};
+  std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
+  hdr.format_version = kFormatVersion;
+  hdr.base_address = reinterpret_cast<std::uintptr_t>(base);
+  hdr.image_size = static_cast<std::uint64_t>(static_cast<char *>(end) -
+                                              static_cast<char *>(base));
+  hdr.image_offset = static_cast<std::uint64_t>(image_offset);
+  if (::pwrite(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr))
+    throwErrno("YangSharedContext: write header");
+
+#if defined(F_ADD_SEALS) && defined(F_SEAL_WRITE)
+  // memfd only; shm objects do not support seals and keep their mode bits.
+  (void)::fcntl(fd, F_ADD_SEALS,
+                F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+  guard.fd = -1;
+  return YangSharedContext(fd, std::move(name), hdr.image_size);
+}
+
+bool YangSharedContext::unlink(const std::string &name) {
+  return ::shm_unlink(name.c_str()) == 0;
+}
+
+std::shared_ptr<YangContext> YangSharedContext::attach(int fd) {
+  SegmentHeader hdr;
+  if (fd < 0 || !readAll(fd, &hdr, sizeof(hdr), 0))
+    return nullptr;
+  if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0 ||
+      hdr.format_version != kFormatVersion || hdr.image_size == 0 ||
+      hdr.image_offset % pageSize() != 0)
+    return nullptr;
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || static_cast<std::uint64_t>(st.st_size) <
+                                   hdr.image_offset + hdr.image_size)
+    return nullptr;
+
+  // MAP_PRIVATE over a sealed segment: all processes share the pages, and
+  // should libyang ever write to one, only this process gets a private copy.
+  const std::size_t len = roundUp(hdr.image_size, pageSize());
+  void *image = mapAt(reinterpret_cast<void *>(hdr.base_address), len,
+                      PROT_READ | PROT_WRITE, false, fd,
+                      static_cast<off_t>(hdr.image_offset));
+  if (!image)
+    return nullptr;
+
+  struct ly_ctx *raw = nullptr;
+  if (ly_ctx_new_printed(image, &raw) != LY_SUCCESS || !raw) {
+    ::munmap(image, len);
+    return nullptr;
+  }
+  std::shared_ptr<void> storage(image,
+                                [len](void *p) { ::munmap(p, len); });
+  return std::make_shared<YangContext>(raw, std::move(storage));
+}
+
+std::shared_ptr<YangContext>
+YangSharedContext::attach(const std::string &name) {
+  FdGuard fd{::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0)};
+  return fd.fd < 0 ? nullptr : attach(fd.fd);
+}
+
+ProcessMemoryUsage ProcessMemoryUsage::current() {
+  ProcessMemoryUsage usage;
+  std::ifstream in("/proc/self/smaps_rollup");
+  std::string line;
+  bool found = false;
+  while (std::getline(in, line)) {
+    std::istringstream ls(line);
+    std::string key;
+    std::size_t kb = 0;
+    if (!(ls >> key >> kb))
+      continue;
+    const std::size_t bytes = kb * 1024;
+    if (key == "Rss:") {
+      usage.rss = bytes;
+      found = true;
+    } else if (key == "Pss:") {
+      usage.pss = bytes;
+    } else if (key == "Shared_Clean:" || key == "Shared_Dirty:") {
+      usage.shared += bytes;
+    } else if (key == "Private_Clean:" || key == "Private_Dirty:") {
+      usage.private_ += bytes;
+    }
+  }
+  if (!found) {
+    struct rusage ru;
+    if (::getrusage(RUSAGE_SELF, &ru) == 0) {
+#if defined(__APPLE__)
+      usage.rss = static_cast<std::size_t>(ru.ru_maxrss);
+#else
+      usage.rss = static_cast<std::size_t>(ru.ru_maxrss) * 1024;
+#endif
+    }
+  }
+  return usage;
+}
@@ -0,0 +1,371 @@
+#include "YangWriter.hpp"
+#include "Exceptions.hpp"
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+using namespace yang;
+
+YangOutput YangOutput::toString(std::string &out) {
+  YangOutput o;
+  o.str_ = &out;
+  return o;
+}
+
+YangOutput YangOutput::toFd(int fd, std::size_t buffer_size) {
+  YangOutput o;
+  o.fd_ = fd;
+  o.limit_ = buffer_size ? buffer_size : 1;
+  o.buf_.reserve(o.limit_);
+  return o;
+}
+
+YangOutput YangOutput::toCallback(Callback cb, std::size_t buffer_size) {
+  YangOutput o;
+  o.cb_ = std::move(cb);
+  o.limit_ = buffer_size ? buffer_size : 1;
+  o.buf_.reserve(o.limit_);
+  return o;
+}
+
+YangOutput::~YangOutput() {
+  try {
+    flush();
+  } catch (...) {
+  }
+}
+
+void YangOutput::flush() {
+  if (buf_.empty())
+    return;
+  // clear first: a throwing sink must not see the same data twice
+  std::string pending;
+  pending.swap(buf_);
+  buf_.reserve(limit_);
+  emit(pending);
+}
+
+void YangOutput::emit(std::string_view s) {
+  if (cb_) {
+    cb_(s);
+    return;
+  }
+  while (!s.empty()) {
+    ssize_t n = ::write(fd_, s.data(), s.size());
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      throw std::system_error(errno, std::generic_category(),
+                              "YangOutput: write");
+    s.remove_prefix(static_cast<std::size_t>(n));
+  }
+}
+
+YangWriter::YangWriter(const YangContext &ctx, YangOutput &out,
+                       YangFormat format)
+    : ctx_(ctx), out_(out), format_(format) {}
+
+YangWriter::~YangWriter() {
+  if (finished_)
+    return;
+  try {
+    finish();
+  } catch (...) {
+  }
+}
+
+YangWriter::ModuleInfo YangWriter::moduleInfo(std::string_view module) {
+  // a document touches a handful of modules: a linear scan beats hashing
+  for (const auto &m : modules_) {
+    if (m.name == module)
+      return m;
+  }
+  const YangSchemaModule mod = ctx_.GetLoadedModuleByName(module);
+  if (!mod || !mod.ns() || !mod.prefix())
+    throw YangDataError(ctx_);
+  // module strings live in the libyang dictionary as long as the context
+  modules_.push_back({mod.name(), mod.ns(), mod.prefix()});
+  return modules_.back();
+}
+
+std::string_view YangWriter::parentModule() const {
+  for (auto it = stack_.rbegin(); it != stack_.rend(); ++it) {
+    if (it->frame != Frame::List)
+      return it->module;
+  }
+  return {};
+}
+
+void YangWriter::jsonMember(std::string_view module, std::string_view name) {
+  if (stack_.empty()) {
+    out_.put(top_first_ ? '{' : ',');
+    top_first_ = false;
+  } else {
+    if (!stack_.back().first)
+      out_.put(',');
+    stack_.back().first = false;
+  }
+  out_.put('"');
+  if (module != parentModule()) {
+    out_.write(moduleInfo(module).name);
+    out_.put(':');
+  }
+  out_.write(name);
+  out_.write("\":");
+}
+
+void YangWriter::xmlOpen(std::string_view module, std::string_view name) {
+  out_.put('<');
+  out_.write(name);
+  if (module != parentModule()) {
+    out_.write(" xmlns=\"");
+    escaped(moduleInfo(module).ns, true);
+    out_.put('"');
+  }
+  out_.put('>');
+}
+
+void YangWriter::xmlClose(std::string_view name) {
+  out_.write("</");
+  out_.write(name);
+  out_.put('>');
+}
+
+void YangWriter::escaped(std::string_view s, bool attribute) {
+  static constexpr char kHex[] = "0123456789abcdef";
+  std::size_t plain = 0;
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    const unsigned char c = static_cast<unsigned char>(s[i]);
+    std::string_view rep;
+    char uesc[7];
+    if (format_ == YangFormat::Xml) {
+      if (c == '&')
+        rep = "&amp;";
+      else if (c == '<')
+        rep = "&lt;";
+      else if (c == '>')
+        rep = "&gt;";
+      else if (attribute && c == '"')
+        rep = "&quot;";
+    } else {
+      if (c == '"')
+        rep = "\\\"";
+      else if (c == '\\')
+        rep = "\\\\";
+      else if (c == '\n')
+        rep = "\\n";
+      else if (c == '\t')
+        rep = "\\t";
+      else if (c == '\r')
+        rep = "\\r";
+      else if (c < 0x20) {
+        uesc[0] = '\\';
+        uesc[1] = 'u';
+        uesc[2] = '0';
+        uesc[3] = '0';
+        uesc[4] = kHex[c >> 4];
+        uesc[5] = kHex[c & 0xf];
+        rep = std::string_view(uesc, 6);
+      }
+    }
+    if (rep.empty())
+      continue;
+    out_.write(s.substr(plain, i - plain));
+    out_.write(rep);
+    plain = i + 1;
+  }
+  out_.write(s.substr(plain));
+}
+
+void YangWriter::beginContainer(std::string_view module,
+                                std::string_view name) {
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    out_.put('{');
+  } else {
+    xmlOpen(module, name);
+  }
+  stack_.push_back({Frame::Container, moduleInfo(module).name, name});
+}
+
+void YangWriter::endContainer() {
+  if (stack_.empty() || stack_.back().frame != Frame::Container)
+    throw std::logic_error("YangWriter: endContainer() without container");
+  const Level level = stack_.back();
+  stack_.pop_back();
+  if (format_ == YangFormat::Json)
+    out_.put('}');
+  else
+    xmlClose(level.name);
+}
+
+void YangWriter::beginList(std::string_view module, std::string_view name) {
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    out_.put('[');
+  }
+  stack_.push_back({Frame::List, moduleInfo(module).name, name});
+}
+
+void YangWriter::beginEntry() {
+  if (stack_.empty() || stack_.back().frame != Frame::List)
+    throw std::logic_error("YangWriter: beginEntry() outside a list");
+  Level &list = stack_.back();
+  const Level entry{Frame::Entry, list.module, list.name};
+  if (format_ == YangFormat::Json) {
+    if (!list.first)
+      out_.put(',');
+    list.first = false;
+    out_.put('{');
+  } else {
+    xmlOpen(list.module, list.name);
+  }
+  stack_.push_back(entry);
+}
+
+void YangWriter::endEntry() {
+  if (stack_.empty() || stack_.back().frame != Frame::Entry)
+    throw std::logic_error("YangWriter: endEntry() without entry");
+  const Level level = stack_.back();
+  stack_.pop_back();
+  if (format_ == YangFormat::Json)
+    out_.put('}');
+  else
+    xmlClose(level.name);
+}
+
+void YangWriter::endList() {
+  if (stack_.empty() || stack_.back().frame != Frame::List)
+    throw std::logic_error("YangWriter: endList() without list");
+  stack_.pop_back();
+  if (format_ == YangFormat::Json)
+    out_.put(']');
+}
+
+void YangWriter::leaf(std::string_view module, std::string_view name,
+                      std::string_view value) {
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    out_.put('"');
+    escaped(value, false);
+    out_.put('"');
+  } else {
+    xmlOpen(module, name);
+    escaped(value, false);
+    xmlClose(name);
+  }
+}
+
+void YangWriter::leaf(std::string_view module, std::string_view name,
+                      bool value) {
+  number(module, name, value ? "true" : "false", false);
+}
+
+void YangWriter::empty(std::string_view module, std::string_view name) {
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    out_.write("[null]");
+    return;
+  }
+  out_.put('<');
+  out_.write(name);
+  if (module != parentModule()) {
+    out_.write(" xmlns=\"");
+    escaped(moduleInfo(module).ns, true);
+    out_.put('"');
+  }
+  out_.write("/>");
+}
+
+void YangWriter::number(std::string_view module, std::string_view name,
+                        const std::string &digits, bool quoted_in_json) {
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    if (quoted_in_json)
+      out_.put('"');
+    out_.write(digits);
+    if (quoted_in_json)
+      out_.put('"');
+  } else {
+    xmlOpen(module, name);
+    out_.write(digits);
+    xmlClose(name);
+  }
+}
+
+void YangWriter::identity(std::string_view module, std::string_view name,
+                          std::string_view identity,
+                          std::string_view default_module) {
+  std::string_view id_module = default_module;
+  const auto colon = identity.find(':');
+  if (colon != std::string_view::npos) {
+    id_module = identity.substr(0, colon);
+    identity.remove_prefix(colon + 1);
+  }
+  const ModuleInfo id = moduleInfo(id_module);
+
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    out_.put('"');
+    out_.write(id.name);
+    out_.put(':');
+    escaped(identity, false);
+    out_.put('"');
+    return;
+  }
+
+  // <name xmlns:pfx="identity namespace">pfx:identity</name>
+  out_.put('<');
+  out_.write(name);
+  if (module != parentModule()) {
+    out_.write(" xmlns=\"");
+    escaped(moduleInfo(module).ns, true);
+    out_.put('"');
+  }
+  out_.write(" xmlns:");
+  out_.write(id.prefix);
+  out_.write("=\"");
+  escaped(id.ns, true);
+  out_.write("\">");
+  out_.write(id.prefix);
+  out_.put(':');
+  escaped(identity, false);
+  xmlClose(name);
+}
+
+void YangWriter::leafList(std::string_view module, std::string_view name,
+                          std::span<const std::string> values) {
+  if (values.empty())
+    return;
+  if (format_ == YangFormat::Json) {
+    jsonMember(module, name);
+    out_.put('[');
+    bool first = true;
+    for (const auto &v : values) {
+      if (!first)
+        out_.put(',');
+      first = false;
+      out_.put('"');
+      escaped(v, false);
+      out_.put('"');
+    }
+    out_.put(']');
+    return;
+  }
+  for (const auto &v : values)
+    leaf(module, name, std::string_view(v));
+}
+
+void YangWriter::finish() {
+  if (finished_)
+    return;
+  if (!stack_.empty())
+    throw std::logic_error("YangWriter: finish() with open nodes");
+  finished_ = true;
+  if (format_ == YangFormat::Json && !top_first_)
+    out_.put('}');
+  out_.flush();
+}
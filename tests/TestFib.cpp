@@ -0,0 +1,221 @@
+#include "Fib.hpp"
+#include "IetfInetTypes.hpp"
+#include "IetfRouting.hpp"
+#include "RouteStore.hpp"
+#include "Yang.hpp"
+#include "YangContext.hpp"
+#include "YangModel.hpp"
+#include <atf-c++.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace yang;
+
+static Ipv4Address v4(const char *text) { return *Ipv4Address::parse(text); }
+static Ipv6Address v6(const char *text) { return *Ipv6Address::parse(text); }
+
+ATF_TEST_CASE(inet_prefixes);
+ATF_TEST_CASE_HEAD(inet_prefixes) {
+  set_md_var("descr", "binary inet addresses and prefixes");
+}
+ATF_TEST_CASE_BODY(inet_prefixes) {
+  ATF_REQUIRE_EQ(v4("192.0.2.1").toString(), "192.0.2.1");
+  ATF_REQUIRE(v4("192.0.2.1").bytes == (std::array<std::uint8_t, 4>{
+                                           192, 0, 2, 1}));
+  ATF_REQUIRE_EQ(v6("2001:db8:0::1").toString(), "2001:db8::1");
+  ATF_REQUIRE(!Ipv4Address::parse("192.0.2"));
+  ATF_REQUIRE(!Ipv6Address::parse("2001:db8::1%eth0"));
+
+  // host bits are cleared
+  ATF_REQUIRE_EQ(Ipv4Prefix::parse("10.1.2.3/8")->toString(), "10.0.0.0/8");
+  ATF_REQUIRE_EQ(Ipv4Prefix::parse("10.1.2.3/0")->toString(), "0.0.0.0/0");
+  ATF_REQUIRE_EQ(Ipv6Prefix::parse("2001:db8:ffff::/33")->toString(),
+                 "2001:db8:8000::/33");
+  for (const char *bad : {"10.0.0.0", "10.0.0.0/", "10.0.0.0/33",
+                          "10.0.0.0/8x", "10.0.0/8"})
+    ATF_REQUIRE(!Ipv4Prefix::parse(bad));
+  ATF_REQUIRE(!Ipv6Prefix::parse("::/129"));
+}
+
+// The longest prefix containing `a`, by testing every entry.
+template <typename Prefix, typename Address>
+static std::uint32_t slowLookup(const std::vector<Fib::Entry<Prefix>> &es,
+                                const Address &a) {
+  std::uint32_t found = Fib::kNoRoute;
+  int longest = -1;
+  for (const auto &e : es) {
+    bool match = true;
+    for (unsigned bit = 0; bit < e.prefix.length && match; ++bit) {
+      const unsigned mask = 0x80 >> bit % 8;
+      match = (a.bytes[bit / 8] & mask) ==
+              (e.prefix.address.bytes[bit / 8] & mask);
+    }
+    // the last of equal prefixes wins
+    if (match && e.prefix.length >= longest) {
+      longest = e.prefix.length;
+      found = e.value;
+    }
+  }
+  return found;
+}
+
+ATF_TEST_CASE(fib_longest_match);
+ATF_TEST_CASE_HEAD(fib_longest_match) {
+  set_md_var("descr", "Fib lookups agree with a linear longest-prefix scan");
+}
+ATF_TEST_CASE_BODY(fib_longest_match) {
+  // few distinct bytes, so prefixes nest and overlap at every level
+  std::mt19937 rng(8349);
+  std::vector<Fib::Entry<Ipv4Prefix>> ipv4;
+  std::vector<Fib::Entry<Ipv6Prefix>> ipv6;
+  for (std::uint32_t i = 0; i < 400; ++i) {
+    Ipv4Address a;
+    for (auto &b : a.bytes)
+      b = static_cast<std::uint8_t>(rng() % 4);
+    ipv4.push_back(
+        {*Ipv4Prefix::parse(a.toString() + "/" + std::to_string(rng() % 33)),
+         i});
+    Ipv6Address b;
+    for (auto &byte : b.bytes)
+      byte = static_cast<std::uint8_t>(rng() % 3);
+    ipv6.push_back(
+        {*Ipv6Prefix::parse(b.toString() + "/" + std::to_string(rng() % 129)),
+         i});
+  }
+  const Fib fib(ipv4, ipv6);
+
+  std::vector<Ipv4Address> in4(5000);
+  std::vector<Ipv6Address> in6(5000);
+  for (auto &a : in4)
+    for (auto &b : a.bytes)
+      b = static_cast<std::uint8_t>(rng() % 4);
+  for (auto &a : in6)
+    for (auto &b : a.bytes)
+      b = static_cast<std::uint8_t>(rng() % 3);
+  std::vector<std::uint32_t> out4(in4.size()), out6(in6.size());
+  fib.lookup(in4, out4);
+  fib.lookup(in6, out6);
+  for (std::size_t i = 0; i < in4.size(); ++i) {
+    ATF_REQUIRE_EQ(out4[i], slowLookup(ipv4, in4[i]));
+    ATF_REQUIRE_EQ(fib.lookup(in4[i]), out4[i]);
+  }
+  for (std::size_t i = 0; i < in6.size(); ++i) {
+    ATF_REQUIRE_EQ(out6[i], slowLookup(ipv6, in6[i]));
+    ATF_REQUIRE_EQ(fib.lookup(in6[i]), out6[i]);
+  }
+
+  const Fib empty;
+  ATF_REQUIRE_EQ(empty.lookup(v4("192.0.2.1")), Fib::kNoRoute);
+  ATF_REQUIRE_EQ(empty.memoryUsage(), 0u);
+}
+
+ATF_TEST_CASE(fib_from_rib);
+ATF_TEST_CASE_HEAD(fib_from_rib) {
+  set_md_var("descr", "Fib compiled from the routes of a parsed RIB");
+}
+ATF_TEST_CASE_BODY(fib_from_rib) {
+  static const std::string xml = R"(
+    <routing xmlns="urn:ietf:params:xml:ns:yang:ietf-routing"
+             xmlns:v4="urn:ietf:params:xml:ns:yang:ietf-ipv4-unicast-routing"
+             xmlns:v6="urn:ietf:params:xml:ns:yang:ietf-ipv6-unicast-routing">
+      <ribs>
+        <rib>
+          <name>ipv4-master</name>
+          <address-family>v4:ipv4-unicast</address-family>
+          <routes>
+            <route>
+              <v4:destination-prefix>0.0.0.0/0</v4:destination-prefix>
+              <route-preference>1</route-preference>
+              <next-hop>
+                <v4:next-hop-address>192.0.2.254</v4:next-hop-address>
+              </next-hop>
+              <source-protocol>static</source-protocol>
+            </route>
+            <route>
+              <v4:destination-prefix>198.51.100.0/24</v4:destination-prefix>
+              <route-preference>5</route-preference>
+              <next-hop><special-next-hop>blackhole</special-next-hop>
+              </next-hop>
+              <source-protocol>static</source-protocol>
+            </route>
+            <route>
+              <v4:destination-prefix>198.51.100.0/24</v4:destination-prefix>
+              <route-preference>10</route-preference>
+              <next-hop>
+                <v4:next-hop-address>198.51.100.1</v4:next-hop-address>
+              </next-hop>
+              <source-protocol>direct</source-protocol>
+              <active/>
+            </route>
+            <route>
+              <v4:destination-prefix>198.51.100.128/25</v4:destination-prefix>
+              <next-hop>
+                <v4:next-hop-address>198.51.100.129</v4:next-hop-address>
+              </next-hop>
+              <source-protocol>direct</source-protocol>
+            </route>
+          </routes>
+        </rib>
+        <rib>
+          <name>ipv6-master</name>
+          <address-family>v6:ipv6-unicast</address-family>
+          <routes>
+            <route>
+              <v6:destination-prefix>2001:db8::/32</v6:destination-prefix>
+              <next-hop>
+                <v6:next-hop-address>fe80::1</v6:next-hop-address>
+              </next-hop>
+              <source-protocol>static</source-protocol>
+            </route>
+          </routes>
+        </rib>
+      </ribs>
+    </routing>)";
+
+  auto ctx = Yang::getDefaultContext();
+  struct lyd_node *tree = YangModel::parseXml(*ctx, xml);
+  auto model = IetfRouting::deserialize(*ctx, tree);
+  lyd_free_all(tree);
+  const auto &ribs = model->getRouting().ribs;
+  ATF_REQUIRE_EQ(ribs.size(), 2u);
+
+  const auto &routes = ribs[0].routes;
+  ATF_REQUIRE_EQ(routes.size(), 4u);
+  ATF_REQUIRE(std::get<Ipv4Prefix>(routes[3].destination_prefix) ==
+              *Ipv4Prefix::parse("198.51.100.128/25"));
+  ATF_REQUIRE(std::get<Ipv4Address>(routes[0].next_hop->address) ==
+              v4("192.0.2.254"));
+  ATF_REQUIRE(routes[1].next_hop->special_next_hop ==
+              IetfRouting::SpecialNextHop::Blackhole);
+  ATF_REQUIRE(routes[2].metadata->active);
+  ATF_REQUIRE(routes[2].metadata->source_protocol ==
+              YangIdentity("ietf-routing", "direct"));
+
+  const Fib fib4(ribs[0]);
+  ATF_REQUIRE_EQ(fib4.ipv4Routes(), 3u);
+  ATF_REQUIRE_EQ(fib4.ipv6Routes(), 0u);
+  ATF_REQUIRE_EQ(fib4.lookup(v4("203.0.113.1")), 0u);
+  // the active one of the two routes for 198.51.100.0/24, though the
+  // other has the lower preference
+  ATF_REQUIRE_EQ(fib4.lookup(v4("198.51.100.1")), 2u);
+  ATF_REQUIRE_EQ(fib4.lookup(v4("198.51.100.200")), 3u);
+  ATF_REQUIRE_EQ(fib4.lookup(v6("2001:db8::1")), Fib::kNoRoute);
+
+  // the same from packed routes
+  const RouteStore store(routes);
+  const Fib packed(store);
+  for (const char *a : {"203.0.113.1", "198.51.100.1", "198.51.100.200"})
+    ATF_REQUIRE_EQ(packed.lookup(v4(a)), fib4.lookup(v4(a)));
+
+  const Fib fib6(ribs[1]);
+  ATF_REQUIRE_EQ(fib6.lookup(v6("2001:db8:1::1")), 0u);
+  ATF_REQUIRE_EQ(fib6.lookup(v6("2001:db9::1")), Fib::kNoRoute);
+  ATF_REQUIRE_EQ(fib6.lookup(v4("203.0.113.1")), Fib::kNoRoute);
+}
+
+ATF_INIT_TEST_CASES(tcs) {
+  ATF_ADD_TEST_CASE(tcs, inet_prefixes);
+  ATF_ADD_TEST_CASE(tcs, fib_longest_match);
+  ATF_ADD_TEST_CASE(tcs, fib_from_rib);
+}
@@ -1,11 +1,21 @@
 #include "IetfInterfaces.hpp"
+#include "SidMap.hpp"
 #include "Yang.hpp"
 #include "YangContext.hpp"
 #include "YangModel.hpp"
+#include "YangValue.hpp"
+#include <algorithm>
 #include <atf-c++.hpp>
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <libyang/log.h>
 #include <memory>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
 using namespace yang;
 
@@ -138,4 +148,726 @@ ATF_TEST_CASE_BODY(ietf_interfaces_roundtrip) {
   }
 }
 
-ATF_INIT_TEST_CASES(tcs) { ATF_ADD_TEST_CASE(tcs, ietf_interfaces_roundtrip); }
+ATF_TEST_CASE(ietf_interfaces_serialize);
+ATF_TEST_CASE_HEAD(ietf_interfaces_serialize) {
+  set_md_var("descr", "IetfInterfaces serialize -> XML -> deserialize");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_serialize) {
+  auto ctx = Yang::getDefaultContext();
+
+  constexpr int kInterfaces = 2000;
+  IetfInterfaces model;
+  for (int i = 0; i < kInterfaces; ++i) {
+    IetfInterfaces::IetfInterface itf;
+    itf.name = "eth" + std::to_string(i);
+    itf.description = "port " + std::to_string(i);
+    itf.type = yang::IanaIfType::ethernetCsmacd;
+    itf.enabled = (i % 2) == 0;
+    itf.ipv4.emplace();
+    itf.ipv4->mtu = 1500;
+    itf.ipv4->address.push_back({"10.0." + std::to_string(i / 256) + "." +
+                                 std::to_string(i % 256) + "/24"});
+    itf.ipv6.emplace();
+    itf.ipv6->address.push_back({"2001:db8::" + std::to_string(i + 1) +
+                                 "/64"});
+    model.addInterface(itf);
+  }
+
+  struct lyd_node *tree = model.serialize(*ctx);
+  ATF_REQUIRE(tree != nullptr);
+  char *xml = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&xml, tree, LYD_XML, LYD_PRINT_WITHSIBLINGS),
+                 LY_SUCCESS);
+  lyd_free_all(tree);
+
+  tree = YangModel::parseXml(*ctx, xml, LYD_PARSE_ONLY);
+  std::free(xml);
+  auto parsed = IetfInterfaces::deserialize(*ctx, tree);
+  lyd_free_all(tree);
+
+  const auto &out = parsed->getInterfaces();
+  ATF_REQUIRE_EQ(out.size(), static_cast<std::size_t>(kInterfaces));
+  ATF_REQUIRE_EQ(out[7].name, "eth7");
+  ATF_REQUIRE(out[7].description == "port 7");
+  ATF_REQUIRE(out[7].type == yang::IanaIfType::ethernetCsmacd);
+  ATF_REQUIRE(!out[7].enabled);
+  ATF_REQUIRE(out[7].ipv4.has_value());
+  ATF_REQUIRE(out[7].ipv4->mtu == 1500u);
+  ATF_REQUIRE_EQ(out[7].ipv4->address.size(), 1u);
+  ATF_REQUIRE_EQ(out[7].ipv4->address[0].address, "10.0.0.7/24");
+  ATF_REQUIRE(out[7].ipv6.has_value());
+  ATF_REQUIRE_EQ(out[7].ipv6->address[0].address, "2001:db8::8/64");
+}
+
+// Reparse `text` and print it back as shrunk XML so that output from
+// different producers can be compared byte for byte.
+static std::string canonicalXml(const YangContext &ctx, const std::string &text,
+                                LYD_FORMAT format) {
+  struct lyd_node *tree = nullptr;
+  ATF_REQUIRE_EQ(lyd_parse_data_mem(ctx.raw(), text.c_str(), format,
+                                    LYD_PARSE_ONLY, 0, &tree),
+                 LY_SUCCESS);
+  char *out = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&out, tree, LYD_XML,
+                               LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK),
+                 LY_SUCCESS);
+  lyd_free_all(tree);
+  std::string result = out ? out : "";
+  std::free(out);
+  return result;
+}
+
+ATF_TEST_CASE(ietf_interfaces_write);
+ATF_TEST_CASE_HEAD(ietf_interfaces_write) {
+  set_md_var("descr", "IetfInterfaces streamed XML/JSON matches serialize()");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_write) {
+  auto ctx = Yang::getDefaultContext();
+
+  IetfInterfaces model;
+  for (int i = 0; i < 64; ++i) {
+    IetfInterfaces::IetfInterface itf;
+    itf.name = "eth" + std::to_string(i) + (i == 3 ? " <&\"'>" : "");
+    if (i % 3)
+      itf.description = "port " + std::to_string(i);
+    itf.type = i % 4 ? yang::IanaIfType::ethernetCsmacd
+                     : yang::IanaIfType::softwareLoopback;
+    itf.enabled = (i % 2) == 0;
+    if (i % 5) {
+      itf.ipv4.emplace();
+      itf.ipv4->mtu = 1500;
+      itf.ipv4->address.push_back({"192.0.2." + std::to_string(i) + "/24"});
+    }
+    if (i % 7) {
+      itf.ipv6.emplace();
+      itf.ipv6->address.push_back({"2001:db8::" + std::to_string(i + 1) +
+                                   "/64"});
+    }
+    model.addInterface(itf);
+  }
+
+  struct lyd_node *tree = model.serialize(*ctx);
+  char *xml = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&xml, tree, LYD_XML,
+                               LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK),
+                 LY_SUCCESS);
+  lyd_free_all(tree);
+  const std::string expected = xml;
+  std::free(xml);
+
+  std::string streamed;
+  {
+    auto out = YangOutput::toString(streamed);
+    model.print(*ctx, out, YangFormat::Xml);
+  }
+  ATF_REQUIRE_EQ(canonicalXml(*ctx, streamed, LYD_XML), expected);
+
+  streamed.clear();
+  {
+    auto out = YangOutput::toString(streamed);
+    model.print(*ctx, out, YangFormat::Json);
+  }
+  ATF_REQUIRE_EQ(canonicalXml(*ctx, streamed, LYD_JSON), expected);
+
+  // A small buffer forces many flushes through the callback sink.
+  std::string chunked;
+  std::size_t chunks = 0;
+  {
+    auto out = YangOutput::toCallback(
+        [&](std::string_view data) {
+          chunked.append(data);
+          ++chunks;
+        },
+        64);
+    model.print(*ctx, out, YangFormat::Xml);
+  }
+  ATF_REQUIRE(chunks > 1);
+  ATF_REQUIRE_EQ(canonicalXml(*ctx, chunked, LYD_XML), expected);
+}
+
+static bool sameInterface(const IetfInterfaces::IetfInterface &a,
+                          const IetfInterfaces::IetfInterface &b) {
+  auto sameIp = [](const auto &x, const auto &y) {
+    if (x.has_value() != y.has_value())
+      return false;
+    if (!x)
+      return true;
+    if (x->mtu != y->mtu || x->address.size() != y->address.size())
+      return false;
+    for (std::size_t i = 0; i < x->address.size(); ++i)
+      if (x->address[i].address != y->address[i].address)
+        return false;
+    return true;
+  };
+  return a.name == b.name && a.description == b.description &&
+         a.type == b.type && a.enabled == b.enabled &&
+         sameIp(a.ipv4, b.ipv4) && sameIp(a.ipv6, b.ipv6);
+}
+
+ATF_TEST_CASE(ietf_interfaces_read);
+ATF_TEST_CASE_HEAD(ietf_interfaces_read) {
+  set_md_var("descr", "IetfInterfaces streaming read matches deserialize()");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_read) {
+  auto ctx = Yang::getDefaultContext();
+
+  IetfInterfaces model;
+  for (int i = 0; i < 200; ++i) {
+    IetfInterfaces::IetfInterface itf;
+    itf.name = "eth" + std::to_string(i) + (i == 5 ? " <&\"'>" : "");
+    if (i % 3)
+      itf.description = "port " + std::to_string(i);
+    itf.type = i % 4 ? yang::IanaIfType::ethernetCsmacd
+                     : yang::IanaIfType::softwareLoopback;
+    itf.enabled = (i % 2) == 0;
+    if (i % 5) {
+      itf.ipv4.emplace();
+      itf.ipv4->mtu = 1500;
+      itf.ipv4->address.push_back({"192.0.2." + std::to_string(i) + "/24"});
+    }
+    if (i % 7) {
+      itf.ipv6.emplace();
+      itf.ipv6->address.push_back({"2001:db8::" + std::to_string(i + 1) +
+                                   "/64"});
+    }
+    model.addInterface(itf);
+  }
+
+  struct lyd_node *tree = model.serialize(*ctx);
+  const auto expected = IetfInterfaces::deserialize(*ctx, tree);
+  const auto &want = expected->getInterfaces();
+
+  for (LYD_FORMAT format : {LYD_XML, LYD_JSON}) {
+    // libyang's indented output, with prefixes of its own choosing
+    char *text = nullptr;
+    ATF_REQUIRE_EQ(lyd_print_mem(&text, tree, format, LYD_PRINT_WITHSIBLINGS),
+                   LY_SUCCESS);
+    const std::string doc = text;
+    std::free(text);
+
+    // a tiny buffer splits names, entities and escapes across refills
+    std::size_t offset = 0;
+    auto in = YangInput::fromCallback(
+        [&](char *buf, std::size_t len) {
+          len = std::min(len, doc.size() - offset);
+          std::memcpy(buf, doc.data() + offset, len);
+          offset += len;
+          return len;
+        },
+        7);
+    YangReader reader(*ctx, in,
+                      format == LYD_XML ? YangFormat::Xml : YangFormat::Json);
+    std::size_t n = 0;
+    IetfInterfaces::read(reader, [&](IetfInterfaces::IetfInterface &&itf) {
+      ATF_REQUIRE(n < want.size());
+      ATF_REQUIRE(sameInterface(itf, want[n]));
+      ++n;
+    });
+    ATF_REQUIRE_EQ(n, want.size());
+  }
+  lyd_free_all(tree);
+
+  // file descriptor input, written by YangWriter
+  std::FILE *file = std::tmpfile();
+  ATF_REQUIRE(file != nullptr);
+  {
+    auto out = YangOutput::toFd(fileno(file));
+    model.print(*ctx, out, YangFormat::Json);
+  }
+  ATF_REQUIRE_EQ(lseek(fileno(file), 0, SEEK_SET), 0);
+  auto in = YangInput::fromFd(fileno(file), 4096);
+  YangReader reader(*ctx, in, YangFormat::Json);
+  auto parsed = IetfInterfaces::read(reader, true);
+  std::fclose(file);
+  ATF_REQUIRE_EQ(parsed->getInterfaces().size(), want.size());
+  for (std::size_t i = 0; i < want.size(); ++i)
+    ATF_REQUIRE(sameInterface(parsed->getInterfaces()[i], want[i]));
+}
+
+ATF_TEST_CASE(ietf_interfaces_read_errors);
+ATF_TEST_CASE_HEAD(ietf_interfaces_read_errors) {
+  set_md_var("descr", "IetfInterfaces streaming read rejects bad input");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_read_errors) {
+  auto ctx = Yang::getDefaultContext();
+  auto readXml = [&](const std::string &xml, bool validate) {
+    auto in = YangInput::fromString(xml);
+    YangReader reader(*ctx, in, YangFormat::Xml);
+    return IetfInterfaces::read(reader, validate);
+  };
+
+  // mtu is out of range for ietf-ip; only caught when validating
+  const std::string bad_mtu = R"(
+    <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces"
+                xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type">
+      <interface>
+        <name>eth0</name>
+        <type>ianaift:ethernetCsmacd</type>
+        <ipv4 xmlns="urn:ietf:params:xml:ns:yang:ietf-ip">
+          <mtu>10</mtu>
+          <address><ip>192.0.2.1</ip><prefix-length>24</prefix-length></address>
+        </ipv4>
+      </interface>
+    </interfaces>)";
+  ATF_REQUIRE_EQ(readXml(bad_mtu, false)->getInterfaces().size(), 1u);
+  ATF_REQUIRE_THROW(YangDataError, readXml(bad_mtu, true));
+
+  // state leaves and statistics are validated too
+  const std::string bad_state[] = {
+      "<oper-status>sideways</oper-status>",
+      "<if-index>0</if-index>",
+      "<phys-address>not-a-mac</phys-address>",
+      "<last-change>yesterday</last-change>",
+      "<statistics><discontinuity-time>now</discontinuity-time>"
+      "</statistics>",
+  };
+  for (const auto &leaf : bad_state) {
+    const std::string xml =
+        R"(<interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces">)"
+        "<interface><name>eth0</name>" +
+        leaf + "</interface></interfaces>";
+    ATF_REQUIRE_EQ(readXml(xml, false)->getInterfaces().size(), 1u);
+    ATF_REQUIRE_THROW(YangDataError, readXml(xml, true));
+  }
+
+  const std::string open_tag =
+      R"(<interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces">)";
+  // mismatched end tag
+  ATF_REQUIRE_THROW(YangParseError,
+                    readXml(open_tag + "<interface><name>eth0</name>"
+                                       "</interfaces>",
+                            false));
+  // undeclared identity prefix
+  ATF_REQUIRE_THROW(YangParseError,
+                    readXml(open_tag + "<interface><name>eth0</name>"
+                                       "<type>x:y</type></interface>"
+                                       "</interfaces>",
+                            false));
+  // entry without its key
+  ATF_REQUIRE_THROW(YangParseError,
+                    readXml(open_tag + "<interface><description>d"
+                                       "</description></interface>"
+                                       "</interfaces>",
+                            false));
+}
+
+ATF_TEST_CASE(ietf_interfaces_lyb);
+ATF_TEST_CASE_HEAD(ietf_interfaces_lyb) {
+  set_md_var("descr", "IetfInterfaces serialize -> LYB -> deserialize");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_lyb) {
+  auto ctx = Yang::getDefaultContext();
+
+  IetfInterfaces model;
+  for (int i = 0; i < 100; ++i) {
+    IetfInterfaces::IetfInterface itf;
+    itf.name = "eth" + std::to_string(i);
+    itf.description = "port " + std::to_string(i);
+    itf.type = yang::IanaIfType::ethernetCsmacd;
+    itf.enabled = (i % 2) == 0;
+    itf.ipv4.emplace();
+    itf.ipv4->mtu = 9000;
+    itf.ipv4->address.push_back({"192.0.2." + std::to_string(i) + "/24"});
+    model.addInterface(itf);
+  }
+
+  struct lyd_node *tree = model.serialize(*ctx);
+  const std::string lyb = YangModel::printLyb(*ctx, tree);
+  char *xml = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&xml, tree, LYD_XML,
+                               LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK),
+                 LY_SUCCESS);
+  const std::string expected = xml;
+  std::free(xml);
+  lyd_free_all(tree);
+  ATF_REQUIRE(lyb.size() < expected.size());
+
+  tree = YangModel::parseLyb(*ctx, lyb);
+  xml = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&xml, tree, LYD_XML,
+                               LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK),
+                 LY_SUCCESS);
+  ATF_REQUIRE_EQ(std::string(xml), expected);
+  std::free(xml);
+  auto parsed = IetfInterfaces::deserialize(*ctx, tree);
+  lyd_free_all(tree);
+  ATF_REQUIRE_EQ(parsed->getInterfaces().size(), 100u);
+  ATF_REQUIRE(sameInterface(parsed->getInterfaces()[42],
+                            model.getInterfaces()[42]));
+
+  // pooled contexts are clones of the default one, hashes included
+  auto &pool = Yang::getDefaultPool();
+  auto pooled = YangModel::fromLyb<IetfInterfaces>(pool, model.toLyb(pool));
+  ATF_REQUIRE_EQ(pooled->getInterfaces().size(), 100u);
+
+  // a context without schema hashes cannot do LYB
+  YangContext plain(toFlags(YangContextOptions::NoYanglibrary));
+  ATF_REQUIRE_THROW(std::logic_error, YangModel::printLyb(plain, nullptr));
+  ATF_REQUIRE_THROW(std::logic_error, YangModel::parseLyb(plain, lyb));
+}
+
+// SIDs for the nodes IetfInterfaces encodes; numbers are arbitrary but
+// the identities come from a .sid file to cover SidMap::add().
+static SidMap testSids() {
+  SidMap sids;
+  std::uint64_t sid = 1000;
+  sids.addData("/ietf-interfaces:interfaces", sid++);
+  for (const char *node :
+       {"", "/name", "/description", "/type", "/enabled",
+        "/link-up-down-trap-enable", "/admin-status", "/oper-status",
+        "/last-change", "/if-index", "/phys-address", "/higher-layer-if",
+        "/lower-layer-if", "/speed", "/statistics",
+        "/statistics/discontinuity-time", "/statistics/in-octets",
+        "/statistics/in-unicast-pkts", "/statistics/in-broadcast-pkts",
+        "/statistics/in-multicast-pkts", "/statistics/in-discards",
+        "/statistics/in-errors", "/statistics/in-unknown-protos",
+        "/statistics/out-octets", "/statistics/out-unicast-pkts",
+        "/statistics/out-broadcast-pkts", "/statistics/out-multicast-pkts",
+        "/statistics/out-discards", "/statistics/out-errors"})
+    sids.addData(std::string("/ietf-interfaces:interfaces/interface") + node,
+                 sid++);
+  sid = 2000;
+  for (const char *family : {"ipv4", "ipv6"})
+    for (const char *node :
+         {"", "/mtu", "/address", "/address/ip", "/address/prefix-length"})
+      sids.addData(std::string("/ietf-interfaces:interfaces/interface/"
+                               "ietf-ip:") +
+                       family + node,
+                   sid++);
+
+  // softwareLoopback is left out: it is sent by name
+  const std::string sid_file = R"({"ietf-sid-file:sid-file": {
+    "item": [
+      {"namespace": "module", "identifier": "iana-if-type", "sid": "3000"},
+      {"namespace": "identity", "identifier": "ethernetCsmacd",
+       "sid": "3006"}
+    ],
+    "module-name": "iana-if-type"
+  }})";
+  auto in = YangInput::fromString(sid_file);
+  sids.add(in);
+  return sids;
+}
+
+ATF_TEST_CASE(ietf_interfaces_cbor);
+ATF_TEST_CASE_HEAD(ietf_interfaces_cbor) {
+  set_md_var("descr", "IetfInterfaces YANG-CBOR encode/decode");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_cbor) {
+  auto ctx = Yang::getDefaultContext();
+  const SidMap sids = testSids();
+  ATF_REQUIRE(sids.identity("iana-if-type:ethernetCsmacd") == 3006u);
+  ATF_REQUIRE(!sids.identity("iana-if-type:softwareLoopback"));
+
+  // {1000: {1: [{1: "lo"}]}}, keys as deltas from the parent's SID
+  {
+    IetfInterfaces one;
+    IetfInterfaces::IetfInterface lo;
+    lo.name = "lo";
+    one.addInterface(lo);
+    std::string cbor;
+    auto out = YangOutput::toString(cbor);
+    one.writeCbor(sids, out);
+    ATF_REQUIRE_EQ(cbor, std::string("\xa1\x19\x03\xe8\xa1\x01\x81\xa1\x01"
+                                     "\x62lo"));
+  }
+
+  IetfInterfaces model;
+  for (int i = 0; i < 100; ++i) {
+    IetfInterfaces::IetfInterface itf;
+    itf.name = "eth" + std::to_string(i);
+    itf.description = "port " + std::to_string(i);
+    itf.type = i % 10 ? yang::IanaIfType::ethernetCsmacd
+                      : yang::IanaIfType::softwareLoopback;
+    itf.enabled = (i % 2) == 0;
+    itf.ipv4.emplace();
+    itf.ipv4->mtu = 9000;
+    itf.ipv4->address.push_back({"192.0.2." + std::to_string(i) + "/24"});
+    if (i % 3 == 0) {
+      itf.ipv6.emplace();
+      itf.ipv6->address.push_back({"2001:db8::" + std::to_string(i + 1) +
+                                   "/64"});
+    }
+    if (i == 7) {
+      itf.admin_status = "testing";
+      itf.oper_status = "lower-layer-down";
+      itf.link_up_down_trap_enable =
+          IetfInterfaces::IetfInterface::LinkUpDownTrap::Disabled;
+      itf.if_index = 7;
+      itf.speed = 10000000000u;
+      itf.lower_layer_if = {"eth8", "eth9"};
+      itf.statistics.emplace();
+      itf.statistics->discontinuity_time = "2026-01-01T00:00:00Z";
+      itf.statistics->in_octets = 1ull << 40;
+      itf.statistics->out_errors = 3;
+    }
+    model.addInterface(itf);
+  }
+  const auto &eth7 = model.getInterfaces()[7];
+
+  std::string cbor;
+  {
+    auto out = YangOutput::toString(cbor);
+    model.writeCbor(sids, out);
+  }
+  std::string xml;
+  {
+    auto out = YangOutput::toString(xml);
+    model.print(*ctx, out, YangFormat::Xml);
+  }
+  ATF_REQUIRE(cbor.size() * 3 < xml.size());
+
+  auto in = YangInput::fromString(cbor);
+  auto parsed = IetfInterfaces::readCbor(sids, in);
+  ATF_REQUIRE_EQ(parsed->getInterfaces().size(), 100u);
+  for (std::size_t i = 0; i < 100; ++i)
+    ATF_REQUIRE(sameInterface(parsed->getInterfaces()[i],
+                              model.getInterfaces()[i]));
+  const auto &got = parsed->getInterfaces()[7];
+  ATF_REQUIRE(got.admin_status == "testing");
+  ATF_REQUIRE(got.oper_status == "lower-layer-down");
+  ATF_REQUIRE(got.link_up_down_trap_enable == eth7.link_up_down_trap_enable);
+  ATF_REQUIRE(got.if_index == 7);
+  ATF_REQUIRE(got.speed == eth7.speed);
+  ATF_REQUIRE(got.lower_layer_if == eth7.lower_layer_if);
+  ATF_REQUIRE(got.statistics.has_value());
+  ATF_REQUIRE(got.statistics->discontinuity_time ==
+              eth7.statistics->discontinuity_time);
+  ATF_REQUIRE(got.statistics->in_octets == 1ull << 40);
+  ATF_REQUIRE(got.statistics->out_errors == 3u);
+  ATF_REQUIRE(!got.statistics->in_errors.has_value());
+
+  // members this map has no SID for are skipped when decoding...
+  SidMap no_ipv6 = testSids();
+  no_ipv6.addData("/ietf-interfaces:interfaces/interface/ietf-ip:ipv6",
+                  9999);
+  auto in2 = YangInput::fromString(cbor);
+  auto partial = IetfInterfaces::readCbor(no_ipv6, in2);
+  ATF_REQUIRE_EQ(partial->getInterfaces().size(), 100u);
+  ATF_REQUIRE(!partial->getInterfaces()[0].ipv6.has_value());
+  ATF_REQUIRE(partial->getInterfaces()[0].ipv4.has_value());
+
+  // ...but encoding a value without a SID is an error
+  std::string sink;
+  auto out = YangOutput::toString(sink);
+  ATF_REQUIRE_THROW(std::invalid_argument, model.writeCbor(SidMap(), out));
+
+  std::string truncated = cbor.substr(0, cbor.size() / 2);
+  auto in3 = YangInput::fromString(truncated);
+  ATF_REQUIRE_THROW(YangParseError, IetfInterfaces::readCbor(sids, in3));
+
+  // an unknown member nested 100000 arrays deep fails instead of
+  // overflowing the stack while it is skipped
+  std::string deep = "\xa1\x19\x27\x0f" + std::string(100000, '\x81') + '\0';
+  auto in4 = YangInput::fromString(deep);
+  ATF_REQUIRE_THROW(YangParseError, IetfInterfaces::readCbor(sids, in4));
+}
+
+ATF_TEST_CASE(ietf_interfaces_typed_values);
+ATF_TEST_CASE_HEAD(ietf_interfaces_typed_values) {
+  set_md_var("descr", "YangValue reads stored values without strings");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_typed_values) {
+  auto ctx = Yang::getDefaultContext();
+  const std::string xml = R"(
+    <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces"
+                xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type">
+      <interface>
+        <name>eth0</name>
+        <type>ianaift:ethernetCsmacd</type>
+        <enabled>false</enabled>
+        <ipv4 xmlns="urn:ietf:params:xml:ns:yang:ietf-ip">
+          <mtu>9000</mtu>
+        </ipv4>
+      </interface>
+    </interfaces>)";
+  struct lyd_node *tree = YangModel::parseXml(*ctx, xml);
+  auto find = [&](const char *path) {
+    struct lyd_node *n = nullptr;
+    ATF_REQUIRE_EQ(lyd_find_path(tree, path, 0, &n), LY_SUCCESS);
+    return n;
+  };
+  const std::string itf = "/ietf-interfaces:interfaces/interface[name='eth0']";
+
+  YangValue mtu(find((itf + "/ietf-ip:ipv4/mtu").c_str()));
+  ATF_REQUIRE_EQ(mtu.type(), LY_TYPE_UINT16);
+  ATF_REQUIRE_EQ(mtu.as<uint32_t>(), 9000u);
+  ATF_REQUIRE_EQ(mtu.as<int64_t>(), 9000);
+  ATF_REQUIRE_EQ(mtu.canonical(), "9000");
+  ATF_REQUIRE_THROW(std::invalid_argument, mtu.as<uint8_t>());
+  ATF_REQUIRE_THROW(std::invalid_argument, mtu.asBool());
+
+  YangValue enabled(find((itf + "/enabled").c_str()));
+  ATF_REQUIRE(!enabled.asBool());
+
+  YangValue type(find((itf + "/type").c_str()));
+  ATF_REQUIRE_EQ(type.identityName(), "ethernetCsmacd");
+  ATF_REQUIRE_EQ(type.qualifiedIdentity(), "iana-if-type:ethernetCsmacd");
+  ATF_REQUIRE_THROW(std::invalid_argument, type.enumName());
+
+  // containers have no value
+  ATF_REQUIRE_THROW(std::invalid_argument, YangValue{tree});
+  lyd_free_all(tree);
+}
+
+ATF_TEST_CASE(ietf_interfaces_statistics);
+ATF_TEST_CASE_HEAD(ietf_interfaces_statistics) {
+  set_md_var("descr", "IetfInterfaces statistics counters and polling");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_statistics) {
+  auto ctx = Yang::getDefaultContext();
+  const std::string xml = R"(
+    <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces"
+                xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type">
+      <interface>
+        <name>eth0</name>
+        <type>ianaift:ethernetCsmacd</type>
+        <statistics>
+          <discontinuity-time>2026-01-01T00:00:00+00:00</discontinuity-time>
+          <in-octets>18446744073709551615</in-octets>
+          <in-unicast-pkts>1</in-unicast-pkts>
+          <in-broadcast-pkts>2</in-broadcast-pkts>
+          <in-multicast-pkts>3</in-multicast-pkts>
+          <in-discards>4</in-discards>
+          <in-errors>5</in-errors>
+          <in-unknown-protos>6</in-unknown-protos>
+          <out-octets>7</out-octets>
+          <out-unicast-pkts>8</out-unicast-pkts>
+          <out-broadcast-pkts>9</out-broadcast-pkts>
+          <out-multicast-pkts>10</out-multicast-pkts>
+          <out-discards>11</out-discards>
+          <out-errors>4294967295</out-errors>
+        </statistics>
+      </interface>
+      <interface>
+        <name>eth1</name>
+        <type>ianaift:ethernetCsmacd</type>
+      </interface>
+      <interface>
+        <name>eth2</name>
+        <type>ianaift:ethernetCsmacd</type>
+        <statistics>
+          <discontinuity-time>2026-01-01T00:00:00Z</discontinuity-time>
+          <out-octets>42</out-octets>
+        </statistics>
+      </interface>
+    </interfaces>)";
+
+  auto check = [](const IetfInterfaces::IetfInterfaceStatistics &s) {
+    ATF_REQUIRE(s.discontinuity_time == "2026-01-01T00:00:00Z");
+    ATF_REQUIRE(s.in_octets == 18446744073709551615ull);
+    ATF_REQUIRE(s.in_unicast_pkts == 1u && s.in_broadcast_pkts == 2u &&
+                s.in_multicast_pkts == 3u && s.in_discards == 4u &&
+                s.in_errors == 5u && s.in_unknown_protos == 6u);
+    ATF_REQUIRE(s.out_octets == 7u && s.out_unicast_pkts == 8u &&
+                s.out_broadcast_pkts == 9u && s.out_multicast_pkts == 10u &&
+                s.out_discards == 11u);
+    ATF_REQUIRE(s.out_errors == 4294967295u);
+  };
+
+  struct lyd_node *tree = YangModel::parseXml(*ctx, xml);
+  auto model = IetfInterfaces::deserialize(*ctx, tree);
+  const auto &ifs = model->getInterfaces();
+  ATF_REQUIRE_EQ(ifs.size(), 3u);
+  ATF_REQUIRE(ifs[0].statistics.has_value());
+  check(*ifs[0].statistics);
+  ATF_REQUIRE(!ifs[1].statistics.has_value());
+  ATF_REQUIRE(ifs[2].statistics->out_octets == 42u);
+  ATF_REQUIRE(!ifs[2].statistics->in_octets.has_value());
+
+  // stats-only pass: entries without statistics are left out
+  std::vector<std::string> names;
+  IetfInterfaces::deserializeStatistics(
+      *ctx, tree,
+      [&](const std::string &name,
+          IetfInterfaces::IetfInterfaceStatistics &&stats) {
+        if (names.empty())
+          check(stats);
+        names.push_back(name);
+      });
+  ATF_REQUIRE(names == (std::vector<std::string>{"eth0", "eth2"}));
+  lyd_free_all(tree);
+
+  // the streaming reader fills the same counters
+  auto in = YangInput::fromString(xml);
+  YangReader reader(*ctx, in, YangFormat::Xml);
+  auto streamed = IetfInterfaces::read(reader);
+  ATF_REQUIRE_EQ(streamed->getInterfaces().size(), 3u);
+  check(*streamed->getInterfaces()[0].statistics);
+}
+
+ATF_TEST_CASE(iana_if_type_names);
+ATF_TEST_CASE_HEAD(iana_if_type_names) {
+  set_md_var("descr", "IanaIfType name table and perfect-hash lookup");
+}
+ATF_TEST_CASE_BODY(iana_if_type_names) {
+  static_assert(ianaIfTypeFromString("ethernetCsmacd") ==
+                IanaIfType::ethernetCsmacd);
+  static_assert(ianaIfTypeToString(IanaIfType::if_gsn) == "if-gsn");
+
+  const std::size_t n = std::size(detail::kIanaIfTypeNames);
+  ATF_REQUIRE(n > 250);
+  for (std::size_t i = 1; i <= n; ++i) {
+    const auto t = static_cast<IanaIfType>(i);
+    const std::string_view name = ianaIfTypeToString(t);
+    ATF_REQUIRE(ianaIfTypeFromString(name) == t);
+    ATF_REQUIRE(ianaIfTypeFromString("iana-if-type:" + std::string(name)) ==
+                t);
+    ATF_REQUIRE(ianaIfTypeFromString("ianaift:" + std::string(name)) == t);
+  }
+  ATF_REQUIRE_EQ(ianaIfTypeToString(IanaIfType::Unknown), "unknown");
+  ATF_REQUIRE(ianaIfTypeFromString("") == IanaIfType::Unknown);
+  ATF_REQUIRE(ianaIfTypeFromString("EthernetCsmacd") == IanaIfType::Unknown);
+  ATF_REQUIRE(ianaIfTypeFromString("ethernetCsmacd2") == IanaIfType::Unknown);
+}
+
+ATF_TEST_CASE(ietf_interfaces_parallel);
+ATF_TEST_CASE_HEAD(ietf_interfaces_parallel) {
+  set_md_var("descr", "IetfInterfaces parse/serialize on pooled contexts");
+}
+ATF_TEST_CASE_BODY(ietf_interfaces_parallel) {
+  const std::string xml = R"(<?xml version="1.0"?>
+    <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces"
+                xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type">
+        <interface>
+            <name>eth0</name>
+            <type>ianaift:ethernetCsmacd</type>
+            <enabled>true</enabled>
+        </interface>
+    </interfaces>)";
+
+  auto &pool = Yang::getDefaultPool();
+  std::vector<std::thread> threads;
+  std::atomic<int> ok{0};
+  for (int i = 0; i < 4; ++i)
+    threads.emplace_back([&] {
+      for (int j = 0; j < 8; ++j) {
+        try {
+          auto parsed = YangModel::fromXml<IetfInterfaces>(pool, xml);
+          if (parsed && parsed->getInterfaces().size() == 1 &&
+              parsed->getInterfaces()[0].name == "eth0" &&
+              parsed->toXml(pool).find("eth0") != std::string::npos)
+            ++ok;
+        } catch (const std::exception &e) {
+          std::fprintf(stderr, "parallel parse failed: %s\n", e.what());
+        }
+      }
+    });
+  for (auto &t : threads)
+    t.join();
+  ATF_REQUIRE_EQ(ok.load(), 32);
+}
+
+ATF_INIT_TEST_CASES(tcs) {
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_roundtrip);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_serialize);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_write);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_read);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_read_errors);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_lyb);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_cbor);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_typed_values);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_statistics);
+  ATF_ADD_TEST_CASE(tcs, iana_if_type_names);
+  ATF_ADD_TEST_CASE(tcs, ietf_interfaces_parallel);
+}
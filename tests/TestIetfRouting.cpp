@@ -1,14 +1,109 @@
 #include "IetfRouting.hpp"
+#include "NextHopGroupTable.hpp"
+#include "RibTransaction.hpp"
+#include "RouteStore.hpp"
+#include "SidMap.hpp"
 #include "Yang.hpp"
 #include "YangContext.hpp"
+#include "YangIdentity.hpp"
 #include "YangModel.hpp"
 #include <atf-c++.hpp>
 #include <cstdio>
+#include <cstdlib>
 #include <libyang/log.h>
 #include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 
 using namespace yang;
 
+// Well-formed XML `data` document that contains both the
+// `ietf-routing:routing` instance and the `ietf-interfaces:interfaces`
+// target of the leafref so libyang validation succeeds.
+static const std::string kRoutingXml = R"(<?xml version="1.0"?>
+  <routing xmlns="urn:ietf:params:xml:ns:yang:ietf-routing"
+           xmlns:if="urn:ietf:params:xml:ns:yang:ietf-interfaces">
+
+    <control-plane-protocols>
+      <control-plane-protocol>
+        <type>static</type>
+        <name>static0</name>
+        <description>static routes for testing</description>         
+      </control-plane-protocol>
+      <control-plane-protocol>
+        <type>static</type>
+        <name>static1</name>
+      </control-plane-protocol>
+    </control-plane-protocols>
+
+    <ribs>
+      <rib>
+        <name>main</name>
+        <address-family>ipv4</address-family>
+        <routes>
+          <route>
+            <route-preference>20</route-preference>
+            <source-protocol>static</source-protocol>
+            <next-hop>
+              <outgoing-interface>eth0</outgoing-interface>
+            </next-hop>
+          </route>
+        </routes>
+      </rib>
+    </ribs>      
+  </routing>
+
+  <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces" 
+              xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type" 
+              xmlns:ip="urn:ietf:params:xml:ns:yang:ietf-ip">
+      <interface>
+          <name>eth0</name>
+          <description>uplink</description>
+          <type>ianaift:ethernetCsmacd</type>
+          <enabled>true</enabled>
+          <oper-status>up</oper-status>
+          <statistics>
+              <discontinuity-time>2026-01-01T00:00:00Z</discontinuity-time>
+          </statistics>
+          <ip:ipv4>
+                  <ip:mtu>1500</ip:mtu>
+                  <ip:address>
+                      <ip:ip>192.0.2.1</ip:ip>
+                      <ip:prefix-length>24</ip:prefix-length>
+                  </ip:address>
+                  <ip:address>
+                      <ip:ip>198.51.100.5</ip:ip>
+                      <ip:prefix-length>24</ip:prefix-length>
+                  </ip:address>
+          </ip:ipv4>
+          <ip:ipv6>
+              <ip:address>
+                  <ip:ip>2001:db8::1</ip:ip>
+                  <ip:prefix-length>64</ip:prefix-length>
+              </ip:address>
+          </ip:ipv6>
+          <!-- interface-level mtu moved to per-address in test -->
+      </interface>
+      <interface>
+          <name>lo</name>
+          <description>loopback</description>
+          <enabled>false</enabled>
+          <type>ianaift:softwareLoopback</type>
+          <oper-status>down</oper-status>
+          <statistics>
+              <discontinuity-time>2026-01-01T00:00:00Z</discontinuity-time>
+          </statistics>
+          <ip:ipv4>
+              <ip:mtu>65535</ip:mtu>
+              <ip:address>
+                      <ip:ip>127.0.0.1</ip:ip>
+                      <ip:prefix-length>8</ip:prefix-length>
+                  </ip:address>
+          </ip:ipv4>
+      </interface>
+  </interfaces>)";
+
 ATF_TEST_CASE(ietf_routing_roundtrip);
 ATF_TEST_CASE_HEAD(ietf_routing_roundtrip) {
   set_md_var("descr", "IetfRouting serialize/deserialize roundtrip");
@@ -27,94 +122,9 @@ ATF_TEST_CASE_BODY(ietf_routing_roundtrip) {
     (void)ly_log_options(LY_LOLOG | LY_LOSTORE);
 
     auto ctx = Yang::getDefaultContext();
-    // Build a well-formed XML `data` document that contains both the
-    // `ietf-routing:routing` instance and the `ietf-interfaces:interfaces`
-    // target of the leafref so libyang validation succeeds.
-    const std::string xml = R"(<?xml version="1.0"?>
-    <routing xmlns="urn:ietf:params:xml:ns:yang:ietf-routing"
-             xmlns:if="urn:ietf:params:xml:ns:yang:ietf-interfaces">
-
-      <control-plane-protocols>
-        <control-plane-protocol>
-          <type>static</type>
-          <name>static0</name>
-          <description>static routes for testing</description>         
-        </control-plane-protocol>
-        <control-plane-protocol>
-          <type>static</type>
-          <name>static1</name>
-        </control-plane-protocol>
-      </control-plane-protocols>
-
-      <ribs>
-        <rib>
-          <name>main</name>
-          <address-family>ipv4</address-family>
-          <routes>
-            <route>
-              <route-preference>20</route-preference>
-              <source-protocol>static</source-protocol>
-              <next-hop>
-                <outgoing-interface>eth0</outgoing-interface>
-              </next-hop>
-            </route>
-          </routes>
-        </rib>
-      </ribs>      
-    </routing>
-
-    <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces" 
-                xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type" 
-                xmlns:ip="urn:ietf:params:xml:ns:yang:ietf-ip">
-        <interface>
-            <name>eth0</name>
-            <description>uplink</description>
-            <type>ianaift:ethernetCsmacd</type>
-            <enabled>true</enabled>
-            <oper-status>up</oper-status>
-            <statistics>
-                <discontinuity-time>2026-01-01T00:00:00Z</discontinuity-time>
-            </statistics>
-            <ip:ipv4>
-                    <ip:mtu>1500</ip:mtu>
-                    <ip:address>
-                        <ip:ip>192.0.2.1</ip:ip>
-                        <ip:prefix-length>24</ip:prefix-length>
-                    </ip:address>
-                    <ip:address>
-                        <ip:ip>198.51.100.5</ip:ip>
-                        <ip:prefix-length>24</ip:prefix-length>
-                    </ip:address>
-            </ip:ipv4>
-            <ip:ipv6>
-                <ip:address>
-                    <ip:ip>2001:db8::1</ip:ip>
-                    <ip:prefix-length>64</ip:prefix-length>
-                </ip:address>
-            </ip:ipv6>
-            <!-- interface-level mtu moved to per-address in test -->
-        </interface>
-        <interface>
-            <name>lo</name>
-            <description>loopback</description>
-            <enabled>false</enabled>
-            <type>ianaift:softwareLoopback</type>
-            <oper-status>down</oper-status>
-            <statistics>
-                <discontinuity-time>2026-01-01T00:00:00Z</discontinuity-time>
-            </statistics>
-            <ip:ipv4>
-                <ip:mtu>65535</ip:mtu>
-                <ip:address>
-                        <ip:ip>127.0.0.1</ip:ip>
-                        <ip:prefix-length>8</ip:prefix-length>
-                    </ip:address>
-            </ip:ipv4>
-        </interface>
-    </interfaces>)";
 
     struct lyd_node *tree = nullptr;
-    tree = YangModel::parseXml(*ctx, xml);
+    tree = YangModel::parseXml(*ctx, kRoutingXml);
     ATF_REQUIRE(tree != nullptr);
 
     auto parsed = IetfRouting::deserialize(*ctx, tree);
@@ -158,7 +168,7 @@ ATF_TEST_CASE_BODY(ietf_routing_roundtrip) {
     ATF_REQUIRE(out.ribs.size() == 1);
     const auto &rib = out.ribs[0];
     ATF_REQUIRE(rib.name == std::string("main"));
-    ATF_REQUIRE(rib.address_family == std::string("ipv4"));
+    ATF_REQUIRE(rib.address_family == YangIdentity("ietf-routing", "ipv4"));
     ATF_REQUIRE(rib.routes.size() == 1);
     ATF_REQUIRE(rib.routes[0].route_preference.has_value());
     ATF_REQUIRE(*rib.routes[0].route_preference == 20u);
@@ -171,4 +181,532 @@ ATF_TEST_CASE_BODY(ietf_routing_roundtrip) {
   }
 }
 
-ATF_INIT_TEST_CASES(tcs) { ATF_ADD_TEST_CASE(tcs, ietf_routing_roundtrip); }
+// Shrunk XML of `tree` and its siblings, to compare trees.
+static std::string printXml(struct lyd_node *tree) {
+  char *out = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&out, tree, LYD_XML,
+                               LYD_PRINT_WITHSIBLINGS | LYD_PRINT_SHRINK),
+                 LY_SUCCESS);
+  std::string xml = out ? out : "";
+  std::free(out);
+  return xml;
+}
+
+ATF_TEST_CASE(ietf_routing_lyb);
+ATF_TEST_CASE_HEAD(ietf_routing_lyb) {
+  set_md_var("descr", "IetfRouting XML -> LYB -> tree roundtrip");
+}
+ATF_TEST_CASE_BODY(ietf_routing_lyb) {
+  auto ctx = Yang::getDefaultContext();
+  ATF_REQUIRE(ly_ctx_get_options(ctx->raw()) & LY_CTX_LYB_HASHES);
+
+  struct lyd_node *tree = YangModel::parseXml(*ctx, kRoutingXml);
+  const std::string lyb = YangModel::printLyb(*ctx, tree);
+  ATF_REQUIRE(!lyb.empty());
+  ATF_REQUIRE(lyb.size() < kRoutingXml.size());
+
+  struct lyd_node *copy = YangModel::parseLyb(*ctx, lyb);
+  ATF_REQUIRE_EQ(printXml(copy), printXml(tree));
+
+  auto parsed = IetfRouting::deserialize(*ctx, copy);
+  const auto &out = parsed->getRouting();
+  ATF_REQUIRE_EQ(out.control_plane_protocols.size(), 2u);
+  ATF_REQUIRE_EQ(out.ribs.size(), 1u);
+  ATF_REQUIRE_EQ(out.ribs[0].routes.size(), 1u);
+  ATF_REQUIRE(*out.ribs[0].routes[0].route_preference == 20u);
+  ATF_REQUIRE_EQ(parsed->getInterfacesInfo().size(), 2u);
+
+  lyd_free_all(copy);
+  lyd_free_all(tree);
+}
+
+// SIDs of every node IetfRouting encodes, as a .sid file would list them:
+// augmented nodes are qualified with their module.
+static SidMap routingSids() {
+  SidMap sids;
+  std::uint64_t sid = 1100;
+  sids.addData("/ietf-routing:routing", sid++);
+  for (const char *node :
+       {"/router-id", "/interfaces", "/interfaces/interface",
+        "/control-plane-protocols",
+        "/control-plane-protocols/control-plane-protocol",
+        "/control-plane-protocols/control-plane-protocol/type",
+        "/control-plane-protocols/control-plane-protocol/name",
+        "/control-plane-protocols/control-plane-protocol/description",
+        "/ribs", "/ribs/rib", "/ribs/rib/name", "/ribs/rib/address-family",
+        "/ribs/rib/description", "/ribs/rib/routes", "/ribs/rib/routes/route",
+        "/ribs/rib/routes/route/route-preference"})
+    sids.addData(std::string("/ietf-routing:routing") + node, sid++);
+  const std::string route = "/ietf-routing:routing/ribs/rib/routes/route";
+  for (const char *node :
+       {"/ietf-ipv4-unicast-routing:destination-prefix",
+        "/ietf-ipv6-unicast-routing:destination-prefix", "/next-hop",
+        "/next-hop/outgoing-interface",
+        "/next-hop/ietf-ipv4-unicast-routing:next-hop-address",
+        "/next-hop/ietf-ipv6-unicast-routing:next-hop-address",
+        "/next-hop/special-next-hop", "/next-hop/next-hop-list",
+        "/next-hop/next-hop-list/next-hop",
+        "/next-hop/next-hop-list/next-hop/outgoing-interface",
+        "/source-protocol", "/active", "/last-updated"})
+    sids.addData(route + node, sid++);
+  // "static" and "ipv6" have no SID and go by name
+  sids.addIdentity("ietf-routing:ipv4", 1200);
+  return sids;
+}
+
+ATF_TEST_CASE(ietf_routing_cbor);
+ATF_TEST_CASE_HEAD(ietf_routing_cbor) {
+  set_md_var("descr", "IetfRouting YANG-CBOR encode/decode");
+}
+ATF_TEST_CASE_BODY(ietf_routing_cbor) {
+  auto ctx = Yang::getDefaultContext();
+  const SidMap sids = routingSids();
+
+  struct lyd_node *tree = YangModel::parseXml(*ctx, kRoutingXml);
+  auto model = IetfRouting::deserialize(*ctx, tree);
+  lyd_free_all(tree);
+  model->mutableRouting().router_id = "192.0.2.1";
+
+  std::string cbor;
+  {
+    auto out = YangOutput::toString(cbor);
+    model->writeCbor(sids, out);
+  }
+  ATF_REQUIRE(cbor.size() < kRoutingXml.size() / 4);
+
+  auto in = YangInput::fromString(cbor);
+  auto parsed = IetfRouting::readCbor(sids, in);
+  const auto &want = model->getRouting();
+  const auto &got = parsed->getRouting();
+  ATF_REQUIRE(got.router_id == want.router_id);
+  ATF_REQUIRE(got.interfaces == want.interfaces);
+  ATF_REQUIRE_EQ(got.control_plane_protocols.size(), 2u);
+  for (std::size_t i = 0; i < 2; ++i) {
+    const auto &a = got.control_plane_protocols[i];
+    const auto &b = want.control_plane_protocols[i];
+    ATF_REQUIRE(a.type == b.type && a.name == b.name &&
+                a.description == b.description);
+  }
+  ATF_REQUIRE_EQ(got.ribs.size(), 1u);
+  ATF_REQUIRE_EQ(got.ribs[0].name, "main");
+  ATF_REQUIRE(got.ribs[0].address_family ==
+              YangIdentity("ietf-routing", "ipv4"));
+  ATF_REQUIRE_EQ(got.ribs[0].routes.size(), 1u);
+  ATF_REQUIRE(got.ribs[0].routes[0].route_preference == 20u);
+  // not part of the routing subtree
+  ATF_REQUIRE(parsed->getInterfacesInfo().empty());
+}
+
+ATF_TEST_CASE(ietf_routing_identities);
+ATF_TEST_CASE_HEAD(ietf_routing_identities) {
+  set_md_var("descr", "identityref fields resolve to YangIdentity handles");
+}
+ATF_TEST_CASE_BODY(ietf_routing_identities) {
+  auto ctx = Yang::getDefaultContext();
+  const YangIdentity ipv4("ietf-routing", "ipv4");
+  const YangIdentity ipv6("ietf-routing", "ipv6");
+  const YangIdentity stat("ietf-routing", "static");
+  const YangIdentity family("ietf-routing", "address-family");
+  const YangIdentity protocol("ietf-routing", "control-plane-protocol");
+
+  ATF_REQUIRE(!YangIdentity());
+  ATF_REQUIRE(YangIdentity::parse("ipv4", "ietf-routing") == ipv4);
+  ATF_REQUIRE(YangIdentity::parse("ietf-routing:ipv4", "x") == ipv4);
+  ATF_REQUIRE(ipv4 != ipv6);
+  ATF_REQUIRE_EQ(ipv4.module(), "ietf-routing");
+  ATF_REQUIRE_EQ(ipv4.name(), "ipv4");
+  ATF_REQUIRE_EQ(ipv4.qualified(), "ietf-routing:ipv4");
+
+  ATF_REQUIRE(ipv4.derivedFrom(*ctx, family));
+  ATF_REQUIRE(ipv4.derivedFrom(*ctx, ipv4));
+  ATF_REQUIRE(!ipv4.derivedFrom(*ctx, ipv6));
+  ATF_REQUIRE(!ipv4.derivedFrom(*ctx, protocol));
+  ATF_REQUIRE(stat.derivedFrom(*ctx, protocol));
+  ATF_REQUIRE(!YangIdentity("no-such-module", "x").derivedFrom(*ctx, family));
+
+  const auto table = ctx->schemaCache<YangIdentityTable>();
+  const struct lysc_ident *ident = table->find(ipv4);
+  ATF_REQUIRE(ident != nullptr);
+  ATF_REQUIRE_EQ(std::string(ident->name), "ipv4");
+  ATF_REQUIRE((*table)[ident] == ipv4);
+
+  // the prefix of an XML QName is resolved, not stripped
+  static const std::string xml = R"(
+    <routing xmlns="urn:ietf:params:xml:ns:yang:ietf-routing"
+             xmlns:r="urn:ietf:params:xml:ns:yang:ietf-routing">
+      <control-plane-protocols>
+        <control-plane-protocol>
+          <type>r:static</type>
+          <name>s</name>
+        </control-plane-protocol>
+      </control-plane-protocols>
+      <ribs>
+        <rib><name>a</name><address-family>r:ipv6</address-family></rib>
+        <rib><name>b</name><address-family>ipv4</address-family></rib>
+      </ribs>
+    </routing>)";
+  struct lyd_node *tree = YangModel::parseXml(*ctx, xml);
+  auto model = IetfRouting::deserialize(*ctx, tree);
+  lyd_free_all(tree);
+  const auto &rt = model->getRouting();
+  ATF_REQUIRE_EQ(rt.control_plane_protocols.size(), 1u);
+  ATF_REQUIRE(rt.control_plane_protocols[0].type == stat);
+  ATF_REQUIRE_EQ(rt.ribs.size(), 2u);
+  ATF_REQUIRE(rt.ribs[0].address_family == ipv6);
+  ATF_REQUIRE(rt.ribs[1].address_family == ipv4);
+
+  // and written back qualified
+  tree = model->serialize(*ctx);
+  auto again = IetfRouting::deserialize(*ctx, tree);
+  lyd_free_all(tree);
+  ATF_REQUIRE(again->getRouting().ribs[0].address_family == ipv6);
+  ATF_REQUIRE(again->getRouting().control_plane_protocols[0].type == stat);
+}
+
+// Routes with every field set, over both families and all three cases of
+// the next-hop choice.
+static IetfRouting makeRoutes() {
+  using Route = IetfRouting::Route;
+  const YangIdentity stat("ietf-routing", "static");
+  IetfRouting model;
+  auto &ribs = model.mutableRouting().ribs;
+
+  IetfRouting::Rib v4;
+  v4.name = "ipv4-main";
+  v4.address_family = YangIdentity("ietf-routing", "ipv4");
+  Route simple;
+  simple.destination_prefix = *Ipv4Prefix::parse("192.0.2.0/24");
+  simple.route_preference = 5;
+  auto &hop = simple.next_hop.emplace();
+  hop.outgoing_interface = "eth0";
+  hop.address = *Ipv4Address::parse("192.0.2.1");
+  auto &meta = simple.metadata.emplace();
+  meta.source_protocol = stat;
+  meta.active = true;
+  meta.last_updated = "2026-01-01T00:00:00Z";
+  v4.routes.push_back(simple);
+  Route special;
+  special.destination_prefix = *Ipv4Prefix::parse("198.51.100.0/24");
+  special.next_hop.emplace().special_next_hop =
+      IetfRouting::SpecialNextHop::Blackhole;
+  special.metadata.emplace().source_protocol = stat;
+  v4.routes.push_back(special);
+  Route list;
+  list.destination_prefix = *Ipv4Prefix::parse("0.0.0.0/0");
+  // the state list has no index
+  list.next_hop.emplace().next_hop_list = {{"", "eth0"}, {"", "eth1"}};
+  list.metadata.emplace().source_protocol = stat;
+  v4.routes.push_back(list);
+  ribs.push_back(v4);
+
+  IetfRouting::Rib v6;
+  v6.name = "ipv6-main";
+  v6.address_family = YangIdentity("ietf-routing", "ipv6");
+  v6.description = "IPv6 unicast";
+  Route route6;
+  route6.destination_prefix = *Ipv6Prefix::parse("2001:db8::/32");
+  route6.route_preference = 1;
+  route6.next_hop.emplace().address = *Ipv6Address::parse("2001:db8::1");
+  route6.metadata.emplace().source_protocol = stat;
+  v6.routes.push_back(route6);
+  ribs.push_back(v6);
+  return model;
+}
+
+static void requireSameRibs(const IetfRouting &got, const IetfRouting &want) {
+  const auto &a = got.getRouting().ribs, &b = want.getRouting().ribs;
+  ATF_REQUIRE_EQ(a.size(), b.size());
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    ATF_REQUIRE_EQ(a[i].name, b[i].name);
+    ATF_REQUIRE(a[i].address_family == b[i].address_family);
+    ATF_REQUIRE(a[i].description == b[i].description);
+    ATF_REQUIRE_EQ(a[i].routes.size(), b[i].routes.size());
+    for (std::size_t j = 0; j < a[i].routes.size(); ++j) {
+      const auto &x = a[i].routes[j], &y = b[i].routes[j];
+      ATF_REQUIRE(x.destination_prefix == y.destination_prefix);
+      ATF_REQUIRE(x.route_preference == y.route_preference);
+      ATF_REQUIRE(x.next_hop == y.next_hop);
+      ATF_REQUIRE_EQ(x.metadata.has_value(), y.metadata.has_value());
+      if (x.metadata) {
+        ATF_REQUIRE(x.metadata->source_protocol ==
+                    y.metadata->source_protocol);
+        ATF_REQUIRE_EQ(x.metadata->active, y.metadata->active);
+        ATF_REQUIRE(x.metadata->last_updated == y.metadata->last_updated);
+      }
+    }
+  }
+}
+
+ATF_TEST_CASE(ietf_routing_export_routes);
+ATF_TEST_CASE_HEAD(ietf_routing_export_routes) {
+  set_md_var("descr", "RIB routes serialize and stream with all fields");
+}
+ATF_TEST_CASE_BODY(ietf_routing_export_routes) {
+  auto ctx = Yang::getDefaultContext();
+  const IetfRouting model = makeRoutes();
+
+  struct lyd_node *tree = model.serialize(*ctx);
+  requireSameRibs(*IetfRouting::deserialize(*ctx, tree), model);
+  lyd_free_all(tree);
+
+  // write() emits the same data, in either encoding
+  std::string xml, json;
+  {
+    auto out = YangOutput::toString(xml);
+    model.print(*ctx, out, YangFormat::Xml);
+  }
+  {
+    auto out = YangOutput::toString(json);
+    model.print(*ctx, out, YangFormat::Json);
+  }
+  tree = YangModel::parseXml(*ctx, xml, LYD_PARSE_ONLY);
+  requireSameRibs(*IetfRouting::deserialize(*ctx, tree), model);
+  lyd_free_all(tree);
+  tree = nullptr;
+  ATF_REQUIRE_EQ(lyd_parse_data_mem(ctx->raw(), json.c_str(), LYD_JSON,
+                                    LYD_PARSE_ONLY, 0, &tree),
+                 LY_SUCCESS);
+  requireSameRibs(*IetfRouting::deserialize(*ctx, tree), model);
+  lyd_free_all(tree);
+}
+
+ATF_TEST_CASE(ietf_routing_cbor_routes);
+ATF_TEST_CASE_HEAD(ietf_routing_cbor_routes) {
+  set_md_var("descr", "RIB routes round-trip through YANG-CBOR");
+}
+ATF_TEST_CASE_BODY(ietf_routing_cbor_routes) {
+  const IetfRouting model = makeRoutes();
+  // the special and list routes carry no route-preference
+  ATF_REQUIRE(!model.getRouting().ribs[0].routes[1].route_preference);
+
+  const SidMap sids = routingSids();
+  std::string cbor;
+  {
+    auto out = YangOutput::toString(cbor);
+    model.writeCbor(sids, out);
+  }
+  auto in = YangInput::fromString(cbor);
+  requireSameRibs(*IetfRouting::readCbor(sids, in), model);
+}
+
+ATF_TEST_CASE(route_store);
+ATF_TEST_CASE_HEAD(route_store) {
+  set_md_var("descr", "RouteStore packs routes and unpacks them unchanged");
+}
+ATF_TEST_CASE_BODY(route_store) {
+  using Route = IetfRouting::Route;
+  const YangIdentity stat("ietf-routing", "static");
+  std::vector<Route> routes(5);
+  routes[0].destination_prefix = *Ipv4Prefix::parse("192.0.2.0/24");
+  routes[0].route_preference = 5;
+  routes[0].next_hop.emplace().address = *Ipv4Address::parse("192.0.2.1");
+  routes[0].metadata.emplace().source_protocol = stat;
+  routes[1].destination_prefix = *Ipv6Prefix::parse("2001:db8::/32");
+  routes[1].next_hop.emplace().special_next_hop =
+      IetfRouting::SpecialNextHop::Unreachable;
+  auto &meta = routes[1].metadata.emplace();
+  meta.active = true;
+  meta.last_updated = "2026-01-01T00:00:00Z";
+  // same next hop as routes[0]
+  routes[2].destination_prefix = *Ipv4Prefix::parse("198.51.100.0/24");
+  routes[2].next_hop = routes[0].next_hop;
+  auto &list = routes[3].next_hop.emplace().next_hop_list;
+  list.push_back({"1", "eth0"});
+  list.push_back({"2", std::nullopt});
+  // routes[4] is empty
+
+  const RouteStore store(routes);
+  ATF_REQUIRE_EQ(store.size(), 5u);
+  ATF_REQUIRE_EQ(store.nextHopGroups(), 3u);
+  ATF_REQUIRE_EQ(store[0].next_hop, store[2].next_hop);
+  ATF_REQUIRE_EQ(store[4].present, 0);
+  ATF_REQUIRE(store[1].present & RouteStore::kActive);
+  ATF_REQUIRE(store.destinationPrefix(1) == routes[1].destination_prefix);
+
+  const auto back = store.routes();
+  ATF_REQUIRE_EQ(back.size(), routes.size());
+  for (std::size_t i = 0; i < routes.size(); ++i) {
+    const Route &a = back[i], &b = routes[i];
+    ATF_REQUIRE(a.destination_prefix == b.destination_prefix);
+    ATF_REQUIRE(a.route_preference == b.route_preference);
+    ATF_REQUIRE_EQ(a.next_hop.has_value(), b.next_hop.has_value());
+    if (a.next_hop) {
+      ATF_REQUIRE(a.next_hop->address == b.next_hop->address);
+      ATF_REQUIRE(a.next_hop->special_next_hop ==
+                  b.next_hop->special_next_hop);
+      ATF_REQUIRE_EQ(a.next_hop->next_hop_list.size(),
+                     b.next_hop->next_hop_list.size());
+    }
+    ATF_REQUIRE_EQ(a.metadata.has_value(), b.metadata.has_value());
+    if (a.metadata) {
+      ATF_REQUIRE(a.metadata->source_protocol == b.metadata->source_protocol);
+      ATF_REQUIRE_EQ(a.metadata->active, b.metadata->active);
+      ATF_REQUIRE(a.metadata->last_updated == b.metadata->last_updated);
+    }
+  }
+  ATF_REQUIRE(back[3].next_hop->next_hop_list[0].outgoing_interface ==
+              std::string("eth0"));
+  ATF_REQUIRE(!back[3].next_hop->next_hop_list[1].outgoing_interface);
+}
+
+ATF_TEST_CASE(next_hop_groups);
+ATF_TEST_CASE_HEAD(next_hop_groups) {
+  set_md_var("descr", "Next-hop groups are shared, counted and repointed");
+}
+ATF_TEST_CASE_BODY(next_hop_groups) {
+  using NextHop = IetfRouting::NextHop;
+  NextHop eth0, eth1;
+  eth0.outgoing_interface = "eth0";
+  eth1.outgoing_interface = "eth1";
+
+  NextHopGroupTable table;
+  const auto a = table.intern(eth0);
+  ATF_REQUIRE_EQ(table.intern(eth0), a);
+  ATF_REQUIRE_EQ(table.refs(a), 2u);
+  const auto b = table.intern(eth1);
+  ATF_REQUIRE(a != b);
+  ATF_REQUIRE_EQ(table.size(), 2u);
+  table.release(b);
+  ATF_REQUIRE_EQ(table.size(), 1u);
+  // the freed id comes back
+  ATF_REQUIRE_EQ(table.intern(eth1), b);
+  table.update(b, eth0);
+  ATF_REQUIRE(table[b] == eth0);
+  table.release(a);
+  table.release(a);
+  ATF_REQUIRE_EQ(table.intern(eth0), b);
+  ATF_REQUIRE_THROW(std::logic_error, table.release(a));
+
+  std::vector<IetfRouting::Route> routes(3);
+  for (auto &r : routes)
+    r.next_hop = eth0;
+  routes[2].next_hop = eth1;
+  auto groups = std::make_shared<NextHopGroupTable>();
+  RouteStore store(routes, groups);
+  const auto shared = store[0].next_hop;
+  ATF_REQUIRE_EQ(store[1].next_hop, shared);
+  ATF_REQUIRE_EQ(groups->refs(shared), 2u);
+  {
+    // a copy, or another store on the table, takes its own references
+    const RouteStore copy = store;
+    const std::span<const IetfRouting::Route> first(routes.data(), 1);
+    RouteStore other(first, groups);
+    ATF_REQUIRE_EQ(other[0].next_hop, shared);
+    ATF_REQUIRE_EQ(groups->refs(shared), 5u);
+  }
+  ATF_REQUIRE_EQ(groups->refs(shared), 2u);
+
+  // link down: one update moves both routes
+  NextHop backup;
+  backup.outgoing_interface = "eth2";
+  store.updateNextHop(shared, backup);
+  ATF_REQUIRE(store.route(0).next_hop == backup);
+  ATF_REQUIRE(store.route(1).next_hop == backup);
+  ATF_REQUIRE(store.route(2).next_hop == eth1);
+
+  // and a single route moves alone
+  store.setNextHop(1, eth1);
+  ATF_REQUIRE_EQ(store[1].next_hop, store[2].next_hop);
+  ATF_REQUIRE_EQ(groups->refs(shared), 1u);
+  store.setNextHop(0, std::nullopt);
+  ATF_REQUIRE(!store.route(0).next_hop);
+  ATF_REQUIRE_EQ(store.nextHopGroups(), 1u);
+}
+
+ATF_TEST_CASE(rib_transaction);
+ATF_TEST_CASE_HEAD(rib_transaction) {
+  set_md_var("descr", "RibUpdater applies transactions and reports deltas");
+}
+ATF_TEST_CASE_BODY(rib_transaction) {
+  using Route = IetfRouting::Route;
+  using Change = RibDelta::Change;
+  const YangIdentity stat("ietf-routing", "static");
+  const YangIdentity direct("ietf-routing", "direct");
+  const auto net = *Ipv4Prefix::parse("192.0.2.0/24");
+  const auto other = *Ipv4Prefix::parse("198.51.100.0/24");
+  const auto added = *Ipv4Prefix::parse("203.0.113.0/24");
+  auto route = [](Ipv4Prefix prefix, YangIdentity protocol,
+                  std::uint32_t preference, const char *ifname) {
+    Route r;
+    r.destination_prefix = prefix;
+    r.route_preference = preference;
+    r.next_hop.emplace().outgoing_interface = ifname;
+    r.metadata.emplace().source_protocol = protocol;
+    return r;
+  };
+
+  IetfRouting::Rib rib;
+  rib.routes = {route(net, stat, 10, "eth0"), route(net, direct, 0, "eth1"),
+                route(other, stat, 1, "eth0")};
+  RibUpdater updater(rib);
+  // best paths are selected up front
+  ATF_REQUIRE(!rib.routes[0].metadata->active);
+  ATF_REQUIRE(rib.routes[1].metadata->active);
+  ATF_REQUIRE(rib.routes[2].metadata->active);
+
+  RibTransaction txn;
+  txn.withdraw(net, direct);
+  txn.add(route(added, stat, 1, "eth2"));
+  txn.replace(route(other, stat, 1, "eth1"));
+  // worse than the static route: no change to report
+  txn.add(route(other, direct, 5, "eth3"));
+  RibDelta delta = updater.apply(txn);
+  ATF_REQUIRE_EQ(rib.routes.size(), 4u);
+  ATF_REQUIRE_EQ(delta.changes.size(), 3u);
+  ATF_REQUIRE(delta.changes[0].prefix == IetfRouting::DestinationPrefix(net));
+  ATF_REQUIRE(delta.changes[0].change == Change::Replaced);
+  const Route &now = rib.routes[delta.changes[0].route];
+  ATF_REQUIRE(now.metadata->source_protocol == stat);
+  ATF_REQUIRE(now.metadata->active);
+  ATF_REQUIRE(delta.changes[1].change == Change::Added);
+  ATF_REQUIRE(rib.routes[delta.changes[1].route].destination_prefix ==
+              IetfRouting::DestinationPrefix(added));
+  ATF_REQUIRE(delta.changes[2].change == Change::Replaced);
+  ATF_REQUIRE(rib.routes[delta.changes[2].route].next_hop->outgoing_interface ==
+              std::string("eth1"));
+
+  // all or nothing
+  txn.clear();
+  txn.withdraw(added, stat);
+  txn.add(route(net, stat, 1, "eth0"));
+  ATF_REQUIRE_THROW(std::invalid_argument, updater.apply(txn));
+  ATF_REQUIRE_EQ(rib.routes.size(), 4u);
+  txn.clear();
+  txn.replace(route(added, direct, 1, "eth0"));
+  ATF_REQUIRE_THROW(std::invalid_argument, updater.apply(txn));
+  ATF_REQUIRE_THROW(std::invalid_argument, txn.add(Route()));
+
+  // the same content is no change; the last route is withdrawn
+  txn.clear();
+  txn.replace(route(other, stat, 1, "eth1"));
+  txn.withdraw(added, stat);
+  txn.withdraw(other, stat);
+  txn.add(route(other, stat, 1, "eth1"));
+  delta = updater.apply(txn);
+  ATF_REQUIRE_EQ(delta.changes.size(), 1u);
+  ATF_REQUIRE(delta.changes[0].change == Change::Withdrawn);
+  ATF_REQUIRE_EQ(delta.changes[0].route, RibDelta::kNoRoute);
+  ATF_REQUIRE_EQ(rib.routes.size(), 3u);
+
+  // withdrawing the best path promotes the next one
+  txn.clear();
+  txn.withdraw(other, stat);
+  delta = updater.apply(txn);
+  ATF_REQUIRE_EQ(delta.changes.size(), 1u);
+  ATF_REQUIRE(delta.changes[0].change == Change::Replaced);
+  const Route &backup = rib.routes[delta.changes[0].route];
+  ATF_REQUIRE(backup.metadata->source_protocol == direct);
+  ATF_REQUIRE(backup.metadata->active);
+}
+
+ATF_INIT_TEST_CASES(tcs) {
+  ATF_ADD_TEST_CASE(tcs, ietf_routing_roundtrip);
+  ATF_ADD_TEST_CASE(tcs, ietf_routing_lyb);
+  ATF_ADD_TEST_CASE(tcs, ietf_routing_cbor);
+  ATF_ADD_TEST_CASE(tcs, ietf_routing_identities);
+  ATF_ADD_TEST_CASE(tcs, ietf_routing_export_routes);
+  ATF_ADD_TEST_CASE(tcs, ietf_routing_cbor_routes);
+  ATF_ADD_TEST_CASE(tcs, route_store);
+  ATF_ADD_TEST_CASE(tcs, next_hop_groups);
+  ATF_ADD_TEST_CASE(tcs, rib_transaction);
+}
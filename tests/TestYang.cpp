@@ -1,5 +1,11 @@
+#include "IetfRouting.hpp"
 #include "Yang.hpp"
+#include "YangModel.hpp"
 #include <atf-c++.hpp>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace yang;
 
@@ -10,11 +16,136 @@ ATF_TEST_CASE_HEAD(yang_context_singleton) {
 ATF_TEST_CASE_BODY(yang_context_singleton) {
   auto c1 = Yang::getContext({});
   ATF_REQUIRE(c1 != nullptr);
+  ATF_REQUIRE(Yang::getContext({}).get() == c1.get());
 
   std::shared_ptr<YangContext> c2 = Yang::getDefaultContext();
   ATF_REQUIRE(c2 != nullptr);
-  ATF_REQUIRE(c1.get() == c2.get());
+  ATF_REQUIRE(Yang::getDefaultContext().get() == c2.get());
   ATF_REQUIRE(c2->raw() != nullptr);
 }
 
-ATF_INIT_TEST_CASES(tcs) { ATF_ADD_TEST_CASE(tcs, yang_context_singleton); }
+ATF_TEST_CASE(yang_context_options_keyed);
+ATF_TEST_CASE_HEAD(yang_context_options_keyed) {
+  set_md_var("descr", "contexts with different options live side by side");
+}
+ATF_TEST_CASE_BODY(yang_context_options_keyed) {
+  auto plain = Yang::getContext({});
+  auto no_yanglib = Yang::getContext({YangContextOption::NoYanglibrary});
+  ATF_REQUIRE(plain.get() != no_yanglib.get());
+  ATF_REQUIRE(no_yanglib->options() &
+              toFlags(YangContextOption::NoYanglibrary));
+  ATF_REQUIRE(!(plain->options() & toFlags(YangContextOption::NoYanglibrary)));
+  ATF_REQUIRE(Yang::getContext({YangContextOption::NoYanglibrary}).get() ==
+              no_yanglib.get());
+}
+
+ATF_TEST_CASE(yang_default_context_own_key);
+ATF_TEST_CASE_HEAD(yang_default_context_own_key) {
+  set_md_var("descr", "getContext() with the default options and modules "
+                      "does not take the default context's slot");
+}
+ATF_TEST_CASE_BODY(yang_default_context_own_key) {
+  auto plain = Yang::getContext(
+      {YangContextOption::NoYanglibrary, YangContextOption::LybHashes},
+      kDefaultModules);
+  auto def = Yang::getDefaultContext();
+  ATF_REQUIRE(plain.get() != def.get());
+  ATF_REQUIRE(Yang::getDefaultContext().get() == def.get());
+}
+
+ATF_TEST_CASE(yang_default_context_threads);
+ATF_TEST_CASE_HEAD(yang_default_context_threads) {
+  set_md_var("descr", "concurrent first use builds one default context");
+}
+ATF_TEST_CASE_BODY(yang_default_context_threads) {
+  constexpr int kThreads = 8;
+  std::vector<YangContext *> seen(kThreads, nullptr);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreads; ++i)
+    threads.emplace_back(
+        [&seen, i] { seen[i] = Yang::getDefaultContext().get(); });
+  for (auto &t : threads)
+    t.join();
+  for (auto *ctx : seen) {
+    ATF_REQUIRE(ctx != nullptr);
+    ATF_REQUIRE(ctx == seen.front());
+  }
+}
+
+ATF_TEST_CASE(yang_context_for_model);
+ATF_TEST_CASE_HEAD(yang_context_for_model) {
+  set_md_var("descr", "getContextFor<Model>() loads modules on first use");
+}
+ATF_TEST_CASE_BODY(yang_context_for_model) {
+  auto lazy = Yang::getLazyContext();
+  ATF_REQUIRE(!lazy->GetLoadedModuleByName("ietf-interfaces"));
+
+  auto ifs = Yang::getContextFor<IetfInterfaces>();
+  ATF_REQUIRE(ifs->GetLoadedModuleByName("ietf-interfaces"));
+  ATF_REQUIRE(ifs->GetLoadedModuleByName("ietf-ip"));
+  ATF_REQUIRE(!ifs->GetLoadedModuleByName("ietf-routing"));
+  ATF_REQUIRE(Yang::getLazyContext().get() == ifs.get());
+
+  // routing gets a new context; the interfaces one is left as it was
+  auto rt = Yang::getContextFor<IetfRouting>();
+  ATF_REQUIRE(rt.get() != ifs.get());
+  ATF_REQUIRE(rt->GetLoadedModuleByName("ietf-routing"));
+  ATF_REQUIRE(rt->GetLoadedModuleByName("ietf-interfaces"));
+  ATF_REQUIRE(!ifs->GetLoadedModuleByName("ietf-routing"));
+  ATF_REQUIRE(!lazy->GetLoadedModuleByName("ietf-interfaces"));
+  ATF_REQUIRE(Yang::getLazyContext().get() == rt.get());
+  ATF_REQUIRE(Yang::getContextFor<IetfInterfaces>().get() == ifs.get());
+
+  // a module set already covered reuses the union
+  ATF_REQUIRE(Yang::getContextWith(IetfInterfaces::requiredModules()).get() ==
+              rt.get());
+}
+
+ATF_TEST_CASE(yang_context_for_model_keeps_trees);
+ATF_TEST_CASE_HEAD(yang_context_for_model_keeps_trees) {
+  set_md_var("descr", "trees built on getContextFor<IetfInterfaces>() stay "
+                      "valid after routing is first used");
+}
+ATF_TEST_CASE_BODY(yang_context_for_model_keeps_trees) {
+  auto ifs = Yang::getContextFor<IetfInterfaces>();
+  const std::string xml = R"(<?xml version="1.0"?>
+    <interfaces xmlns="urn:ietf:params:xml:ns:yang:ietf-interfaces"
+                xmlns:ianaift="urn:ietf:params:xml:ns:yang:iana-if-type"
+                xmlns:ip="urn:ietf:params:xml:ns:yang:ietf-ip">
+      <interface>
+        <name>eth0</name>
+        <type>ianaift:ethernetCsmacd</type>
+        <ip:ipv6>
+          <ip:address>
+            <ip:ip>2001:db8::1</ip:ip>
+            <ip:prefix-length>64</ip:prefix-length>
+          </ip:address>
+        </ip:ipv6>
+      </interface>
+    </interfaces>)";
+  struct lyd_node *tree = YangModel::parseXml(*ifs, xml);
+
+  // ietf-ipv6-unicast-routing augments /if:interfaces/if:interface/ip:ipv6;
+  // loading it must not touch the schema `tree` points into
+  auto rt = Yang::getContextFor<IetfRouting>();
+  ATF_REQUIRE(rt->GetLoadedModuleByName("ietf-ipv6-unicast-routing"));
+
+  ATF_REQUIRE_EQ(lyd_validate_all(&tree, nullptr, LYD_VALIDATE_PRESENT,
+                                  nullptr),
+                 LY_SUCCESS);
+  char *out = nullptr;
+  ATF_REQUIRE_EQ(lyd_print_mem(&out, tree, LYD_XML, LYD_PRINT_WITHSIBLINGS),
+                 LY_SUCCESS);
+  ATF_REQUIRE(std::string(out).find("2001:db8::1") != std::string::npos);
+  std::free(out);
+  lyd_free_all(tree);
+}
+
+ATF_INIT_TEST_CASES(tcs) {
+  ATF_ADD_TEST_CASE(tcs, yang_context_singleton);
+  ATF_ADD_TEST_CASE(tcs, yang_context_options_keyed);
+  ATF_ADD_TEST_CASE(tcs, yang_default_context_own_key);
+  ATF_ADD_TEST_CASE(tcs, yang_default_context_threads);
+  ATF_ADD_TEST_CASE(tcs, yang_context_for_model);
+  ATF_ADD_TEST_CASE(tcs, yang_context_for_model_keeps_trees);
+}
@@ -1,12 +1,24 @@
 #include "Exceptions.hpp"
+#include "FeatureProfile.hpp"
 #include "Yang.hpp"
+#include "YangContextPool.hpp"
+#include "YangContextSnapshot.hpp"
+#include "YangSharedContext.hpp"
 #include <algorithm>
 #include <atf-c++.hpp>
+#include <atomic>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <inttypes.h>
 #include <libyang/libyang.h>
 #include <libyang/log.h>
+#include <optional>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
 
 using namespace yang;
 #include <vector>
@@ -73,4 +85,375 @@ ATF_TEST_CASE_BODY(yang_context_raw) {
     ATF_FAIL("ietf-ip module not found in libyang context");
 }
 
-ATF_INIT_TEST_CASES(tcs) { ATF_ADD_TEST_CASE(tcs, yang_context_raw); }
+ATF_TEST_CASE(yang_context_batch_load);
+ATF_TEST_CASE_HEAD(yang_context_batch_load) {
+  set_md_var("descr", "YangContext::loadModules compiles a batch once");
+}
+ATF_TEST_CASE_BODY(yang_context_batch_load) {
+  YangContext ctx(toFlags(YangContextOption::NoYanglibrary));
+  for (const auto &p : kDefaultSearchPaths)
+    ctx.addSearchPath(p);
+
+  ModuleLoadStats stats;
+  try {
+    stats = ctx.loadModules(kDefaultModules);
+  } catch (YangDataError &e) {
+    ATF_FAIL(e.what());
+  }
+  ATF_REQUIRE(stats.modules == kDefaultModules.size());
+  ATF_REQUIRE(stats.total() == ctx.lastLoadStats().total());
+
+  // the temporary explicit-compile mode must not leak into the context
+  ATF_REQUIRE((ly_ctx_get_options(ctx.raw()) & LY_CTX_EXPLICIT_COMPILE) == 0);
+  for (const auto &m : kDefaultModules)
+    ATF_REQUIRE(ctx.GetLoadedModuleByName(std::get<0>(m)));
+}
+
+ATF_TEST_CASE(yang_context_batch_load_failure);
+ATF_TEST_CASE_HEAD(yang_context_batch_load_failure) {
+  set_md_var("descr", "A failed loadModules batch leaves the context "
+                      "compiled and can be retried");
+}
+ATF_TEST_CASE_BODY(yang_context_batch_load_failure) {
+  YangContext ctx(toFlags(YangContextOption::NoYanglibrary));
+  for (const auto &p : kDefaultSearchPaths)
+    ctx.addSearchPath(p);
+
+  const std::vector<ModuleSpec> batch = {
+      {"ietf-interfaces", "", nullptr},
+      {"no-such-module", "", nullptr},
+  };
+  ATF_REQUIRE_THROW(YangDataError, ctx.loadModules(batch));
+  ATF_REQUIRE((ly_ctx_get_options(ctx.raw()) & LY_CTX_EXPLICIT_COMPILE) == 0);
+
+  // the module before the failure stays, compiled
+  const struct lys_module *ifs =
+      ly_ctx_get_module_implemented(ctx.raw(), "ietf-interfaces");
+  ATF_REQUIRE(ifs != nullptr);
+  ATF_REQUIRE(ifs->compiled != nullptr);
+
+  // a retry without the bad module loads only what is missing
+  const std::vector<ModuleSpec> retry = {
+      {"ietf-interfaces", "", nullptr},
+      {"ietf-ip", "", nullptr},
+  };
+  ModuleLoadStats stats = ctx.ensureModules(retry);
+  ATF_REQUIRE_EQ(stats.modules, 1u);
+  const struct lys_module *ip =
+      ly_ctx_get_module_implemented(ctx.raw(), "ietf-ip");
+  ATF_REQUIRE(ip != nullptr);
+  ATF_REQUIRE(ip->compiled != nullptr);
+}
+
+ATF_TEST_CASE(module_index);
+ATF_TEST_CASE_HEAD(module_index) {
+  set_md_var("descr", "ModuleIndex lookup, persistence and staleness");
+}
+ATF_TEST_CASE_BODY(module_index) {
+  namespace fs = std::filesystem;
+  const fs::path dir = fs::path("module_index." + std::to_string(::getpid()));
+  fs::create_directories(dir / "sub");
+  std::ofstream(dir / "a@2020-01-01.yang") << "module a {}";
+  std::ofstream(dir / "sub" / "a@2021-06-01.yang") << "module a {}";
+  std::ofstream(dir / "b.yang") << "module b {}";
+  std::ofstream(dir / "README") << "not a module";
+
+  const std::vector<std::string> dirs = {dir.string()};
+  ModuleIndex idx = ModuleIndex::scan(dirs);
+  ATF_REQUIRE(idx.size() == 3);
+  ATF_REQUIRE(idx.find("a", "")->revision == "2021-06-01");
+  ATF_REQUIRE(idx.find("a", "2020-01-01")->revision == "2020-01-01");
+  ATF_REQUIRE(idx.find("a", "1999-01-01") == nullptr);
+  ATF_REQUIRE(idx.find("b", "2000-01-01")->revision.empty());
+  ATF_REQUIRE(idx.find("c", "") == nullptr);
+
+  const std::string file = dir.string() + ".idx";
+  ATF_REQUIRE(idx.save(file));
+  auto loaded = ModuleIndex::load(file, dirs);
+  ATF_REQUIRE(loaded.has_value());
+  ATF_REQUIRE(loaded->size() == 3);
+  ATF_REQUIRE(loaded->find("a", "")->path == idx.find("a", "")->path);
+
+  // adding a file changes the directory mtime and invalidates the index
+  std::ofstream(dir / "sub" / "c@2022-01-01.yang") << "module c {}";
+  fs::last_write_time(dir / "sub", fs::last_write_time(dir / "sub") +
+                                       std::chrono::seconds(1));
+  ATF_REQUIRE(!ModuleIndex::load(file, dirs).has_value());
+  ATF_REQUIRE(ModuleIndex::loadOrScan(file, dirs).find("c", "") != nullptr);
+
+  fs::remove_all(dir);
+  fs::remove(file);
+}
+
+ATF_TEST_CASE(module_index_import);
+ATF_TEST_CASE_HEAD(module_index_import) {
+  set_md_var("descr", "Modules load through ModuleIndex without searchdirs");
+}
+ATF_TEST_CASE_BODY(module_index_import) {
+  YangContext ctx(toFlags(YangContextOption::NoYanglibrary) |
+                  toFlags(YangContextOption::DisableSearchdirs));
+  auto idx = std::make_shared<const ModuleIndex>(
+      ModuleIndex::scan(kDefaultSearchPaths));
+  if (idx->size() == 0)
+    ATF_SKIP("no YANG modules installed in the default search paths");
+  ctx.setModuleIndex(idx);
+  try {
+    ctx.loadModuleInContext("ietf-ip", "2018-02-22", nullptr);
+  } catch (YangDataError &e) {
+    ATF_FAIL(e.what());
+  }
+  ATF_REQUIRE(ctx.GetLoadedModuleByName("ietf-interfaces"));
+}
+
+ATF_TEST_CASE(yang_context_snapshot);
+ATF_TEST_CASE_HEAD(yang_context_snapshot) {
+  set_md_var("descr", "YangContextSnapshot save/load and invalidation");
+}
+ATF_TEST_CASE_BODY(yang_context_snapshot) {
+  const std::vector<ModuleSpec> modules = {
+      {"ietf-interfaces", "2018-02-20", nullptr},
+      {"ietf-ip", "2018-02-22", nullptr}};
+  const std::vector<std::string> paths = {
+      "/usr/local/share/yang/modules/yang/standard/ietf/RFC/"};
+  const unsigned flags = toFlags(YangContextOption::NoYanglibrary);
+
+  YangContext ctx(flags);
+  for (const auto &p : paths)
+    ctx.addSearchPath(p);
+  for (const auto &m : modules)
+    ctx.loadModuleInContext(std::get<0>(m), std::get<1>(m), std::get<2>(m));
+
+  const std::string file =
+      "yang_context_snapshot." + std::to_string(::getpid()) + ".bin";
+  const auto fp = YangContextSnapshot::fingerprint(flags, modules, paths);
+  YangContextSnapshot snapshot(file, fp);
+  if (!snapshot.save(ctx))
+    ATF_SKIP("libyang cannot print this context");
+
+  auto loaded = snapshot.load();
+  ATF_REQUIRE(loaded != nullptr);
+  ATF_REQUIRE(loaded->isPrinted());
+  ATF_REQUIRE((loaded->options() & flags) == flags);
+  ATF_REQUIRE(loaded->GetLoadedModuleByName("ietf-ip"));
+
+  // A different module list must not reuse the snapshot.
+  std::vector<ModuleSpec> other = modules;
+  other.pop_back();
+  YangContextSnapshot stale(
+      file, YangContextSnapshot::fingerprint(flags, other, paths));
+  ATF_REQUIRE(stale.load() == nullptr);
+
+  loaded.reset();
+  ::unlink(file.c_str());
+}
+
+ATF_TEST_CASE(yang_context_snapshot_module_index);
+ATF_TEST_CASE_HEAD(yang_context_snapshot_module_index) {
+  set_md_var("descr", "A snapshot of a context built through a ModuleIndex "
+                      "is invalidated by a changed module file");
+}
+ATF_TEST_CASE_BODY(yang_context_snapshot_module_index) {
+  namespace fs = std::filesystem;
+  const fs::path dir =
+      fs::path("snapshot_index." + std::to_string(::getpid()));
+  fs::create_directories(dir);
+  std::ofstream(dir / "snap-a@2024-01-01.yang")
+      << "module snap-a { yang-version 1.1; namespace \"urn:snap-a\";"
+         " prefix a; include snap-a-types; revision 2024-01-01;"
+         " leaf x { type a:name; } }";
+  std::ofstream(dir / "snap-a-types.yang")
+      << "submodule snap-a-types { yang-version 1.1;"
+         " belongs-to snap-a { prefix a; } typedef name { type string; } }";
+
+  const unsigned flags = toFlags(YangContextOption::NoYanglibrary) |
+                         toFlags(YangContextOption::DisableSearchdirs);
+  YangContext ctx(flags);
+  ctx.setModuleIndex(std::make_shared<const ModuleIndex>(
+      ModuleIndex::scan({dir.string()})));
+  ctx.loadModuleInContext("snap-a", "");
+
+  const std::string file =
+      "snapshot_index." + std::to_string(::getpid()) + ".bin";
+  YangContextSnapshot snapshot(file, 1);
+  if (!snapshot.save(ctx))
+    ATF_SKIP("libyang cannot print this context");
+  ATF_REQUIRE(snapshot.load() != nullptr);
+
+  auto touch = [](const fs::path &p) {
+    fs::last_write_time(p, fs::last_write_time(p) + std::chrono::seconds(1));
+  };
+  touch(dir / "snap-a@2024-01-01.yang");
+  ATF_REQUIRE(snapshot.load() == nullptr);
+
+  // submodules count too
+  ATF_REQUIRE(snapshot.save(ctx));
+  ATF_REQUIRE(snapshot.load() != nullptr);
+  touch(dir / "snap-a-types.yang");
+  ATF_REQUIRE(snapshot.load() == nullptr);
+
+  ::unlink(file.c_str());
+  fs::remove_all(dir);
+}
+
+ATF_TEST_CASE(yang_context_module_lookup);
+ATF_TEST_CASE_HEAD(yang_context_module_lookup) {
+  set_md_var("descr", "module lookup by name, revision and namespace");
+}
+ATF_TEST_CASE_BODY(yang_context_module_lookup) {
+  YangContext ctx(toFlags(YangContextOption::NoYanglibrary));
+  ctx.addSearchPath("/usr/local/share/yang/modules/yang/standard/ietf/RFC/");
+  const std::vector<ModuleSpec> ifs = {
+      {"ietf-interfaces", "2018-02-20", nullptr}};
+  ctx.loadModules(ifs);
+
+  auto m = ctx.GetLoadedModuleByName("ietf-interfaces");
+  ATF_REQUIRE(m);
+  ATF_REQUIRE_EQ(std::string(m.revision()), "2018-02-20");
+  ATF_REQUIRE(ctx.GetLoadedModule("ietf-interfaces", "2018-02-20").raw() ==
+              m.raw());
+  ATF_REQUIRE(!ctx.GetLoadedModule("ietf-interfaces", "2014-05-08"));
+  ATF_REQUIRE(ctx.GetLoadedModuleByNamespace(
+                     "urn:ietf:params:xml:ns:yang:ietf-interfaces")
+                  .raw() == m.raw());
+  ATF_REQUIRE(!ctx.GetLoadedModuleByName("ietf-ip"));
+
+  // the tables follow changes to the module set
+  const std::vector<ModuleSpec> ip = {{"ietf-ip", "2018-02-22", nullptr}};
+  ctx.loadModules(ip);
+  ATF_REQUIRE(ctx.GetLoadedModuleByName("ietf-ip"));
+  ATF_REQUIRE(
+      ctx.GetLoadedModuleByNamespace("urn:ietf:params:xml:ns:yang:ietf-ip"));
+}
+
+ATF_TEST_CASE(feature_profile);
+ATF_TEST_CASE_HEAD(feature_profile) {
+  set_md_var("descr", "FeatureProfile prunes the compiled schema");
+}
+ATF_TEST_CASE_BODY(feature_profile) {
+  const std::vector<ModuleSpec> modules = {
+      {"ietf-interfaces", "2018-02-20", nullptr},
+      {"ietf-routing", "2018-03-13", nullptr}};
+  const FeatureProfile full = {
+      {"ietf-routing", {"multiple-ribs", "router-id"}}};
+  const FeatureProfile pruned = {{"ietf-routing", {}}};
+
+  const auto applied = pruned.apply(modules);
+  ATF_REQUIRE(std::get<2>(applied[0]) == nullptr);
+  ATF_REQUIRE(std::get<2>(applied[1]) != nullptr);
+  ATF_REQUIRE(std::get<2>(applied[1])[0] == nullptr);
+  const FeatureProfile copy = full;
+  ATF_REQUIRE_EQ(std::string(copy.features("ietf-routing")[1]), "router-id");
+  ATF_REQUIRE(copy.features("ietf-routing") != full.features("ietf-routing"));
+
+  auto build = [&modules](const FeatureProfile &profile) {
+    YangContext ctx(toFlags(YangContextOption::NoYanglibrary));
+    ctx.addSearchPath(
+        "/usr/local/share/yang/modules/yang/standard/ietf/RFC/");
+    ctx.loadModules(profile.apply(modules));
+    return SchemaReport::of(ctx);
+  };
+  const SchemaReport big = build(full);
+  const SchemaReport small = build(pruned);
+  ATF_REQUIRE(small.total_nodes > 0);
+  ATF_REQUIRE(small.total_nodes < big.total_nodes);
+  if (big.compiled_bytes && small.compiled_bytes)
+    ATF_REQUIRE(small.compiled_bytes < big.compiled_bytes);
+}
+
+ATF_TEST_CASE(yang_context_pool);
+ATF_TEST_CASE_HEAD(yang_context_pool) {
+  set_md_var("descr", "YangContextPool leases independent schema copies");
+}
+ATF_TEST_CASE_BODY(yang_context_pool) {
+  auto master = std::make_shared<YangContext>(
+      toFlags(YangContextOption::NoYanglibrary));
+  master->addSearchPath(
+      "/usr/local/share/yang/modules/yang/standard/ietf/RFC/");
+  const std::vector<ModuleSpec> modules = {
+      {"ietf-interfaces", "2018-02-20", nullptr}};
+  master->loadModules(modules);
+  if (!YangContextPool::clone(*master))
+    ATF_SKIP("libyang cannot print this context");
+
+  YangContextPool pool(master, 2);
+  ATF_REQUIRE_EQ(pool.capacity(), 2u);
+  {
+    auto a = pool.acquire();
+    auto b = pool.acquire();
+    ATF_REQUIRE(a && b);
+    ATF_REQUIRE(a.get() != b.get());
+    ATF_REQUIRE(a.get() != master.get());
+    ATF_REQUIRE(b->GetLoadedModuleByName("ietf-interfaces"));
+    ATF_REQUIRE(!pool.tryAcquire());
+  }
+  ATF_REQUIRE_EQ(pool.size(), 2u);
+
+  // Leases returned to the pool are reused, not rebuilt.
+  std::atomic<int> found{0};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+    threads.emplace_back([&pool, &found] {
+      for (int j = 0; j < 16; ++j)
+        pool.withContext([&found](YangContext &ctx) {
+          if (ctx.GetLoadedModuleByName("ietf-interfaces"))
+            ++found;
+        });
+    });
+  for (auto &t : threads)
+    t.join();
+  ATF_REQUIRE_EQ(found.load(), 8 * 16);
+  ATF_REQUIRE_EQ(pool.size(), 2u);
+}
+
+ATF_TEST_CASE(yang_shared_context);
+ATF_TEST_CASE_HEAD(yang_shared_context) {
+  set_md_var("descr", "YangSharedContext publish/attach across fork()");
+}
+ATF_TEST_CASE_BODY(yang_shared_context) {
+  YangContext ctx(toFlags(YangContextOption::NoYanglibrary));
+  ctx.addSearchPath("/usr/local/share/yang/modules/yang/standard/ietf/RFC/");
+  const std::vector<ModuleSpec> modules = {
+      {"ietf-interfaces", "2018-02-20", nullptr},
+      {"ietf-ip", "2018-02-22", nullptr}};
+  ctx.loadModules(modules);
+
+  std::optional<YangSharedContext> shared;
+  try {
+    shared.emplace(YangSharedContext::publish(ctx));
+  } catch (const YangDataError &) {
+    ATF_SKIP("libyang cannot print this context");
+  }
+  ATF_REQUIRE(shared->fd() >= 0);
+  ATF_REQUIRE(shared->imageSize() > 0);
+
+  pid_t pid = ::fork();
+  ATF_REQUIRE(pid >= 0);
+  if (pid == 0) {
+    auto attached = YangSharedContext::attach(shared->fd());
+    const bool ok = attached && attached->raw() && attached->isPrinted() &&
+                    (attached->options() & ctx.options()) == ctx.options() &&
+                    attached->GetLoadedModuleByName("ietf-ip");
+    std::_Exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  ATF_REQUIRE(::waitpid(pid, &status, 0) == pid);
+  ATF_REQUIRE(WIFEXITED(status));
+  ATF_REQUIRE_EQ(WEXITSTATUS(status), 0);
+
+  // Not a published segment.
+  ATF_REQUIRE(YangSharedContext::attach(-1) == nullptr);
+}
+
+ATF_INIT_TEST_CASES(tcs) {
+  ATF_ADD_TEST_CASE(tcs, yang_context_raw);
+  ATF_ADD_TEST_CASE(tcs, yang_context_batch_load);
+  ATF_ADD_TEST_CASE(tcs, yang_context_batch_load_failure);
+  ATF_ADD_TEST_CASE(tcs, module_index);
+  ATF_ADD_TEST_CASE(tcs, module_index_import);
+  ATF_ADD_TEST_CASE(tcs, yang_context_snapshot);
+  ATF_ADD_TEST_CASE(tcs, yang_context_snapshot_module_index);
+  ATF_ADD_TEST_CASE(tcs, yang_context_module_lookup);
+  ATF_ADD_TEST_CASE(tcs, feature_profile);
+  ATF_ADD_TEST_CASE(tcs, yang_context_pool);
+  ATF_ADD_TEST_CASE(tcs, yang_shared_context);
+}